@@ -0,0 +1,199 @@
+#!/usr/bin/env python3
+
+"""Binary log decoder
+
+Formats the log frames sent by firmware built with -DBINARY_LOGGING=1 (see src/BinaryLog.h) back into the usual
+text log lines.  Anything on the stream that isn't a log frame (boot messages, text fallback lines) is passed through.
+
+To read a device directly (needs pyserial):
+$ bin/binary_log_decoder.py /dev/ttyUSB0
+To decode a capture, or stdin:
+$ bin/binary_log_decoder.py capture.bin
+$ cat capture.bin | bin/binary_log_decoder.py -
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+START1 = 0x94
+START2 = 0xC5
+HEADER_LEN = 4
+
+LEVELS = {
+    "D": ("DEBUG", "\u001b[34m"),
+    "I": ("INFO ", "\u001b[32m"),
+    "W": ("WARN ", "\u001b[33m"),
+    "E": ("ERROR", "\u001b[31m"),
+    "C": ("CRIT ", ""),
+    "T": ("TRACE", "\u001b[35m"),
+}
+
+# One printf conversion: flags, width, precision, length, conversion
+CONVERSION = re.compile(r"%([-+ #0]*)(\*|\d*)(?:\.(\*|\d*))?(hh|h|ll|l|j|z|t|L)?([diouxXcpfFeEgGaAs%])")
+
+
+class Reader:
+    """Argument bytes of one record, in the order the firmware wrote them"""
+
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def varint(self):
+        value = shift = 0
+        while True:
+            b = self.data[self.pos]
+            self.pos += 1
+            value |= (b & 0x7F) << shift
+            shift += 7
+            if not b & 0x80:
+                return value
+
+    def signed(self):
+        v = self.varint()
+        return (v >> 1) ^ -(v & 1)
+
+    def double(self):
+        (v,) = struct.unpack_from("<d", self.data, self.pos)
+        self.pos += 8
+        return v
+
+    def string(self):
+        n = self.varint()
+        s = self.data[self.pos : self.pos + n].decode("utf-8", "replace")
+        self.pos += n
+        return s
+
+
+def format_message(fmt, args):
+    """printf, on the host, with the arguments as the firmware encoded them"""
+    reader = Reader(args)
+
+    def convert(m):
+        flags, width, precision, _length, conv = m.groups()
+        if conv == "%":
+            return "%"
+        if width == "*":
+            width = str(reader.signed())
+        if precision == "*":
+            precision = str(reader.signed())
+        spec = "%" + flags + width + ("." + precision if precision is not None else "")
+        if conv in "di":
+            return (spec + "d") % reader.signed()
+        if conv in "ouxX":
+            return (spec + conv) % reader.varint()
+        if conv == "c":
+            return (spec + "c") % chr(reader.varint())
+        if conv == "p":
+            return (spec + "s") % hex(reader.varint())
+        if conv in "aA":
+            return (spec + "s") % reader.double().hex()
+        if conv in "fFeEgG":
+            return (spec + conv) % reader.double()
+        return (spec + "s") % reader.string()
+
+    try:
+        return CONVERSION.sub(convert, fmt)
+    except (IndexError, struct.error, ValueError) as e:
+        return f"{fmt!r} <bad arguments: {e}>"
+
+
+class Decoder:
+    def __init__(self, out, color):
+        self.out = out
+        self.color = color
+        self.strings = {}  # Format strings and thread names, by id
+        self.buf = bytearray()
+
+    def feed(self, data):
+        self.buf += data
+        while True:
+            start = self.buf.find(bytes([START1, START2]))
+            if start < 0:
+                # Keep a trailing START1, it may be the start of a frame
+                keep = 1 if self.buf.endswith(bytes([START1])) else 0
+                self.passthrough(self.buf[: len(self.buf) - keep])
+                del self.buf[: len(self.buf) - keep]
+                return
+            self.passthrough(self.buf[:start])
+            del self.buf[:start]
+            if len(self.buf) < HEADER_LEN:
+                return
+            length = (self.buf[2] << 8) | self.buf[3]
+            if len(self.buf) < HEADER_LEN + length:
+                return
+            self.frame(bytes(self.buf[HEADER_LEN : HEADER_LEN + length]))
+            del self.buf[: HEADER_LEN + length]
+
+    def passthrough(self, data):
+        if data:
+            self.out.write(data.decode("utf-8", "replace"))
+
+    def frame(self, payload):
+        kind = payload[:1]
+        if kind == b"F" and len(payload) >= 5:
+            (fid,) = struct.unpack_from("<I", payload, 1)
+            self.strings[fid] = payload[5:].decode("utf-8", "replace")
+        elif kind == b"R" and len(payload) >= 18:
+            level = chr(payload[1])
+            fid, tid, msec, rtc = struct.unpack_from("<IIII", payload, 2)
+            self.record(level, fid, tid, msec, rtc, payload[18:])
+
+    def record(self, level, fid, tid, msec, rtc, args):
+        name, color = LEVELS.get(level, (level, ""))
+        if not self.color:
+            color = ""
+        if rtc:
+            hms = rtc % 86400
+            clock = f"{hms // 3600:02d}:{hms % 3600 // 60:02d}:{hms % 60:02d}"
+        else:
+            clock = "??:??:??"
+        line = f"{color}{name} {chr(27) + '[0m' if color else ''}| {clock} {msec // 1000} "
+        if tid:
+            line += f"[{self.strings.get(tid, '?')}] "
+        fmt = self.strings.get(fid)
+        if fmt is None:
+            line += f"<format {fid:#010x} not seen yet>\n"
+        else:
+            line += format_message(fmt, args)
+            if not line.endswith("\n"):
+                line += "\n"
+        self.out.write(line)
+        self.out.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Format binary log frames from a Meshtastic device")
+    parser.add_argument("source", help="serial port, capture file, or - for stdin")
+    parser.add_argument("-b", "--baud", type=int, default=115200, help="serial baud rate (default 115200)")
+    parser.add_argument("--no-color", action="store_true", help="don't color the log levels")
+    args = parser.parse_args()
+
+    decoder = Decoder(sys.stdout, not args.no_color)
+    if args.source == "-":
+        stream = sys.stdin.buffer
+    elif args.source.startswith("/dev/") or args.source.upper().startswith("COM"):
+        import serial  # pyserial, only needed for live devices
+
+        stream = serial.Serial(args.source, args.baud, timeout=0.1)
+    else:
+        stream = open(args.source, "rb")
+
+    try:
+        while True:
+            data = stream.read(4096)
+            if data is None:
+                continue
+            if not data:
+                if args.source.startswith("/dev/") or args.source.upper().startswith("COM"):
+                    continue  # Serial timeout, keep listening
+                break
+            decoder.feed(data)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,282 @@
+#include "BinaryLog.h"
+
+#include <stddef.h>
+#include <string.h>
+#include <sys/types.h>
+
+namespace BinaryLog
+{
+
+namespace
+{
+// Bounds checked output, sticks at failed once anything doesn't fit
+struct Writer {
+    uint8_t *out;
+    size_t size;
+    size_t pos = 0;
+    bool failed = false;
+
+    Writer(uint8_t *out, size_t size) : out(out), size(size) {}
+
+    void put(const void *data, size_t len)
+    {
+        if (failed || len > size - pos) {
+            failed = true;
+            return;
+        }
+        memcpy(out + pos, data, len);
+        pos += len;
+    }
+
+    void putByte(uint8_t b) { put(&b, 1); }
+
+    void putU32(uint32_t v)
+    {
+        uint8_t b[4] = {(uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24)};
+        put(b, sizeof(b));
+    }
+
+    void putVarint(uint64_t v)
+    {
+        do {
+            uint8_t b = v & 0x7F;
+            v >>= 7;
+            putByte(v ? (b | 0x80) : b);
+        } while (v);
+    }
+
+    void putSigned(int64_t v) { putVarint(((uint64_t)v << 1) ^ (uint64_t)(v >> 63)); } // zigzag
+
+    void putDouble(double d)
+    {
+        uint64_t bits;
+        memcpy(&bits, &d, sizeof(bits));
+        putU32((uint32_t)bits);
+        putU32((uint32_t)(bits >> 32));
+    }
+
+    // Truncated to whatever room is left, rather than failing the whole line.  Like printf, reads no more than precision
+    // chars when there is one (%.*s is used for buffers that aren't 0 terminated)
+    void putString(const char *s, int precision)
+    {
+        if (!s)
+            s = "(null)";
+        size_t len = precision >= 0 ? strnlen(s, precision) : strlen(s);
+        size_t left = size - pos;
+        size_t room = (left > 128) ? left - 2 : (left ? left - 1 : 0); // Leave room for the varint length
+        if (len > room)
+            len = room;
+        putVarint(len);
+        put(s, len);
+    }
+};
+
+enum Length { LEN_NONE, LEN_HH, LEN_H, LEN_L, LEN_LL, LEN_J, LEN_Z, LEN_T, LEN_BIG_L };
+} // namespace
+
+uint32_t formatId(const char *text)
+{
+    // FNV-1a
+    uint32_t h = 2166136261u;
+    for (const uint8_t *p = (const uint8_t *)text; *p; p++) {
+        h ^= *p;
+        h *= 16777619u;
+    }
+    return h ? h : 1; // 0 means "none"
+}
+
+size_t encodeDefinition(uint8_t *out, size_t outSize, uint32_t id, const char *text)
+{
+    if (outSize < 5)
+        return 0;
+    Writer w(out, outSize);
+    w.putByte('F');
+    w.putU32(id);
+    size_t len = strlen(text);
+    w.put(text, len < outSize - w.pos ? len : outSize - w.pos);
+    return w.pos;
+}
+
+size_t encodeRecord(uint8_t *out, size_t outSize, char level, uint32_t id, uint32_t threadId, uint32_t msec, uint32_t rtc,
+                    const char *format, va_list args)
+{
+    Writer w(out, outSize);
+    w.putByte('R');
+    w.putByte(level);
+    w.putU32(id);
+    w.putU32(threadId);
+    w.putU32(msec);
+    w.putU32(rtc);
+
+    // Walk the conversions the same way vsnprintf would, taking each argument as the type it was passed as
+    for (const char *p = format; *p && !w.failed; p++) {
+        if (*p != '%')
+            continue;
+        p++;
+        if (*p == '%')
+            continue;
+
+        while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0')
+            p++;
+        if (*p == '*') {
+            w.putSigned(va_arg(args, int));
+            p++;
+        } else {
+            while (*p >= '0' && *p <= '9')
+                p++;
+        }
+        int precision = -1; // none, a negative * precision means the same
+        if (*p == '.') {
+            p++;
+            if (*p == '*') {
+                precision = va_arg(args, int);
+                w.putSigned(precision);
+                p++;
+            } else {
+                precision = 0;
+                while (*p >= '0' && *p <= '9')
+                    precision = precision * 10 + (*p++ - '0');
+            }
+        }
+
+        Length length = LEN_NONE;
+        switch (*p) {
+        case 'h':
+            length = (p[1] == 'h') ? LEN_HH : LEN_H;
+            p += (length == LEN_HH) ? 2 : 1;
+            break;
+        case 'l':
+            length = (p[1] == 'l') ? LEN_LL : LEN_L;
+            p += (length == LEN_LL) ? 2 : 1;
+            break;
+        case 'j':
+            length = LEN_J;
+            p++;
+            break;
+        case 'z':
+            length = LEN_Z;
+            p++;
+            break;
+        case 't':
+            length = LEN_T;
+            p++;
+            break;
+        case 'L':
+            length = LEN_BIG_L;
+            p++;
+            break;
+        }
+
+        switch (*p) {
+        case 'd':
+        case 'i': {
+            int64_t v;
+            switch (length) {
+            case LEN_HH:
+                v = (signed char)va_arg(args, int);
+                break;
+            case LEN_H:
+                v = (short)va_arg(args, int);
+                break;
+            case LEN_L:
+                v = va_arg(args, long);
+                break;
+            case LEN_LL:
+                v = va_arg(args, long long);
+                break;
+            case LEN_J:
+                v = va_arg(args, intmax_t);
+                break;
+            case LEN_Z:
+                v = va_arg(args, ssize_t);
+                break;
+            case LEN_T:
+                v = va_arg(args, ptrdiff_t);
+                break;
+            default:
+                v = va_arg(args, int);
+                break;
+            }
+            w.putSigned(v);
+            break;
+        }
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o': {
+            uint64_t v;
+            switch (length) {
+            case LEN_HH:
+                v = (unsigned char)va_arg(args, unsigned int);
+                break;
+            case LEN_H:
+                v = (unsigned short)va_arg(args, unsigned int);
+                break;
+            case LEN_L:
+                v = va_arg(args, unsigned long);
+                break;
+            case LEN_LL:
+                v = va_arg(args, unsigned long long);
+                break;
+            case LEN_J:
+                v = va_arg(args, uintmax_t);
+                break;
+            case LEN_Z:
+                v = va_arg(args, size_t);
+                break;
+            case LEN_T:
+                v = (uint64_t)va_arg(args, ptrdiff_t);
+                break;
+            default:
+                v = va_arg(args, unsigned int);
+                break;
+            }
+            w.putVarint(v);
+            break;
+        }
+        case 'c':
+            if (length != LEN_NONE)
+                return 0; // Wide characters
+            w.putVarint((unsigned char)va_arg(args, int));
+            break;
+        case 'p':
+            w.putVarint((uintptr_t)va_arg(args, void *));
+            break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            w.putDouble(length == LEN_BIG_L ? (double)va_arg(args, long double) : va_arg(args, double));
+            break;
+        case 's':
+            if (length != LEN_NONE)
+                return 0; // Wide strings
+            w.putString(va_arg(args, const char *), precision);
+            break;
+        default:
+            return 0; // %n, or something we don't know the argument type of
+        }
+    }
+
+    return w.failed ? 0 : w.pos;
+}
+
+bool Dictionary::add(uint32_t id)
+{
+    uint32_t &slot = ids[id % SIZE];
+    if (slot == id)
+        return false;
+    slot = id;
+    return true;
+}
+
+void Dictionary::clear()
+{
+    memset(ids, 0, sizeof(ids));
+}
+
+} // namespace BinaryLog
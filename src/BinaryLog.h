@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Binary ("deferred") logging: instead of running vsnprintf on the device, log lines are sent as the id of their format
+ * string plus the raw arguments, and bin/binary_log_decoder.py does the formatting on the host.
+ *
+ * Enable with -DBINARY_LOGGING=1.  Only the serial console is affected.  The protobuf API, syslog and BLE log paths stay
+ * text, because their clients expect text.
+ *
+ * Frames use the StreamAPI framing with a different second start byte, so API clients skip them:
+ *
+ *   0x94 0xc5 <len hi> <len lo> <payload>
+ *
+ *   'F' <id u32> <text>                                        format string or thread name, sent before its first use
+ *   'R' <level> <id u32> <thread id u32> <msec u32> <rtc u32> <args>   one log line, thread id 0 if none, rtc 0 if unknown
+ *
+ * Integers are little endian.  Args follow the conversions of the format string, in order: integers (and '*' widths) as
+ * LEB128 varints, zigzagged if signed; doubles as 8 bytes; strings as a varint length and the bytes.
+ */
+
+#ifndef BINARY_LOGGING
+#define BINARY_LOGGING 0
+#endif
+
+#ifndef BINARY_LOG_BUFFER_SIZE
+#define BINARY_LOG_BUFFER_SIZE 1024 // Encoded lines waiting for SerialConsole to send them
+#endif
+
+#ifndef BINARY_LOG_REANNOUNCE_MS
+#define BINARY_LOG_REANNOUNCE_MS (60 * 1000) // Resend format strings this often, for a decoder attached late
+#endif
+
+#define BINARY_LOG_START1 0x94
+#define BINARY_LOG_START2 0xc5
+#define BINARY_LOG_HEADER_LEN 4
+#define BINARY_LOG_MAX_PAYLOAD 200
+
+namespace BinaryLog
+{
+
+/// Id of a format string (or thread name), from its text, so copies of the same string share an id
+uint32_t formatId(const char *text);
+
+/// @return payload length of a definition frame for text, truncated to fit, or 0 if outSize is too small
+size_t encodeDefinition(uint8_t *out, size_t outSize, uint32_t id, const char *text);
+
+/// @return payload length of a record frame, or 0 if it doesn't fit or the format uses a conversion we can't encode
+size_t encodeRecord(uint8_t *out, size_t outSize, char level, uint32_t id, uint32_t threadId, uint32_t msec, uint32_t rtc,
+                    const char *format, va_list args);
+
+/**
+ * Ids whose text the host has (probably) been sent already.  Direct mapped, so an id evicted by a collision just gets sent
+ * again.
+ */
+class Dictionary
+{
+  public:
+    /// @return true if id is new, and its definition should be sent first
+    bool add(uint32_t id);
+    void clear();
+
+  private:
+    static constexpr size_t SIZE = 128;
+    uint32_t ids[SIZE] = {};
+};
+
+} // namespace BinaryLog
@@ -30,6 +30,11 @@ SOFTWARE.*/
 #include "platform/portduino/PortduinoGlue.h"
 #endif
 
+#ifdef ARDUINO_ARCH_RP2040
+#include "concurrency/OSThread.h"
+#include <algorithm>
+#endif
+
 /// A C wrapper for LOG_DEBUG that can be used from arduino C libs that don't know about C++ or meshtastic
 extern "C" void logLegacy(const char *level, const char *fmt, ...)
 {
@@ -198,48 +203,65 @@ inline bool Syslog::_sendLog(uint16_t pri, const char *appName, const char *mess
 #endif
 
 #ifdef ARDUINO_ARCH_RP2040
-#define SERIAL_LOG_BUFFER_LEN 160 //matches RedirectablePrint::vprintf - printBuf[160];
+#define SERIAL_LOG_BUFFER_LEN 160 // matches RedirectablePrint::vprintf - printBuf[160];
 
-void printAvailableLogging() {
+// Formatted on the caller's stack, so that an interrupt logging in the middle of another line can't garble either
+void logToBuffer(char level, const char *format, ...)
+{
+    char line[SERIAL_LOG_BUFFER_LEN];
+    int len = 0;
+
+    auto thread = concurrency::OSThread::currentThread;
+    if (thread)
+        len = snprintf(line, sizeof(line), "[%s] ", thread->ThreadName.c_str());
+    if (len < 0 || len >= (int)sizeof(line))
+        len = 0;
+
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(line + len, sizeof(line) - len, format, args);
+    va_end(args);
+    if (n > 0)
+        len = std::min(len + n, (int)sizeof(line) - 1); // Truncated, like RedirectablePrint
+
+    serialLogBuffer.write(level, line, len);
+}
+
+void printAvailableLogging()
+{
     static char line[SERIAL_LOG_BUFFER_LEN];
-    // check for any logging that may have happened during servicing an interrupt
-    if (serialLogBuffer.full()) {
-        auto len = serialLogBuffer.consume_line(line, SERIAL_LOG_BUFFER_LEN-1);
-        DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_DEBUG, "Buffer Maxed - Ignoring %d bytes tail of partial line", len);
+    static uint32_t reportedDropped = 0;
+
+    // Lines logged (likely from an interrupt) while the buffer was full
+    uint32_t dropped = serialLogBuffer.getDroppedLines();
+    if (dropped != reportedDropped) {
+        DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_WARN, "Log buffer full, dropped %u lines (%u bytes total so far)",
+                       dropped - reportedDropped, serialLogBuffer.getDroppedBytes());
+        reportedDropped = dropped;
     }
 
-    while (!serialLogBuffer.empty()) {
-        auto len = serialLogBuffer.consume_line(line, SERIAL_LOG_BUFFER_LEN-1);
-        if (line[len-1]=='\n') {
-            line[len-1] = '\0';
-        } else {
-            line[len] = '\0';
-        }
-        switch (line[0]) {
-            case 'D':
-                DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_DEBUG, &line[1]);
-                break;
-            case 'I':
-                DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_INFO, &line[1]);
-                break;
-            case 'W':
-                DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_WARN, &line[1]);
-                break;
-            case 'E':
-                DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_ERROR, &line[1]);
-                break;
-            case 'C':
-                DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_CRIT, &line[1]);
-                break;
-            case 'T':
-                DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_TRACE, &line[1]);
-                break;
-            default:
-                //Previous line didn't fit within buffer or we didn't populate with type
-                DEBUG_PORT.log("CTD", line);
-                break;
+    char level;
+    while (serialLogBuffer.read(&level, line, sizeof(line))) {
+        switch (level) {
+        case 'D':
+            DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_DEBUG, "%s", line);
+            break;
+        case 'I':
+            DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_INFO, "%s", line);
+            break;
+        case 'W':
+            DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_WARN, "%s", line);
+            break;
+        case 'E':
+            DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_ERROR, "%s", line);
+            break;
+        case 'C':
+            DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_CRIT, "%s", line);
+            break;
+        default:
+            DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_TRACE, "%s", line);
+            break;
         }
     }
-    serialLogBuffer.clear_if_empty(); //try to keep logging within only one block
 }
 #endif
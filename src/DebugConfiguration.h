@@ -24,7 +24,7 @@
 #define MESHTASTIC_LOG_LEVEL_CRIT "CRIT "
 #define MESHTASTIC_LOG_LEVEL_TRACE "TRACE"
 
-#include "CircularBuffer.h"
+#include "LogRing.h"
 #include "SerialConsole.h"
 
 // If defined we will include support for ARM ICE "semihosting" for a virtual
@@ -48,59 +48,18 @@
 #else
 #if defined(DEBUG_PORT) && !defined(DEBUG_MUTE)
 #ifdef ARDUINO_ARCH_RP2040
-extern CircularBuffer<char> serialLogBuffer;
-
-inline void addThreadName() {
-    auto thread = concurrency::OSThread::currentThread;
-    if (thread) {
-        serialLogBuffer.write('[');
-        serialLogBuffer.writeF(thread->ThreadName.c_str());
-        serialLogBuffer.writeF("] ");
-    }
-}
-
-#define LOG_DEBUG(...) \
-    { \
-    serialLogBuffer.write('D'); \
-    addThreadName(); \
-    serialLogBuffer.writeF(__VA_ARGS__); \
-	serialLogBuffer.write('\n'); \
-	}
-#define LOG_INFO(...) \
-    { \
-    serialLogBuffer.write('I'); \
-    addThreadName(); \
-    serialLogBuffer.writeF(__VA_ARGS__); \
-    serialLogBuffer.write('\n'); \
-    }
-#define LOG_WARN(...) \
-    { \
-    serialLogBuffer.write('W'); \
-    addThreadName(); \
-    serialLogBuffer.writeF(__VA_ARGS__); \
-    serialLogBuffer.write('\n'); \
-    }
-#define LOG_ERROR(...) \
-    { \
-    serialLogBuffer.write('E'); \
-    addThreadName(); \
-    serialLogBuffer.writeF(__VA_ARGS__); \
-    serialLogBuffer.write('\n'); \
-    }
-#define LOG_CRIT(...) \
-    { \
-    serialLogBuffer.write('C'); \
-    addThreadName(); \
-    serialLogBuffer.writeF(__VA_ARGS__); \
-    serialLogBuffer.write('\n'); \
-    }
-#define LOG_TRACE(...) \
-    { \
-    serialLogBuffer.write('T'); \
-    addThreadName(); \
-    serialLogBuffer.writeF(__VA_ARGS__); \
-    serialLogBuffer.write('\n'); \
-    }
+extern LogRing serialLogBuffer;
+
+// Format one line (with the current thread's name) into serialLogBuffer, printed later by printAvailableLogging()
+// Safe from interrupts and from either core
+void logToBuffer(char level, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+#define LOG_DEBUG(...) logToBuffer('D', __VA_ARGS__)
+#define LOG_INFO(...) logToBuffer('I', __VA_ARGS__)
+#define LOG_WARN(...) logToBuffer('W', __VA_ARGS__)
+#define LOG_ERROR(...) logToBuffer('E', __VA_ARGS__)
+#define LOG_CRIT(...) logToBuffer('C', __VA_ARGS__)
+#define LOG_TRACE(...) logToBuffer('T', __VA_ARGS__)
 #else
 #define LOG_DEBUG(...) DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_DEBUG, __VA_ARGS__)
 #define LOG_INFO(...) DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_INFO, __VA_ARGS__)
@@ -1,6 +1,7 @@
 #include "RedirectablePrint.h"
 #include "NodeDB.h"
 #include "RTC.h"
+#include "Throttle.h"
 #include "concurrency/OSThread.h"
 #include "configuration.h"
 #include "main.h"
@@ -96,6 +97,10 @@ size_t RedirectablePrint::vprintf(const char *logLevel, const char *format, va_l
 
 void RedirectablePrint::log_to_serial(const char *logLevel, const char *format, va_list arg)
 {
+#if BINARY_LOGGING
+    log_to_binary(logLevel, format, arg);
+    return;
+#endif
     size_t r = 0;
 
 #ifdef ARCH_PORTDUINO
@@ -173,6 +178,98 @@ void RedirectablePrint::log_to_serial(const char *logLevel, const char *format,
     r += vprintf(logLevel, format, arg);
 }
 
+#if BINARY_LOGGING
+// Queue the line as its format string id plus raw arguments, for bin/binary_log_decoder.py to format on the host
+// Falls back to text (in order with the queued frames) if the line can't be encoded
+void RedirectablePrint::log_to_binary(const char *logLevel, const char *format, va_list arg)
+{
+    uint8_t payload[BINARY_LOG_MAX_PAYLOAD];
+
+    // A decoder may have attached since the format strings were sent
+    if (!Throttle::isWithinTimespanMs(binaryLogAnnouncedMs, BINARY_LOG_REANNOUNCE_MS)) {
+        binaryLogAnnounced.clear();
+        binaryLogAnnouncedMs = millis();
+    }
+
+    uint32_t threadId = 0;
+    auto thread = concurrency::OSThread::currentThread;
+    if (thread) {
+        threadId = BinaryLog::formatId(thread->ThreadName.c_str());
+        if (binaryLogAnnounced.add(threadId))
+            queueBinaryLog(payload, BinaryLog::encodeDefinition(payload, sizeof(payload), threadId, thread->ThreadName.c_str()));
+    }
+
+    uint32_t id = BinaryLog::formatId(format);
+    va_list copy;
+    va_copy(copy, arg); // The other sinks still need arg
+    size_t len = BinaryLog::encodeRecord(payload, sizeof(payload), logLevel[0], id, threadId, millis(),
+                                         getValidTime(RTCQuality::RTCQualityDevice, true), format, copy);
+    va_end(copy);
+
+    if (!len) {
+        sendBinaryLog();
+        if (thread) {
+            print("[");
+            print(thread->ThreadName);
+            print("] ");
+        }
+        vprintf(nullptr, format, arg);
+        return;
+    }
+
+    if (binaryLogAnnounced.add(id)) {
+        uint8_t definition[BINARY_LOG_MAX_PAYLOAD];
+        queueBinaryLog(definition, BinaryLog::encodeDefinition(definition, sizeof(definition), id, format));
+    }
+    queueBinaryLog(payload, len);
+}
+
+void RedirectablePrint::queueBinaryLog(const uint8_t *payload, size_t len)
+{
+    if (!len)
+        return;
+    // Full: send what is queued now, rather than dropping lines
+    if (!binaryLog.write('B', (const char *)payload, len)) {
+        sendBinaryLog();
+        binaryLog.write('B', (const char *)payload, len);
+    }
+}
+
+void RedirectablePrint::flushBinaryLog()
+{
+#ifdef HAS_FREE_RTOS
+    if (inDebugPrint != nullptr && xSemaphoreTake(inDebugPrint, portMAX_DELAY) == pdTRUE) {
+        sendBinaryLog();
+        xSemaphoreGive(inDebugPrint);
+    }
+#else
+    if (!inDebugPrint) {
+        inDebugPrint = true;
+        sendBinaryLog();
+        inDebugPrint = false;
+    }
+#endif
+}
+
+void RedirectablePrint::sendBinaryLog()
+{
+    // Straight to dest: our own write() may be overridden to translate newlines, which would corrupt the frames
+    bool serialEnabled = config.has_security ? config.security.serial_enabled : config.device.serial_enabled;
+    uint8_t frame[BINARY_LOG_HEADER_LEN + BINARY_LOG_MAX_PAYLOAD + 1];
+    char type;
+    uint16_t len;
+    while (binaryLog.read(&type, (char *)frame + BINARY_LOG_HEADER_LEN, sizeof(frame) - BINARY_LOG_HEADER_LEN, &len)) {
+        if (config.has_lora && !serialEnabled)
+            continue;
+        frame[0] = BINARY_LOG_START1;
+        frame[1] = BINARY_LOG_START2;
+        frame[2] = len >> 8;
+        frame[3] = len & 0xff;
+        dest->write(frame, BINARY_LOG_HEADER_LEN + len);
+    }
+}
+#endif
+
 void RedirectablePrint::log_to_syslog(const char *logLevel, const char *format, va_list arg)
 {
 #if HAS_NETWORKING && !defined(ARCH_PORTDUINO)
@@ -1,11 +1,16 @@
 #pragma once
 
 #include "../freertosinc.h"
+#include "BinaryLog.h"
 #include "mesh/generated/meshtastic/mesh.pb.h"
 #include <Print.h>
 #include <stdarg.h>
 #include <string>
 
+#if BINARY_LOGGING
+#include "mesh/LogRing.h"
+#endif
+
 /**
  * A Printable that can be switched to squirt its bytes to a different sink.
  * This class is mostly useful to allow debug printing to be redirected away from Serial
@@ -48,6 +53,11 @@ class RedirectablePrint : public Print
 
     std::string mt_sprintf(const std::string fmt_str, ...);
 
+#if BINARY_LOGGING
+    /// Send the binary log frames queued so far.  Called regularly by SerialConsole.
+    void flushBinaryLog();
+#endif
+
   protected:
     /// Subclasses can override if they need to change how we format over the serial port
     virtual void log_to_serial(const char *logLevel, const char *format, va_list arg);
@@ -56,4 +66,14 @@ class RedirectablePrint : public Print
   private:
     void log_to_syslog(const char *logLevel, const char *format, va_list arg);
     void log_to_ble(const char *logLevel, const char *format, va_list arg);
+
+#if BINARY_LOGGING
+    void log_to_binary(const char *logLevel, const char *format, va_list arg);
+    void queueBinaryLog(const uint8_t *payload, size_t len);
+    void sendBinaryLog(); // flushBinaryLog(), for callers already holding inDebugPrint
+
+    LogRing binaryLog{BINARY_LOG_BUFFER_SIZE}; // Encoded frame payloads, waiting for flushBinaryLog()
+    BinaryLog::Dictionary binaryLogAnnounced;  // Ids whose text has already been sent
+    uint32_t binaryLogAnnouncedMs = 0;         // When binaryLogAnnounced was last cleared
+#endif
 };
\ No newline at end of file
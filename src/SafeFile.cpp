@@ -1,4 +1,5 @@
 #include "SafeFile.h"
+#include <string.h>
 
 #ifdef FSCom
 
@@ -46,7 +47,18 @@ size_t SafeFile::write(const uint8_t *buffer, size_t size)
     if (!f)
         return 0;
 
-    for (size_t i = 0; i < size; i++) {
+    // xor doesn't care about order: fold the buffer a word at a time, then the bytes of that word
+    size_t i = 0;
+    uint32_t wide = 0;
+    for (; i + sizeof(wide) <= size; i += sizeof(wide)) {
+        uint32_t word;
+        memcpy(&word, buffer + i, sizeof(word));
+        wide ^= word;
+    }
+    wide ^= wide >> 16;
+    wide ^= wide >> 8;
+    hash ^= (uint8_t)wide;
+    for (; i < size; i++) {
         hash ^= buffer[i];
     }
     return f.write((uint8_t const *)buffer, size); // This nasty cast is _IMPORTANT_ otherwise the correct adafruit method does
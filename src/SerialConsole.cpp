@@ -71,6 +71,9 @@ int32_t SerialConsole::runOnce()
     {
         return 250;
     }
+#endif
+#if BINARY_LOGGING
+    flushBinaryLog();
 #endif
     return runOncePart();
 }
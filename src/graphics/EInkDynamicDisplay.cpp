@@ -3,6 +3,7 @@
 
 #if defined(USE_EINK) && defined(USE_EINK_DYNAMICDISPLAY)
 #include "EInkDynamicDisplay.h"
+#include "FrameDiff.h"
 
 // Constructor
 EInkDynamicDisplay::EInkDynamicDisplay(uint8_t address, int sda, int scl, OLEDDISPLAY_GEOMETRY geometry, HW_I2C i2cBus)
@@ -378,12 +379,7 @@ void EInkDynamicDisplay::resetRateLimiting()
 // Generate a hash of this frame, to compare against previous update
 void EInkDynamicDisplay::hashImage()
 {
-    imageHash = 0;
-
-    // Sum all bytes of the image buffer together
-    for (uint16_t b = 0; b < (displayWidth / 8) * displayHeight; b++) {
-        imageHash ^= buffer[b] << b;
-    }
+    imageHash = hashFrame(buffer, displayBufferSize);
 }
 
 // Store the results of determineMode() for future use, and reset for next call
@@ -410,27 +406,11 @@ void EInkDynamicDisplay::countGhostPixels()
     if (refresh != UNSPECIFIED)
         return;
 
-    // Start a new count
-    ghostPixelCount = 0;
-
-    // Check new image, bit by bit, for any white pixels at locations marked "dirty"
-    for (uint16_t i = 0; i < displayBufferSize; i++) {
-        for (uint8_t bit = 0; bit < 7; bit++) {
-
-            const bool dirty = (dirtyPixels[i] >> bit) & 1;       // Has pixel location been drawn to since full-refresh?
-            const bool shouldBeBlank = !((buffer[i] >> bit) & 1); // Is pixel location white in the new image?
-
-            // If pixel is (or has been) black since last full-refresh, and now is white: ghosting
-            if (dirty && shouldBeBlank)
-                ghostPixelCount++;
-
-            // Update the dirty status for this pixel - will this location become a ghost if set white in future?
-            if (!dirty && !shouldBeBlank)
-                dirtyPixels[i] |= (1 << bit);
-        }
-    }
+    // Check new image for any white pixels at locations marked "dirty" (black at some point since full-refresh),
+    // and mark the new image's black pixels as dirty: they become ghosts if set white in future
+    ghostPixelCount = trackGhostPixels(buffer, dirtyPixels, displayBufferSize);
 
-    LOG_DEBUG("ghostPixels=%hu, ", ghostPixelCount);
+    LOG_DEBUG("ghostPixels=%u, ", ghostPixelCount);
 }
 
 // Check if ghost pixel count exceeds the defined limit
@@ -0,0 +1,115 @@
+#include "FrameDiff.h"
+#include <cstring>
+
+static inline uint32_t load32(const uint8_t *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v)); // the buffers are byte arrays, don't assume alignment
+    return v;
+}
+
+static inline void store32(uint8_t *p, uint32_t v)
+{
+    memcpy(p, &v, sizeof(v));
+}
+
+static inline uint32_t rotl32(uint32_t v, uint8_t r)
+{
+    return (v << r) | (v >> (32 - r));
+}
+
+static inline uint32_t diff32(const uint8_t *page, const uint8_t *back, uint16_t x)
+{
+    return load32(page + x) ^ (back ? load32(back + x) : 0);
+}
+
+static inline uint8_t diff8(const uint8_t *page, const uint8_t *back, uint16_t x)
+{
+    return page[x] ^ (back ? back[x] : 0);
+}
+
+bool findPageChanges(const uint8_t *page, const uint8_t *back, uint16_t width, uint16_t *firstCol, uint16_t *lastCol,
+                     uint8_t *rowMask)
+{
+    // Forward to the first difference
+    uint16_t x = 0;
+    while (x + 4 <= width && !diff32(page, back, x))
+        x += 4;
+    while (x < width && !diff8(page, back, x))
+        x++;
+    if (x == width)
+        return false;
+
+    // Back to the last one, stops at x at the latest
+    uint16_t end = width;
+    while (end >= x + 4 && !diff32(page, back, end - 4))
+        end -= 4;
+    while (!diff8(page, back, end - 1))
+        end--;
+
+    // Which rows changed in between
+    uint32_t changed = 0;
+    uint16_t i = x;
+    for (; i + 4 <= end; i += 4)
+        changed |= diff32(page, back, i);
+    for (; i < end; i++)
+        changed |= diff8(page, back, i);
+
+    *firstCol = x;
+    *lastCol = end - 1;
+    *rowMask = changed | (changed >> 8) | (changed >> 16) | (changed >> 24);
+    return true;
+}
+
+uint32_t hashFrame(const uint8_t *buffer, uint32_t size)
+{
+    const uint32_t c1 = 0xcc9e2d51, c2 = 0x1b873593;
+    uint32_t h = 0;
+
+    uint32_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        uint32_t k = load32(buffer + i);
+        k *= c1;
+        k = rotl32(k, 15);
+        k *= c2;
+        h ^= k;
+        h = rotl32(h, 13);
+        h = h * 5 + 0xe6546b64;
+    }
+
+    // Up to 3 leftover bytes, little endian
+    uint32_t k = 0;
+    for (uint32_t j = size - i; j > 0; j--)
+        k = (k << 8) | buffer[i + j - 1];
+    if (size - i) {
+        k *= c1;
+        k = rotl32(k, 15);
+        k *= c2;
+        h ^= k;
+    }
+
+    // Finalize, so that similar frames don't end up with similar hashes
+    h ^= size;
+    h ^= h >> 16;
+    h *= 0x85ebca6b;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35;
+    h ^= h >> 16;
+    return h;
+}
+
+uint32_t trackGhostPixels(const uint8_t *buffer, uint8_t *dirty, uint32_t size)
+{
+    uint32_t ghosts = 0;
+    uint32_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        uint32_t b = load32(buffer + i), d = load32(dirty + i);
+        ghosts += __builtin_popcount(d & ~b);
+        store32(dirty + i, d | b);
+    }
+    for (; i < size; i++) {
+        ghosts += __builtin_popcount(dirty[i] & ~buffer[i] & 0xFF);
+        dirty[i] |= buffer[i];
+    }
+    return ghosts;
+}
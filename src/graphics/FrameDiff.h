@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Find what changed in one page of an OLEDDisplay style frame buffer: a row of width bytes, each byte one column of 8 pixels
+ * with the top pixel in the LSB.  The page is compared a 32 bit word at a time, so unchanged stretches cost a quarter of a
+ * byte by byte scan.
+ *
+ * @param page the current page
+ * @param back what is on screen for that page, or NULL if the screen is blank there
+ * @param width number of columns
+ * @param firstCol set to the first changed column
+ * @param lastCol set to the last changed column
+ * @param rowMask set to the rows (bit 0 is the top row) that changed anywhere between firstCol and lastCol
+ * @return false if nothing in the page changed
+ */
+bool findPageChanges(const uint8_t *page, const uint8_t *back, uint16_t width, uint16_t *firstCol, uint16_t *lastCol,
+                     uint8_t *rowMask);
+
+/**
+ * Hash a whole frame buffer, to tell whether a frame differs from the one already on screen.  MurmurHash3 (x86, 32 bit), a
+ * 32 bit word at a time, so every byte affects the result wherever it sits in the buffer.
+ */
+uint32_t hashFrame(const uint8_t *buffer, uint32_t size);
+
+/**
+ * Count the pixels an E-Ink fast refresh would leave as ghosts: set (black) at some point since the last full refresh, clear
+ * (white) in the new frame.  The new frame's set pixels are then added to dirty.  Works a 32 bit word at a time with popcount.
+ *
+ * @param buffer the new frame
+ * @param dirty pixels that have been set since the last full refresh, updated in place
+ * @param size bytes in both buffers
+ * @return number of ghost pixels
+ */
+uint32_t trackGhostPixels(const uint8_t *buffer, uint8_t *dirty, uint32_t size);
@@ -1085,6 +1085,7 @@ static LGFX *tft = nullptr;
 #if defined(ST7701_CS) || defined(ST7735_CS) || defined(ST7789_CS) || defined(ST7796_CS) || defined(ILI9341_DRIVER) ||           \
     defined(ILI9342_DRIVER) || defined(RAK14014) || defined(HX8357_CS) || defined(ILI9488_CS) || defined(ST72xx_DE) ||           \
     (ARCH_PORTDUINO && HAS_SCREEN != 0)
+#include "FrameDiff.h"
 #include "SPILock.h"
 #include "TFTDisplay.h"
 #include <SPI.h>
@@ -1136,93 +1137,49 @@ void TFTDisplay::display(bool fromBlank)
 
     concurrency::LockGuard g(spiLock);
 
-    uint32_t x, y;
-    uint32_t y_byteIndex;
-    uint8_t y_byteMask;
-    uint32_t x_FirstPixelUpdate;
-    uint32_t x_LastPixelUpdate;
-    bool isset, dblbuf_isset;
     uint16_t colorTftMesh, colorTftBlack;
-    bool somethingChanged = false;
 
     // Store colors byte-reversed so that TFT_eSPI doesn't have to swap bytes in a separate step
     colorTftMesh = (TFT_MESH >> 8) | ((TFT_MESH & 0xFF) << 8);
     colorTftBlack = (TFT_BLACK >> 8) | ((TFT_BLACK & 0xFF) << 8);
 
-    y = 0;
-    while (y < displayHeight) {
-        y_byteIndex = (y / 8) * displayWidth;
-        y_byteMask = (1 << (y & 7));
-
-        // Step 1: Do a quick scan of 8 rows together. This allows fast-forwarding over unchanged screen areas.
-        if (y_byteMask == 1) {
-            if (!fromBlank) {
-                for (x = 0; x < displayWidth; x++) {
-                    if (buffer[x + y_byteIndex] != buffer_back[x + y_byteIndex])
-                        break;
-                }
-            } else {
-                for (x = 0; x < displayWidth; x++) {
-                    if (buffer[x + y_byteIndex] != 0)
-                        break;
-                }
-            }
-            if (x >= displayWidth) {
-                // No changed pixels found in these 8 rows, fast-forward to the next 8
-                y = y + 8;
-                continue;
-            }
+    // The buffer is organized in pages of 8 rows, one byte per column
+    for (uint32_t pageY = 0; pageY < displayHeight; pageY += 8) {
+        uint8_t *page = &buffer[(pageY / 8) * displayWidth];
+        uint8_t *back = &buffer_back[(pageY / 8) * displayWidth];
+        uint16_t x_FirstPixelUpdate, x_LastPixelUpdate;
+        uint8_t rowMask;
+
+        // Step 1: Find the columns and rows of this page that need updating, a word at a time. Unchanged pages are skipped.
+        if (!findPageChanges(page, fromBlank ? NULL : back, displayWidth, &x_FirstPixelUpdate, &x_LastPixelUpdate, &rowMask))
+            continue;
+
+        uint32_t firstRow = __builtin_ctz(rowMask);
+        uint32_t lastRow = 31 - __builtin_clz(rowMask);
+        if (pageY + lastRow >= displayHeight)
+            lastRow = displayHeight - pageY - 1;
+        if (firstRow > lastRow)
+            continue;
+        uint32_t w = x_LastPixelUpdate - x_FirstPixelUpdate + 1;
+
+        // Step 2: Expand the changed rectangle to 16 bit colors, row after row
+        uint16_t *out = blockPixelBuffer;
+        for (uint32_t row = firstRow; row <= lastRow; row++) {
+            uint8_t y_byteMask = 1 << row;
+            for (uint32_t x = x_FirstPixelUpdate; x <= x_LastPixelUpdate; x++)
+                *out++ = (page[x] & y_byteMask) ? colorTftMesh : colorTftBlack;
         }
 
-        // Step 2: Scan each of the 8 rows individually. Find the first pixel in each row that needs updating
-        for (x_FirstPixelUpdate = 0; x_FirstPixelUpdate < displayWidth; x_FirstPixelUpdate++) {
-            isset = buffer[x_FirstPixelUpdate + y_byteIndex] & y_byteMask;
-
-            if (!fromBlank) {
-                // get src pixel in the page based ordering the OLED lib uses
-                dblbuf_isset = buffer_back[x_FirstPixelUpdate + y_byteIndex] & y_byteMask;
-                if (isset != dblbuf_isset) {
-                    break;
-                }
-            } else if (isset) {
-                break;
-            }
-        }
+        // Step 3: Send the whole rectangle to the screen as a single block transfer.
+        // This function accepts pixel data MSB first so it can dump the memory straight out the SPI port.
+        tft->pushRect(x_FirstPixelUpdate, pageY + firstRow, w, lastRow - firstRow + 1, blockPixelBuffer);
 
-        // Did we find a pixel that needs updating on this row?
-        if (x_FirstPixelUpdate < displayWidth) {
-
-            // Quickly write out the first changed pixel (saves another array lookup)
-            linePixelBuffer[x_FirstPixelUpdate] = isset ? colorTftMesh : colorTftBlack;
-            x_LastPixelUpdate = x_FirstPixelUpdate;
-
-            // Step 3: copy all remaining pixels in this row into the pixel line buffer,
-            // while also recording the last pixel in the row that needs updating
-            for (x = x_FirstPixelUpdate + 1; x < displayWidth; x++) {
-                isset = buffer[x + y_byteIndex] & y_byteMask;
-                linePixelBuffer[x] = isset ? colorTftMesh : colorTftBlack;
-
-                if (!fromBlank) {
-                    dblbuf_isset = buffer_back[x + y_byteIndex] & y_byteMask;
-                    if (isset != dblbuf_isset) {
-                        x_LastPixelUpdate = x;
-                    }
-                } else if (isset) {
-                    x_LastPixelUpdate = x;
-                }
-            }
-
-            // Step 4: Send the changed pixels on this line to the screen as a single block transfer.
-            // This function accepts pixel data MSB first so it can dump the memory straight out the SPI port.
-            tft->pushRect(x_FirstPixelUpdate, y, (x_LastPixelUpdate - x_FirstPixelUpdate + 1), 1,
-                          &linePixelBuffer[x_FirstPixelUpdate]);
-
-            somethingChanged = true;
-        }
-        y++;
+        // Step 4: Remember what is on the screen now
+        memcpy(&back[x_FirstPixelUpdate], &page[x_FirstPixelUpdate], w);
     }
-    // Copy the Buffer to the Back Buffer
-    if (somethingChanged)
+
+    // After a blank the screen no longer shows what the back buffer says, not even in pages we did not draw
+    if (fromBlank)
         memcpy(buffer_back, buffer, displayBufferSize);
 }
 
@@ -1422,11 +1379,11 @@ bool TFTDisplay::connect()
 #endif
     tft->fillScreen(TFT_BLACK);
 
-    if (this->linePixelBuffer == NULL) {
-        this->linePixelBuffer = (uint16_t *)malloc(sizeof(uint16_t) * displayWidth);
+    if (this->blockPixelBuffer == NULL) {
+        this->blockPixelBuffer = (uint16_t *)malloc(sizeof(uint16_t) * displayWidth * 8);
 
-        if (!this->linePixelBuffer) {
-            LOG_ERROR("Not enough memory to create TFT line buffer\n");
+        if (!this->blockPixelBuffer) {
+            LOG_ERROR("Not enough memory to create TFT block buffer\n");
             return false;
         }
     }
@@ -7,7 +7,6 @@
  * An adapter class that allows using the LovyanGFX library as if it was an OLEDDisplay implementation.
  *
  * Remaining TODO:
- * optimize display() to only draw changed pixels (see other OLED subclasses for examples)
  * Use the fast NRF52 SPI API rather than the slow standard arduino version
  *
  * turn radio back on - currently with both on spi bus is fucked? or are we leaving chip select asserted?
@@ -59,5 +58,6 @@ class TFTDisplay : public OLEDDisplay
     // Connect to the display
     virtual bool connect() override;
 
-    uint16_t *linePixelBuffer = nullptr;
+    // 16 bit colors of the rectangle display() is sending, up to 8 rows of displayWidth
+    uint16_t *blockPixelBuffer = nullptr;
 };
\ No newline at end of file
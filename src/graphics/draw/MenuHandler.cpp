@@ -1137,6 +1137,7 @@ void menuHandler::keyVerificationFinalPrompt()
             if (selected == 1) {
                 auto remoteNodePtr = nodeDB->getMeshNode(keyVerificationModule->getCurrentRemoteNode());
                 remoteNodePtr->bitfield |= NODEINFO_BITFIELD_IS_KEY_MANUALLY_VERIFIED_MASK;
+                nodeDB->nodeChanged(remoteNodePtr);
             }
         };
         screen->showOverlayBanner(options);
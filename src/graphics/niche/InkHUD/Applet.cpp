@@ -30,11 +30,105 @@ InkHUD::Applet::Applet() : GFX(0, 0)
 // Hand off to the applet's tile, which will in-turn pass to the renderer
 void InkHUD::Applet::drawPixel(int16_t x, int16_t y, uint16_t color)
 {
+    flushRun(); // Keep order, in case the pixel overlaps a pending run
+
     // Only render pixels if they fall within user's cropped region
     if (x >= cropLeft && x < (cropLeft + cropWidth) && y >= cropTop && y < (cropTop + cropHeight))
         assignedTile->handleAppletPixel(x, y, (Color)color);
 }
 
+// Pixels drawn by AdafruitGFX inside a startWrite() / endWrite() pair
+// Text glyphs arrive left-to-right, one row at a time, so neighbouring pixels are collected into a run,
+// which is passed on whole when the next pixel doesn't continue it
+void InkHUD::Applet::writePixel(int16_t x, int16_t y, uint16_t color)
+{
+    // Crop now, so a run never includes pixels outside the cropped region
+    if (!(x >= cropLeft && x < (cropLeft + cropWidth) && y >= cropTop && y < (cropTop + cropHeight)))
+        return;
+
+    // Extend the current run
+    if (runW && y == runY && x == runX + runW && (Color)color == runColor) {
+        runW++;
+        return;
+    }
+
+    // Start a new run
+    flushRun();
+    runX = x;
+    runY = y;
+    runW = 1;
+    runColor = (Color)color;
+}
+
+// Pass the pending run of pixels (if any) to our tile
+void InkHUD::Applet::flushRun()
+{
+    if (runW == 1)
+        assignedTile->handleAppletPixel(runX, runY, runColor);
+    else if (runW > 1)
+        assignedTile->handleAppletRect(runX, runY, runW, 1, runColor);
+    runW = 0;
+}
+
+// End of an AdafruitGFX drawing operation (a glyph, for example)
+void InkHUD::Applet::endWrite()
+{
+    flushRun();
+    GFX::endWrite();
+}
+
+// Fill a rectangle, cropped to the user's cropped region
+// Passed to the tile as one rect, rather than as individual pixels
+void InkHUD::Applet::fillCroppedRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    flushRun(); // Keep order, in case the rect overlaps a pending run
+
+    // AdafruitGFX allows negative sizes, extending left / up from x,y
+    int32_t x0 = (w < 0) ? x + w + 1 : x;
+    int32_t y0 = (h < 0) ? y + h + 1 : y;
+    int32_t x1 = x0 + abs(w); // Exclusive
+    int32_t y1 = y0 + abs(h); // Exclusive
+
+    // Crop
+    x0 = max(x0, (int32_t)cropLeft);
+    y0 = max(y0, (int32_t)cropTop);
+    x1 = min(x1, (int32_t)cropLeft + cropWidth);
+    y1 = min(y1, (int32_t)cropTop + cropHeight);
+
+    if (x0 < x1 && y0 < y1)
+        assignedTile->handleAppletRect(x0, y0, x1 - x0, y1 - y0, (Color)color);
+}
+
+void InkHUD::Applet::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    fillCroppedRect(x, y, w, h, color);
+}
+
+void InkHUD::Applet::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+    fillCroppedRect(x, y, w, 1, color);
+}
+
+void InkHUD::Applet::writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+    fillCroppedRect(x, y, 1, h, color);
+}
+
+void InkHUD::Applet::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    fillCroppedRect(x, y, w, h, color);
+}
+
+void InkHUD::Applet::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+    fillCroppedRect(x, y, w, 1, color);
+}
+
+void InkHUD::Applet::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+    fillCroppedRect(x, y, 1, h, color);
+}
+
 // Link our applet to a tile
 // This can only be called by Tile::assignApplet
 // The tile determines the applets dimensions
@@ -90,6 +184,8 @@ void InkHUD::Applet::render()
             Tile::highlightTarget = nullptr;
         }
     }
+
+    flushRun(); // In case AdafruitGFX left pixels pending without endWrite()
 }
 
 // Does the applet want to render now?
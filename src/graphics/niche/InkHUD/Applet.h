@@ -102,6 +102,16 @@ class Applet : public GFX
   protected:
     void drawPixel(int16_t x, int16_t y, uint16_t color) override; // Place a single pixel. All drawing output passes through here
 
+    // AdafruitGFX's rect, line and text primitives, routed to the tile as whole spans instead of pixel-by-pixel
+    void writePixel(int16_t x, int16_t y, uint16_t color) override;
+    void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+    void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+    void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+    void endWrite() override;
+
     void requestUpdate(EInk::UpdateTypes type = EInk::UpdateTypes::UNSPECIFIED); // Ask WindowManager to schedule a display update
     void requestAutoshow();                                                      // Ask for applet to be moved to foreground
 
@@ -164,6 +174,15 @@ class Applet : public GFX
 
     AppletFont currentFont; // As passed to setFont
 
+    void fillCroppedRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color); // All rect-like output passes through here
+    void flushRun(); // Pass any pending run of writePixel() output to the tile
+
+    // Horizontal run of pixels, collected from writePixel(), while AdafruitGFX draws text
+    int16_t runX = 0;
+    int16_t runY = 0;
+    uint16_t runW = 0;
+    Color runColor = BLACK;
+
     // As set by setCrop
     int16_t cropLeft = 0;
     int16_t cropTop = 0;
@@ -215,4 +215,11 @@ void InkHUD::InkHUD::drawPixel(int16_t x, int16_t y, Color c)
     renderer->handlePixel(x, y, c);
 }
 
+// Same as drawPixel, for a whole filled rectangle
+// Tiles pass runs and rects here already translated and cropped, so the Renderer can fill them a byte at a time
+void InkHUD::InkHUD::fillRect(int16_t x, int16_t y, uint16_t w, uint16_t h, Color c)
+{
+    renderer->handleRect(x, y, w, h, c);
+}
+
 #endif
\ No newline at end of file
@@ -7,6 +7,9 @@
 #include "./Applet.h"
 #include "./SystemApplet.h"
 #include "./Tile.h"
+#include "graphics/niche/Utils/BitmapRect.h"
+
+#include <algorithm>
 
 using namespace NicheGraphics;
 
@@ -121,6 +124,31 @@ void InkHUD::Renderer::handlePixel(int16_t x, int16_t y, Color c)
     bitWrite(imageBuffer[byteNum], bitNum, c);
 }
 
+// Fill a ready-to-draw rectangle into the image buffer
+// Same as calling handlePixel for each pixel, but the rotation is only worked out for two corners,
+// and the rows are written a byte at a time
+void InkHUD::Renderer::handleRect(int16_t x, int16_t y, uint16_t w, uint16_t h, Color c)
+{
+    if (w == 0 || h == 0)
+        return;
+
+    // Opposite corners
+    int16_t x0 = x;
+    int16_t y0 = y;
+    int16_t x1 = x + w - 1;
+    int16_t y1 = y + h - 1;
+    rotatePixelCoords(&x0, &y0);
+    rotatePixelCoords(&x1, &y1);
+
+    // Rotation may have swapped which corner is top-left
+    if (x0 > x1)
+        std::swap(x0, x1);
+    if (y0 > y1)
+        std::swap(y0, y1);
+
+    fillBitmapRect(imageBuffer, imageBufferWidth, x0, y0, x1, y1, c);
+}
+
 // Width of the display, relative to rotation
 uint16_t InkHUD::Renderer::width()
 {
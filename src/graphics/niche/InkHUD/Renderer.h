@@ -46,6 +46,7 @@ class Renderer : protected concurrency::OSThread
 
     // Receives pixel output from an applet (via a tile, which translates the coordinates)
     void handlePixel(int16_t x, int16_t y, Color c);
+    void handleRect(int16_t x, int16_t y, uint16_t w, uint16_t h, Color c); // Filled rect or span, rotated once as a whole
 
     // Size of display, in context of current rotation
 
@@ -190,6 +190,22 @@ void InkHUD::Tile::handleAppletPixel(int16_t x, int16_t y, Color c)
     }
 }
 
+// Receive a filled rectangle (or a run of pixels) from the assigned applet
+// Translated and cropped the same as handleAppletPixel, but passed on as a whole
+void InkHUD::Tile::handleAppletRect(int16_t x, int16_t y, uint16_t w, uint16_t h, Color c)
+{
+    // Move to tile-space, and crop to tile borders
+    // Wider type, so that the far edges can't overflow
+    int32_t x0 = max((int32_t)x + left, (int32_t)left);
+    int32_t y0 = max((int32_t)y + top, (int32_t)top);
+    int32_t x1 = min((int32_t)x + left + w, (int32_t)left + width); // Exclusive
+    int32_t y1 = min((int32_t)y + top + h, (int32_t)top + height);  // Exclusive
+
+    // Pass to the renderer, if anything is left
+    if (x0 < x1 && y0 < y1)
+        inkhud->fillRect(x0, y0, x1 - x0, y1 - y0, c);
+}
+
 // Called by Applet base class, when setting applet dimensions, immediately before render
 uint16_t InkHUD::Tile::getWidth()
 {
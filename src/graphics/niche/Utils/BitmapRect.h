@@ -0,0 +1,41 @@
+/*
+
+Re-usable NicheGraphics tool
+
+Fill a rectangle of a 1-bit image buffer, as used by the E-Ink drivers:
+rows of rowBytes bytes, 8 pixels per byte, leftmost pixel in the most significant bit
+
+Whole bytes are written with memset, only the partial bytes at the left and right edge need masking
+
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+namespace NicheGraphics
+{
+
+// Corners are inclusive, and must already be inside the buffer, with x0 <= x1 and y0 <= y1
+inline void fillBitmapRect(uint8_t *buffer, uint16_t rowBytes, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, bool set)
+{
+    const uint8_t fill = set ? 0xFF : 0x00;
+    const uint16_t firstByte = x0 / 8;
+    const uint16_t lastByte = x1 / 8;
+    uint8_t firstMask = 0xFF >> (x0 % 8);      // Pixels x0 onwards, in the first byte
+    uint8_t lastMask = 0xFF << (7 - (x1 % 8)); // Pixels up to x1, in the last byte
+    if (firstByte == lastByte)
+        firstMask &= lastMask;
+
+    for (uint16_t y = y0; y <= y1; y++) {
+        uint8_t *row = buffer + (uint32_t)y * rowBytes;
+        row[firstByte] = (row[firstByte] & ~firstMask) | (fill & firstMask);
+        if (lastByte > firstByte) {
+            memset(row + firstByte + 1, fill, lastByte - firstByte - 1);
+            row[lastByte] = (row[lastByte] & ~lastMask) | (fill & lastMask);
+        }
+    }
+}
+
+} // namespace NicheGraphics
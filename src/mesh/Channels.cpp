@@ -71,11 +71,20 @@ meshtastic_Channel &Channels::fixupChannel(ChannelIndex chIndex)
             *meshtastic_channelSettings.name = '\0';
     }
 
-    hashes[chIndex] = generateHash(chIndex);
+    setHash(chIndex, generateHash(chIndex));
 
     return ch;
 }
 
+void Channels::setHash(ChannelIndex chIndex, int16_t hash)
+{
+    if (hashes[chIndex] >= 0)
+        channelsByHash[hashes[chIndex]] &= ~(1 << chIndex);
+    hashes[chIndex] = hash;
+    if (hash >= 0)
+        channelsByHash[hash] |= 1 << chIndex;
+}
+
 void Channels::initDefaultLoraConfig()
 {
     meshtastic_Config_LoRaConfig &loraConfig = config.lora;
@@ -293,6 +302,11 @@ void Channels::onConfigChanged()
         if (ch.role == meshtastic_Channel_Role_PRIMARY)
             primaryIndex = i;
     }
+    // Keys may have changed, don't keep the schedules of old ones around (cryptLock only exists once the router is up)
+    if (cryptLock) {
+        concurrency::LockGuard g(cryptLock);
+        crypto->clearKeyCache();
+    }
 #if !MESHTASTIC_EXCLUDE_MQTT
     if (channels.anyMqttEnabled() && mqtt && !mqtt->isEnabled()) {
         LOG_DEBUG("MQTT is enabled on at least one channel, so set MQTT thread to run immediately");
@@ -28,6 +28,10 @@ class Channels
     /// the precomputed hashes for each of our channels, or -1 for invalid
     int16_t hashes[MAX_NUM_CHANNELS] = {};
 
+    /// the reverse of hashes: for each possible hash, a bit per channel index that currently has it
+    uint8_t channelsByHash[256] = {};
+    static_assert(MAX_NUM_CHANNELS <= 8, "channelsByHash needs a wider type");
+
   public:
     Channels() {}
 
@@ -75,6 +79,11 @@ class Channels
      */
     bool decryptForHash(ChannelIndex chIndex, ChannelHash channelHash);
 
+    /** Return the channels that might be able to decode a packet with this channel hash, as a bitmask (bit 0 is channel 0).
+     * Channels not in the mask need not be tried at all.
+     */
+    uint8_t getChannelsForHash(ChannelHash channelHash) const { return channelsByHash[channelHash]; }
+
     /** Given a channel index setup crypto for encoding that channel (or the primary channel if that channel is unsecured)
      *
      * This method is called before encoding outbound packets
@@ -113,6 +122,9 @@ class Channels
 
     int16_t getHash(ChannelIndex i) { return hashes[i]; }
 
+    /// Update the hash of a channel, keeping channelsByHash in sync
+    void setHash(ChannelIndex chIndex, int16_t hash);
+
     /**
      * Validate a channel, fixing any errors as needed
      */
@@ -140,15 +140,6 @@ public:
         return will_consume;
     }
 
-    uint16_t consume_line(T *line, uint16_t line_size) {
-        // intentionally do nothing in the general case
-        return 0;
-    }
-
-    void writeF(const T *format, ...) {
-        // intentionally do nothing in the general case
-    }
-
 private:
     const T end_item = 0;
 #ifdef ARDUINO_ARCH_RP2040
@@ -163,75 +154,3 @@ private:
     bool maxed = false;
     bool will_clear_if_empty = false;
 };
-
-template<>
-inline void CircularBuffer<char>::writeF(const char *format, ...) {
-    static char printBuf[600];
-    va_list arg;
-    va_start(arg, format);
-    size_t len = vsnprintf(printBuf, sizeof(printBuf), format, arg);
-    va_end(arg);
-    assert(len < sizeof(printBuf));
-    write(printBuf);
-}
-
-template<>
-inline uint16_t CircularBuffer<char>::consume_line(char *line, const uint16_t line_size) {
-    const uint16_t head_copy = head;
-    uint16_t tail_copy = tail;
-
-    uint16_t consumable = (head_copy <= tail_copy && !empty() ? fixed_size : head_copy) - tail_copy;
-    uint16_t will_consume = std::min(line_size, consumable);
-    auto to_consume = &buffer[tail_copy];
-    auto line_end = std::strchr(to_consume, '\n');
-    uint16_t written_out = 0;
-    if (line_end == nullptr) {
-        std::memcpy(line, to_consume, will_consume);
-        written_out = will_consume;
-        if (consumable == will_consume) {
-            uint16_t extra = 0;
-            if (head_copy <= tail_copy && !empty()) {
-                tail_copy = 0;
-                to_consume = &buffer[0];
-                line_end = std::strchr(to_consume, '\n');
-                if (line_end != nullptr) {
-                    extra = line_end - to_consume + 1;
-                    extra = std::min(static_cast<uint16_t>(line_size - written_out), extra);
-                    std::memcpy(&line[written_out], to_consume, extra);
-                    tail_copy = (tail_copy + extra) % fixed_size;
-                }
-            } else {
-                tail_copy = head_copy;
-            }
-            line[written_out + extra] = '\0';
-            maxed = false;
-            tail = tail_copy;
-            return written_out + extra;
-        }
-        tail_copy += written_out;
-        consumable = head_copy;
-        will_consume = std::min(static_cast<uint16_t>(line_size - written_out), consumable);
-        to_consume = &buffer[tail_copy];
-        line_end = strchr(to_consume, '\n');
-    }
-    uint16_t line_extra = will_consume;
-    if (line_end != nullptr) {
-        line_extra = std::min(will_consume, static_cast<uint16_t>(line_end - to_consume + 1));
-    }
-    std::memcpy(&line[written_out], to_consume, line_extra);
-    maxed = false;
-    if ((written_out + line_extra) <= consumable) {
-        tail_copy = (tail_copy + line_extra) % fixed_size;
-    } else if (head_copy <= tail_copy && !empty()) {
-        if (line_end == nullptr) {
-            tail_copy = written_out + will_consume;
-        } else {
-            tail_copy = line_size;
-        }
-    } else {
-        tail_copy = head_copy;
-    }
-    line[written_out + line_extra] = '\0';
-    tail = tail_copy;
-    return written_out + line_extra;
-}
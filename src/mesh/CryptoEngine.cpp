@@ -33,6 +33,7 @@ void CryptoEngine::generateKeyPair(uint8_t *pubKey, uint8_t *privKey)
 
     LOG_DEBUG("Generate Curve25519 keypair");
     Curve25519::dh1(public_key, private_key);
+    clearSharedKeyCache();
     memcpy(pubKey, public_key, sizeof(public_key));
     memcpy(privKey, private_key, sizeof(private_key));
 }
@@ -54,6 +55,7 @@ bool CryptoEngine::regeneratePublicKey(uint8_t *pubKey, uint8_t *privKey)
         }
         memcpy(private_key, privKey, sizeof(private_key));
         memcpy(public_key, pubKey, sizeof(public_key));
+        clearSharedKeyCache();
     } else {
         LOG_WARN("X25519 key generation failed due to blank private key");
         return false;
@@ -65,6 +67,41 @@ void CryptoEngine::clearKeys()
 {
     memset(public_key, 0, sizeof(public_key));
     memset(private_key, 0, sizeof(private_key));
+    clearSharedKeyCache();
+}
+
+void CryptoEngine::clearSharedKeyCache()
+{
+    memset(sharedKeyCache, 0, sizeof(sharedKeyCache));
+}
+
+bool CryptoEngine::setSharedKeyFor(NodeNum node, uint8_t *remotePublic)
+{
+    sharedKeyCacheClock++;
+    CachedSharedKey *victim = &sharedKeyCache[0];
+    for (CachedSharedKey &c : sharedKeyCache) {
+        if (c.lastUsed && c.node == node && memcmp(c.publicKey, remotePublic, sizeof(c.publicKey)) == 0) {
+            c.lastUsed = sharedKeyCacheClock;
+            memcpy(shared_key, c.sharedKey, sizeof(shared_key));
+            sharedKeyCacheHits++;
+            return true;
+        }
+        // Free entries first, then the one unused for the longest time (wraparound safe)
+        if (!c.lastUsed || (victim->lastUsed && (int32_t)(c.lastUsed - victim->lastUsed) < 0))
+            victim = &c;
+    }
+    sharedKeyCacheMisses++;
+
+    if (!setDHPublicKey(remotePublic))
+        return false;
+    hash(shared_key, 32);
+
+    memset(victim, 0, sizeof(*victim)); // don't leave parts of the evicted key behind
+    victim->node = node;
+    memcpy(victim->publicKey, remotePublic, sizeof(victim->publicKey));
+    memcpy(victim->sharedKey, shared_key, sizeof(victim->sharedKey));
+    victim->lastUsed = sharedKeyCacheClock;
+    return true;
 }
 
 /**
@@ -92,10 +129,9 @@ bool CryptoEngine::encryptCurve25519(uint32_t toNode, uint32_t fromNode, meshtas
         LOG_DEBUG("Node %d or their public_key not found", toNode);
         return false;
     }
-    if (!crypto->setDHPublicKey(remotePublic.bytes)) {
+    if (!setSharedKeyFor(toNode, remotePublic.bytes)) {
         return false;
     }
-    crypto->hash(shared_key, 32);
     initNonce(fromNode, packetNum, extraNonceTmp);
 
     // Calculate the shared secret with the destination node and encrypt
@@ -134,10 +170,9 @@ bool CryptoEngine::decryptCurve25519(uint32_t fromNode, meshtastic_UserLite_publ
     }
 
     // Calculate the shared secret with the sending node and decrypt
-    if (!crypto->setDHPublicKey(remotePublic.bytes)) {
+    if (!setSharedKeyFor(fromNode, remotePublic.bytes)) {
         return false;
     }
-    crypto->hash(shared_key, 32);
 
     initNonce(fromNode, packetNum, extraNonce);
     printBytes("Attempt decrypt with nonce: ", nonce, 13);
@@ -147,6 +182,8 @@ bool CryptoEngine::decryptCurve25519(uint32_t fromNode, meshtastic_UserLite_publ
 
 void CryptoEngine::setDHPrivateKey(uint8_t *_private_key)
 {
+    if (memcmp(private_key, _private_key, 32) != 0)
+        clearSharedKeyCache();
     memcpy(private_key, _private_key, 32);
 }
 
@@ -236,13 +273,7 @@ void CryptoEngine::decrypt(uint32_t fromNode, uint64_t packetId, size_t numBytes
 // Generic implementation of AES-CTR encryption.
 void CryptoEngine::encryptAESCtr(CryptoKey _key, uint8_t *_nonce, size_t numBytes, uint8_t *bytes)
 {
-    delete ctr;
-    ctr = nullptr;
-    if (_key.length == 16)
-        ctr = new CTR<AES128>();
-    else
-        ctr = new CTR<AES256>();
-    ctr->setKey(_key.bytes, _key.length);
+    CTRCommon *ctr = getCtr(_key);
     static uint8_t scratch[MAX_BLOCKSIZE];
     memcpy(scratch, bytes, numBytes);
     memset(scratch + numBytes, 0,
@@ -253,6 +284,39 @@ void CryptoEngine::encryptAESCtr(CryptoKey _key, uint8_t *_nonce, size_t numByte
     ctr->encrypt(bytes, scratch, numBytes);
 }
 
+CTRCommon *CryptoEngine::getCtr(const CryptoKey &k)
+{
+    ctrCacheClock++;
+    CachedCtr *victim = &ctrCache[0];
+    for (CachedCtr &c : ctrCache) {
+        if (c.ctr && c.key.length == k.length && memcmp(c.key.bytes, k.bytes, k.length) == 0) {
+            c.lastUsed = ctrCacheClock;
+            return c.ctr;
+        }
+        // Free entries first, then the one unused for the longest time (wraparound safe)
+        if (!c.ctr || (victim->ctr && (int32_t)(c.lastUsed - victim->lastUsed) < 0))
+            victim = &c;
+    }
+
+    delete victim->ctr;
+    if (k.length == 16)
+        victim->ctr = new CTR<AES128>();
+    else
+        victim->ctr = new CTR<AES256>();
+    victim->ctr->setKey(k.bytes, k.length);
+    victim->key = k;
+    victim->lastUsed = ctrCacheClock;
+    return victim->ctr;
+}
+
+void CryptoEngine::clearKeyCache()
+{
+    for (CachedCtr &c : ctrCache) {
+        delete c.ctr; // the ciphers wipe their key schedule on destruction
+        memset(&c, 0, sizeof(c));
+    }
+}
+
 /**
  * Init our 128 bit nonce for a new packet
  */
@@ -21,6 +21,16 @@ struct CryptoKey {
  */
 
 #define MAX_BLOCKSIZE 256
+
+/// Number of expanded AES-CTR key schedules kept around by the generic (software) encryptAESCtr
+#ifndef CRYPTO_KEY_CACHE_SIZE
+#define CRYPTO_KEY_CACHE_SIZE 4
+#endif
+
+/// Number of PKI shared keys (one per remote node we exchange direct messages with) kept around
+#ifndef PKI_SHARED_KEY_CACHE_SIZE
+#define PKI_SHARED_KEY_CACHE_SIZE 8
+#endif
 #define TEST_CURVE25519_FIELD_OPS // Exposes Curve25519::isWeakPoint() for testing keys
 
 class CryptoEngine
@@ -30,7 +40,7 @@ class CryptoEngine
     uint8_t public_key[32] = {0};
 #endif
 
-    virtual ~CryptoEngine() {}
+    virtual ~CryptoEngine() { clearKeyCache(); }
 #if !(MESHTASTIC_EXCLUDE_PKI)
 #if !(MESHTASTIC_EXCLUDE_PKI_KEYGEN)
     virtual void generateKeyPair(uint8_t *pubKey, uint8_t *privKey);
@@ -51,6 +61,12 @@ class CryptoEngine
     virtual void aesEncrypt(uint8_t *in, uint8_t *out);
     AESSmall256 *aes = NULL;
 
+    /// Forget (and wipe) all cached PKI shared keys, done whenever our private key changes
+    void clearSharedKeyCache();
+
+    /// Statistics for the PKI shared key cache
+    uint32_t sharedKeyCacheHits = 0, sharedKeyCacheMisses = 0;
+
 #endif
 
     /**
@@ -72,13 +88,47 @@ class CryptoEngine
     virtual void encryptPacket(uint32_t fromNode, uint64_t packetId, size_t numBytes, uint8_t *bytes);
     virtual void decrypt(uint32_t fromNode, uint64_t packetId, size_t numBytes, uint8_t *bytes);
     virtual void encryptAESCtr(CryptoKey key, uint8_t *nonce, size_t numBytes, uint8_t *bytes);
+
+    /// Forget (and wipe) all cached AES key schedules, call when channel keys change
+    void clearKeyCache();
 #ifndef PIO_UNIT_TESTING
   protected:
 #endif
     /** Our per packet nonce */
     uint8_t nonce[16] = {0};
     CryptoKey key = {};
-    CTRCommon *ctr = NULL;
+
+    /** Expanded AES-CTR contexts of recently used keys.  perhapsDecode and sending hop between channel keys from packet to
+     * packet, without this every hop reallocated the context and redid the key expansion.  Entries are matched by key bytes,
+     * so a changed key simply misses and the least recently used entry is replaced. */
+    struct CachedCtr {
+        CryptoKey key;
+        CTRCommon *ctr;
+        uint32_t lastUsed;
+    };
+    CachedCtr ctrCache[CRYPTO_KEY_CACHE_SIZE] = {};
+    uint32_t ctrCacheClock = 0;
+
+    /// @return a CTR context with k set as key, from the cache or newly set up in place of the least recently used one
+    CTRCommon *getCtr(const CryptoKey &k);
+
+#if !(MESHTASTIC_EXCLUDE_PKI)
+    /** Shared keys (the hashed X25519 result) derived for remote nodes.  Deriving one costs a scalar multiplication, far more
+     * than the AES-CCM of the packet itself.  An entry only matches the same node with the same public key, so a node changing
+     * its key simply misses. */
+    struct CachedSharedKey {
+        NodeNum node;
+        uint8_t publicKey[32];
+        uint8_t sharedKey[32];
+        uint32_t lastUsed; // 0 for a free entry
+    };
+    CachedSharedKey sharedKeyCache[PKI_SHARED_KEY_CACHE_SIZE] = {};
+    uint32_t sharedKeyCacheClock = 0;
+
+    /// Set shared_key for talking to node, from the cache or by running the key exchange with remotePublic
+    /// @return false if the key exchange failed (e.g. a weak public key)
+    bool setSharedKeyFor(NodeNum node, uint8_t *remotePublic);
+#endif
 #if !(MESHTASTIC_EXCLUDE_PKI)
     uint8_t shared_key[32] = {0};
     uint8_t private_key[32] = {0};
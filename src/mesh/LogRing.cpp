@@ -0,0 +1,89 @@
+#include "LogRing.h"
+
+#include <cstring>
+
+LogRing::LogRing(uint32_t capacity)
+{
+    uint32_t size = 16;
+    while (size < capacity)
+        size <<= 1;
+    mask = size - 1;
+
+    // Zeroed, so that no stale bytes look like a committed header.  Words, so that headers are aligned.
+    buffer = reinterpret_cast<uint8_t *>(new uint32_t[size / 4]());
+}
+
+LogRing::~LogRing()
+{
+    delete[] reinterpret_cast<uint32_t *>(buffer);
+}
+
+bool LogRing::write(char level, const char *text, uint16_t len)
+{
+    const uint32_t need = recordSize(len);
+
+    // Reserve space.  The tail only moves forward, so a stale read of it never lets us overrun the reader.
+    uint32_t pos = head.load(std::memory_order_relaxed);
+    do {
+        if (pos + need - tail.load(std::memory_order_acquire) > mask + 1) {
+            droppedLines.fetch_add(1, std::memory_order_relaxed);
+            droppedBytes.fetch_add(len, std::memory_order_relaxed);
+            return false;
+        }
+    } while (!head.compare_exchange_weak(pos, pos + need, std::memory_order_relaxed));
+
+    // Fill in the text, then publish it
+    copyIn(pos + HEADER_SIZE, text, len);
+    __atomic_store_n(headerAt(pos), COMMITTED | ((uint32_t)(uint8_t)level << 16) | len, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool LogRing::read(char *level, char *line, uint16_t lineSize, uint16_t *len)
+{
+    const uint32_t pos = tail.load(std::memory_order_relaxed);
+    if (pos == head.load(std::memory_order_acquire))
+        return false;
+
+    // Reserved, but the writer hasn't finished with it yet
+    const uint32_t header = __atomic_load_n(headerAt(pos), __ATOMIC_ACQUIRE);
+    if (!(header & COMMITTED))
+        return false;
+
+    const uint16_t recordLen = header & 0xFFFF;
+    const uint16_t n = recordLen < lineSize ? recordLen : lineSize - 1;
+    *level = (char)((header >> 16) & 0xFF);
+    copyOut(pos + HEADER_SIZE, line, n);
+    line[n] = '\0';
+    if (len)
+        *len = n;
+
+    // Clear the record before handing the space back, a later header may land anywhere in it
+    const uint32_t size = recordSize(recordLen);
+    zero(pos, size);
+    tail.store(pos + size, std::memory_order_release);
+    return true;
+}
+
+void LogRing::copyIn(uint32_t pos, const char *src, uint16_t len)
+{
+    const uint32_t start = pos & mask;
+    const uint32_t first = (len < mask + 1 - start) ? len : mask + 1 - start;
+    memcpy(buffer + start, src, first);
+    memcpy(buffer, src + first, len - first);
+}
+
+void LogRing::copyOut(uint32_t pos, char *dst, uint16_t len) const
+{
+    const uint32_t start = pos & mask;
+    const uint32_t first = (len < mask + 1 - start) ? len : mask + 1 - start;
+    memcpy(dst, buffer + start, first);
+    memcpy(dst + first, buffer, len - first);
+}
+
+void LogRing::zero(uint32_t pos, uint32_t len)
+{
+    const uint32_t start = pos & mask;
+    const uint32_t first = (len < mask + 1 - start) ? len : mask + 1 - start;
+    memset(buffer + start, 0, first);
+    memset(buffer, 0, len - first);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * A ring of log lines that can be written from interrupt handlers and from either core, and drained by one reader.
+ *
+ * Each line is one record: a 32 bit header (length, level and a committed flag) followed by the text, padded to a multiple
+ * of 4 bytes so headers never straddle the end of the buffer.  Writers reserve space with a compare-and-swap on the head,
+ * copy their text in, then publish the header.  The reader stops at the first record that is reserved but not yet
+ * committed, so lines come out whole and in the order they were reserved, however writers interrupt each other.
+ *
+ * Nothing blocks.  A line that doesn't fit is dropped and counted, and lines already queued are never touched.
+ */
+class LogRing
+{
+  public:
+    /// @param capacity size of the ring in bytes, rounded up to a power of two
+    explicit LogRing(uint32_t capacity);
+    ~LogRing();
+
+    LogRing(const LogRing &) = delete;
+    LogRing &operator=(const LogRing &) = delete;
+
+    /// Queue one line (without a trailing newline).  Safe from ISRs and either core.
+    /// @return false if there was no room, the line is dropped
+    bool write(char level, const char *text, uint16_t len);
+
+    /// Take the oldest complete line out of the ring.  Only one reader at a time.
+    /// @param line receives the text, NUL terminated, truncated to lineSize - 1
+    /// @param len if given, receives the length of the text in line (which may itself contain NULs)
+    /// @return false if there is no complete line yet
+    bool read(char *level, char *line, uint16_t lineSize, uint16_t *len = nullptr);
+
+    /// Nothing queued, not even lines still being written
+    bool empty() const { return tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire); }
+
+    uint32_t getCapacity() const { return mask + 1; }
+    uint32_t getDroppedLines() const { return droppedLines.load(std::memory_order_relaxed); }
+    uint32_t getDroppedBytes() const { return droppedBytes.load(std::memory_order_relaxed); }
+
+  private:
+    static constexpr uint32_t HEADER_SIZE = 4;
+    static constexpr uint32_t COMMITTED = 1UL << 31;
+
+    uint8_t *buffer;
+    uint32_t mask;
+
+    std::atomic<uint32_t> head{0}; // Next byte to reserve, only ever grows (wrapping at 2^32)
+    std::atomic<uint32_t> tail{0}; // Next record to read
+    std::atomic<uint32_t> droppedLines{0};
+    std::atomic<uint32_t> droppedBytes{0};
+
+    static uint32_t recordSize(uint16_t len) { return HEADER_SIZE + ((len + 3) & ~3UL); }
+    uint32_t *headerAt(uint32_t pos) const { return reinterpret_cast<uint32_t *>(buffer + (pos & mask)); }
+    void copyIn(uint32_t pos, const char *src, uint16_t len);
+    void copyOut(uint32_t pos, char *dst, uint16_t len) const;
+    void zero(uint32_t pos, uint32_t len);
+};
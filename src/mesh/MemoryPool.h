@@ -2,6 +2,7 @@
 
 #include <Arduino.h>
 #include <assert.h>
+#include <atomic>
 #include <functional>
 #include <memory>
 
@@ -62,6 +63,14 @@ template <class T> class Allocator
         return UniqueAllocation(allocCopy(src, maxWait), deleter);
     }
 
+    /// Return p for one more owner, who release()s it like any other allocation.  Pools that count references hand out p
+    /// itself, so a shared object must not be modified by anyone anymore.  Otherwise (or if p is not from the pool) it is copied.
+    virtual T *share(const T *p) { return allocCopy(*p); }
+
+    /// Make p, which the caller holds, safe to modify: if others share it the caller's share is swapped for a private copy.
+    /// Use the returned pointer from then on.
+    virtual T *unshare(T *p) { return p; }
+
     /// Return a buffer for use by others
     virtual void release(T *p) = 0;
 
@@ -96,3 +105,165 @@ template <class T> class MemoryDynamic : public Allocator<T>
         return p;
     }
 };
+
+/// What a MemoryPool does once all its slabs are in use: fall back to malloc (true) or fail the allocation (false)
+#ifndef MEMORY_POOL_OVERFLOW_TO_HEAP
+#define MEMORY_POOL_OVERFLOW_TO_HEAP true
+#endif
+
+/**
+ * A fixed number of slabs of T, allocated once up front, so the heap is not fragmented by objects coming and going all day.
+ *
+ * Slabs are reference counted, share() hands out the same slab again instead of a copy, it goes back to the pool with its last
+ * release().  Free slabs are kept on a lock-free stack (an index plus a generation tag in one atomic word, against ABA), so
+ * alloc and release never block and are safe to call from ISRs.  If the pool runs dry the allocation either falls back to
+ * malloc or fails, see MEMORY_POOL_OVERFLOW_TO_HEAP.  Heap fallbacks are not ISR safe, same as MemoryDynamic.
+ */
+template <class T> class MemoryPool : public Allocator<T>
+{
+  public:
+    explicit MemoryPool(uint16_t _capacity, bool _overflowToHeap = MEMORY_POOL_OVERFLOW_TO_HEAP)
+        : overflowToHeap(_overflowToHeap)
+    {
+        assert(_capacity < NO_SLAB);
+        slabs = (T *)malloc(sizeof(T) * _capacity);
+        next = (std::atomic<uint16_t> *)malloc(sizeof(std::atomic<uint16_t>) * _capacity);
+        refs = (std::atomic<uint8_t> *)malloc(sizeof(std::atomic<uint8_t>) * _capacity);
+        capacity = slabs && next && refs ? _capacity : 0;
+        for (uint16_t i = 0; i < capacity; i++)
+            next[i].store(i + 1 < capacity ? i + 1 : NO_SLAB, std::memory_order_relaxed);
+        head.store(capacity ? 0 : NO_SLAB);
+    }
+
+    ~MemoryPool()
+    {
+        free(slabs);
+        free(next);
+        free(refs);
+    }
+
+    /// Return a buffer for use by others
+    virtual void release(T *p) override
+    {
+        assert(p);
+        if (!owns(p)) {
+            // One of our heap fallbacks
+            free(p);
+            return;
+        }
+        uint16_t i = p - slabs;
+        assert(refs[i] > 0);
+        if (--refs[i] == 0) {
+            inUse--;
+            push(i);
+        }
+    }
+
+    virtual T *share(const T *p) override
+    {
+        assert(p);
+        if (!owns(p))
+            return Allocator<T>::share(p);
+        uint16_t i = p - slabs;
+        assert(refs[i] > 0 && refs[i] < UINT8_MAX);
+        refs[i]++;
+        numShares++;
+        return const_cast<T *>(p);
+    }
+
+    virtual T *unshare(T *p) override
+    {
+        assert(p);
+        if (!owns(p) || refs[p - slabs] == 1)
+            return p;
+        T *copy = this->allocCopy(*p);
+        release(p);
+        return copy;
+    }
+
+    /// @return number of slabs in the pool
+    uint16_t getCapacity() const { return capacity; }
+
+    /// @return number of slabs currently handed out
+    uint16_t getInUse() const { return inUse; }
+
+    /// @return the most slabs that were ever in use at the same time
+    uint16_t getHighWaterMark() const { return highWaterMark; }
+
+    /// @return how many allocations found the pool empty
+    uint32_t getAllocFailures() const { return allocFailures; }
+
+    /// @return how many of those were served from the heap instead
+    uint32_t getHeapFallbacks() const { return heapFallbacks; }
+
+    /// @return how many objects were allocated (slab or heap) since boot
+    uint32_t getNumAllocs() const { return numAllocs; }
+
+    /// @return how many times share() got away without a copy
+    uint32_t getNumShares() const { return numShares; }
+
+  protected:
+    // Alloc some storage
+    virtual T *alloc(TickType_t maxWait) override
+    {
+        numAllocs++;
+        uint16_t i = pop();
+        if (i == NO_SLAB) {
+            allocFailures++;
+            if (!overflowToHeap)
+                return NULL;
+            heapFallbacks++;
+            return (T *)malloc(sizeof(T));
+        }
+
+        refs[i].store(1, std::memory_order_relaxed);
+        uint16_t n = ++inUse;
+        uint16_t hwm = highWaterMark;
+        while (n > hwm && !highWaterMark.compare_exchange_weak(hwm, n))
+            ;
+        return &slabs[i];
+    }
+
+  private:
+    static constexpr uint16_t NO_SLAB = UINT16_MAX;
+
+    T *slabs = NULL;
+    std::atomic<uint16_t> *next = NULL; // free list links, next[i] is the slab below i on the stack
+    std::atomic<uint8_t> *refs = NULL;  // owners of each slab in use
+    uint16_t capacity = 0;
+    bool overflowToHeap;
+
+    std::atomic<uint32_t> head; // top of the free stack in the low half, generation tag in the high half
+    std::atomic<uint16_t> inUse{0};
+    std::atomic<uint16_t> highWaterMark{0};
+    std::atomic<uint32_t> allocFailures{0};
+    std::atomic<uint32_t> heapFallbacks{0};
+    std::atomic<uint32_t> numAllocs{0};
+    std::atomic<uint32_t> numShares{0};
+
+    bool owns(const T *p) const { return (uintptr_t)p >= (uintptr_t)slabs && (uintptr_t)p < (uintptr_t)(slabs + capacity); }
+
+    uint16_t pop()
+    {
+        uint32_t h = head.load();
+        while (true) {
+            uint16_t i = h & 0xffff;
+            if (i == NO_SLAB)
+                return NO_SLAB;
+            // If someone else took i meanwhile the tag has moved on and the exchange fails
+            uint32_t n = (h & 0xffff0000) + 0x10000 + next[i].load(std::memory_order_relaxed);
+            if (head.compare_exchange_weak(h, n))
+                return i;
+        }
+    }
+
+    void push(uint16_t i)
+    {
+        uint32_t h = head.load();
+        uint32_t n;
+        do {
+            next[i].store(h & 0xffff, std::memory_order_relaxed);
+            n = (h & 0xffff0000) + 0x10000 + i;
+        } while (!head.compare_exchange_weak(h, n));
+    }
+};
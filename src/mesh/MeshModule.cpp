@@ -10,6 +10,7 @@
 std::vector<MeshModule *> *MeshModule::modules;
 
 const meshtastic_MeshPacket *MeshModule::currentRequest;
+RxSource MeshModule::currentSource;
 uint8_t MeshModule::numPeriodicModules = 0;
 
 /**
@@ -85,6 +86,14 @@ meshtastic_MeshPacket *MeshModule::allocErrorResponse(meshtastic_Routing_Error e
     return r;
 }
 
+meshtastic_MeshPacket *MeshModule::keepReceived(const meshtastic_MeshPacket &mp)
+{
+    // A module handling a packet may send one, which comes back through callModules() and resets these, then we copy
+    if (&mp == currentRequest && currentSource == RX_SRC_RADIO)
+        return packetPool.share(&mp);
+    return packetPool.allocCopy(mp);
+}
+
 void MeshModule::callModules(meshtastic_MeshPacket &mp, RxSource src)
 {
     // LOG_DEBUG("In call modules");
@@ -94,6 +103,7 @@ void MeshModule::callModules(meshtastic_MeshPacket &mp, RxSource src)
     bool isDecoded = mp.which_payload_variant == meshtastic_MeshPacket_decoded_tag;
 
     currentReply = NULL; // No reply yet
+    currentSource = src;
 
     bool ignoreRequest = false; // No module asked to ignore the request yet
 
@@ -75,6 +75,13 @@ class MeshModule
      */
     static void callModules(meshtastic_MeshPacket &mp, RxSource src = RX_SRC_RADIO);
 
+    /**
+     * Hold on to mp past handleReceived(), release it to packetPool when done.  A packet from the radio isn't modified anymore
+     * once the modules see it, so it is shared.  Anything else is copied: a packet from us goes on to Router::send(), which
+     * encrypts it in place.
+     */
+    static meshtastic_MeshPacket *keepReceived(const meshtastic_MeshPacket &mp);
+
     static std::vector<MeshModule *> GetMeshModulesWithUIFrames(int startIndex);
     static void observeUIEvents(Observer<const UIFrameEvent *> *observer);
     static AdminMessageHandleResult handleAdminMessageForAllModules(const meshtastic_MeshPacket &mp,
@@ -122,6 +129,9 @@ class MeshModule
      */
     static const meshtastic_MeshPacket *currentRequest;
 
+    /// Where currentRequest came from
+    static RxSource currentSource;
+
     // We keep track of the number of modules that send a periodic broadcast to schedule them spaced out over time
     static uint8_t numPeriodicModules;
 
@@ -28,11 +28,140 @@ bool CompareMeshPacketFunc(const meshtastic_MeshPacket *p1, const meshtastic_Mes
     return (p1p != p2p) ? (p1p > p2p) : (!isFromUs(p1) && isFromUs(p2));
 }
 
-MeshPacketQueue::MeshPacketQueue(size_t _maxLen) : maxLen(_maxLen) {}
+MeshPacketQueue::MeshPacketQueue(size_t _maxLen) : maxLen(_maxLen)
+{
+    entries.resize(maxLen);
+    heap.reserve(maxLen);
+    freeEntries.reserve(maxLen);
+    for (size_t i = maxLen; i-- > 0;) {
+        entries[i].packet = NULL;
+        freeEntries.push_back(i);
+    }
+
+    uint32_t indexSize = 8;
+    uint8_t indexBits = 3;
+    while (indexSize < maxLen * 2) {
+        indexSize <<= 1;
+        indexBits++;
+    }
+    index.assign(indexSize, NO_ENTRY);
+    indexMask = indexSize - 1;
+    indexShift = 32 - indexBits;
+}
 
 bool MeshPacketQueue::empty()
 {
-    return queue.empty();
+    return heap.empty();
+}
+
+bool MeshPacketQueue::before(uint16_t a, uint16_t b) const
+{
+    const Entry &ea = entries[a], &eb = entries[b];
+    if (CompareMeshPacketFunc(ea.packet, eb.packet))
+        return true;
+    if (CompareMeshPacketFunc(eb.packet, ea.packet))
+        return false;
+    return (int32_t)(ea.seq - eb.seq) < 0; // same rank, first come first served (wraparound safe)
+}
+
+void MeshPacketQueue::siftUp(size_t pos)
+{
+    uint16_t e = heap[pos];
+    while (pos > 0) {
+        size_t parent = (pos - 1) / 2;
+        if (!before(e, heap[parent]))
+            break;
+        heap[pos] = heap[parent];
+        entries[heap[pos]].heapPos = pos;
+        pos = parent;
+    }
+    heap[pos] = e;
+    entries[e].heapPos = pos;
+}
+
+void MeshPacketQueue::siftDown(size_t pos)
+{
+    uint16_t e = heap[pos];
+    size_t n = heap.size();
+    while (true) {
+        size_t child = 2 * pos + 1;
+        if (child >= n)
+            break;
+        if (child + 1 < n && before(heap[child + 1], heap[child]))
+            child++;
+        if (!before(heap[child], e))
+            break;
+        heap[pos] = heap[child];
+        entries[heap[pos]].heapPos = pos;
+        pos = child;
+    }
+    heap[pos] = e;
+    entries[e].heapPos = pos;
+}
+
+meshtastic_MeshPacket *MeshPacketQueue::removeAt(size_t pos)
+{
+    uint16_t e = heap[pos];
+    meshtastic_MeshPacket *p = entries[e].packet;
+
+    indexErase(e);
+    uint16_t last = heap.back();
+    heap.pop_back();
+    if (pos < heap.size()) {
+        heap[pos] = last;
+        entries[last].heapPos = pos;
+        if (pos > 0 && before(last, heap[(pos - 1) / 2]))
+            siftUp(pos);
+        else
+            siftDown(pos);
+    }
+
+    entries[e].packet = NULL;
+    freeEntries.push_back(e);
+    return p;
+}
+
+void MeshPacketQueue::indexInsert(uint16_t e)
+{
+    uint32_t i = indexHome(entries[e].from, entries[e].packet->id);
+    while (index[i] != NO_ENTRY)
+        i = (i + 1) & indexMask;
+    index[i] = e;
+}
+
+void MeshPacketQueue::indexErase(uint16_t e)
+{
+    uint32_t i = indexHome(entries[e].from, entries[e].packet->id);
+    while (index[i] != NO_ENTRY && index[i] != e)
+        i = (i + 1) & indexMask;
+    if (index[i] == NO_ENTRY)
+        return;
+
+    // Backward shift deletion, so no tombstones are needed
+    for (uint32_t j = (i + 1) & indexMask; index[j] != NO_ENTRY; j = (j + 1) & indexMask) {
+        const Entry &m = entries[index[j]];
+        uint32_t h = indexHome(m.from, m.packet->id);
+        if (((j - h) & indexMask) >= ((j - i) & indexMask)) {
+            index[i] = index[j];
+            i = j;
+        }
+    }
+    index[i] = NO_ENTRY;
+}
+
+int MeshPacketQueue::findPos(NodeNum from, PacketId id, bool tx_normal, bool tx_late) const
+{
+    int found = -1;
+    for (uint32_t i = indexHome(from, id); index[i] != NO_ENTRY; i = (i + 1) & indexMask) {
+        const Entry &e = entries[index[i]];
+        const meshtastic_MeshPacket *p = e.packet;
+        if (e.from == from && p->id == id && ((tx_normal && !p->tx_after) || (tx_late && p->tx_after))) {
+            // The same packet may be queued twice, return the one that would be sent first
+            if (found < 0 || before(index[i], heap[found]))
+                found = e.heapPos;
+        }
+    }
+    return found;
 }
 
 /**
@@ -68,7 +197,7 @@ void fixPriority(meshtastic_MeshPacket *p)
 bool MeshPacketQueue::enqueue(meshtastic_MeshPacket *p)
 {
     // no space - try to replace a lower priority packet in the queue
-    if (queue.size() >= maxLen) {
+    if (heap.size() >= maxLen) {
         bool replaced = replaceLowerPriorityPacket(p);
         if (!replaced) {
             LOG_WARN("TX queue is full, and there is no lower-priority packet available to evict in favour of 0x%08x", p->id);
@@ -76,9 +205,15 @@ bool MeshPacketQueue::enqueue(meshtastic_MeshPacket *p)
         return replaced;
     }
 
-    // Find the correct position using upper_bound to maintain a stable order
-    auto it = std::upper_bound(queue.begin(), queue.end(), p, CompareMeshPacketFunc);
-    queue.insert(it, p); // Insert packet at the found position
+    uint16_t e = freeEntries.back();
+    freeEntries.pop_back();
+    entries[e].packet = p;
+    entries[e].from = getFrom(p);
+    entries[e].seq = nextSeq++;
+    indexInsert(e);
+
+    heap.push_back(e);
+    siftUp(heap.size() - 1);
     return true;
 }
 
@@ -88,9 +223,7 @@ meshtastic_MeshPacket *MeshPacketQueue::dequeue()
         return NULL;
     }
 
-    auto *p = queue.front();
-    queue.erase(queue.begin()); // Remove the highest-priority packet
-    return p;
+    return removeAt(0); // Remove the highest-priority packet
 }
 
 meshtastic_MeshPacket *MeshPacketQueue::getFront()
@@ -99,77 +232,50 @@ meshtastic_MeshPacket *MeshPacketQueue::getFront()
         return NULL;
     }
 
-    auto *p = queue.front();
-    return p;
+    return entries[heap[0]].packet;
 }
 
 /** Attempt to find and remove a packet from this queue.  Returns a pointer to the removed packet, or NULL if not found */
 meshtastic_MeshPacket *MeshPacketQueue::remove(NodeNum from, PacketId id, bool tx_normal, bool tx_late)
 {
-    for (auto it = queue.begin(); it != queue.end(); it++) {
-        auto p = (*it);
-        if (getFrom(p) == from && p->id == id && ((tx_normal && !p->tx_after) || (tx_late && p->tx_after))) {
-            queue.erase(it);
-            return p;
-        }
-    }
-
-    return NULL;
+    int pos = findPos(from, id, tx_normal, tx_late);
+    return pos < 0 ? NULL : removeAt(pos);
 }
 
 /* Attempt to find a packet from this queue. Return true if it was found. */
 bool MeshPacketQueue::find(const NodeNum from, const PacketId id)
 {
-    for (auto it = queue.begin(); it != queue.end(); it++) {
-        const auto *p = *it;
-        if (getFrom(p) == from && p->id == id) {
-            return true;
-        }
-    }
-
-    return false;
+    return findPos(from, id, true, true) >= 0;
 }
 
 /**
  * Attempt to find a lower-priority packet in the queue and replace it with the provided one.
+ * Only called when the queue is full, so a linear walk over the heap for the last non-late packet is fine here.
  * @return True if the replacement succeeded, false otherwise
  */
 bool MeshPacketQueue::replaceLowerPriorityPacket(meshtastic_MeshPacket *p)
 {
 
-    if (queue.empty()) {
+    if (heap.empty()) {
         return false; // No packets to replace
     }
 
-    // Check if the packet at the back has a lower priority than the new packet
-    auto *backPacket = queue.back();
-    if (!backPacket->tx_after && backPacket->priority < p->priority) {
-        LOG_WARN("Dropping packet 0x%08x to make room in the TX queue for higher-priority packet 0x%08x", backPacket->id, p->id);
-        // Remove the back packet
-        queue.pop_back();
-        packetPool.release(backPacket);
+    // The packet that would be sent last, ignoring the ones in the late transmit window (which are never evicted)
+    int victim = -1;
+    for (size_t pos = 0; pos < heap.size(); pos++) {
+        if (!entries[heap[pos]].packet->tx_after && (victim < 0 || before(heap[victim], heap[pos])))
+            victim = pos;
+    }
+
+    if (victim >= 0 && entries[heap[victim]].packet->priority < p->priority) {
+        meshtastic_MeshPacket *dropped = removeAt(victim);
+        LOG_WARN("Dropping packet 0x%08x to make room in the TX queue for higher-priority packet 0x%08x", dropped->id, p->id);
+        packetPool.release(dropped);
         // Insert the new packet in the correct order
         enqueue(p);
         return true;
     }
 
-    if (backPacket->tx_after) {
-        // Check if there's a non-late packet with lower priority
-        auto it = queue.end();
-        auto refPacket = *--it;
-        for (; refPacket->tx_after && it != queue.begin(); refPacket = *--it)
-            ;
-        if (!refPacket->tx_after && refPacket->priority < p->priority) {
-            LOG_WARN("Dropping non-late packet 0x%08x to make room in the TX queue for higher-priority packet 0x%08x",
-                     refPacket->id, p->id);
-            queue.erase(it);
-            packetPool.release(refPacket);
-            // Insert the new packet in the correct order
-            enqueue(p);
-            return true;
-        }
-    }
-
     // If the back packet's priority is not lower, no replacement occurs
     return false;
-}
\ No newline at end of file
+}
@@ -2,20 +2,58 @@
 
 #include "MeshTypes.h"
 
-#include <queue>
+#include <vector>
 
 /**
  * A priority queue of packets
+ *
+ * Packets live in a fixed set of entries.  A binary heap of entry numbers gives O(log n) enqueue/dequeue, ties are broken by
+ * insertion order so packets of equal rank still leave in FIFO order.  A small open-addressed (from, id) index makes find()
+ * and remove() constant time.
  */
 class MeshPacketQueue
 {
+    struct Entry {
+        meshtastic_MeshPacket *packet; // NULL if the entry is free
+        NodeNum from;                  // getFrom(packet) at the time it was queued, key of the index
+        uint32_t seq;                  // insertion order, breaks ties between packets of equal rank
+        uint16_t heapPos;              // where this entry currently sits in heap
+    };
+
+    static constexpr uint16_t NO_ENTRY = UINT16_MAX;
+
     size_t maxLen;
-    std::vector<meshtastic_MeshPacket *> queue;
+    std::vector<Entry> entries;
+    std::vector<uint16_t> freeEntries;
+    std::vector<uint16_t> heap;  // entry numbers, heap[0] is the front of the queue
+    std::vector<uint16_t> index; // (from, id) -> entry number, linear probing, at most half full
+    uint32_t indexMask = 0;
+    uint8_t indexShift = 32;
+    uint32_t nextSeq = 0;
 
     /** Replace a lower priority package in the queue with 'mp' (provided there are lower pri packages). Return true if replaced.
      */
     bool replaceLowerPriorityPacket(meshtastic_MeshPacket *mp);
 
+    /// @return true if entry a must leave the queue before entry b
+    bool before(uint16_t a, uint16_t b) const;
+
+    void siftUp(size_t pos);
+    void siftDown(size_t pos);
+
+    /// Take the entry at heap position pos out of the heap and index, free it and return its packet
+    meshtastic_MeshPacket *removeAt(size_t pos);
+
+    uint32_t indexHome(NodeNum from, PacketId id) const
+    {
+        return (uint32_t)((from * 2654435769u) ^ (id * 2246822519u)) >> indexShift;
+    }
+    void indexInsert(uint16_t e);
+    void indexErase(uint16_t e);
+
+    /// @return heap position of the first queued packet (in queue order) matching from/id and the tx window filter, or -1
+    int findPos(NodeNum from, PacketId id, bool tx_normal, bool tx_late) const;
+
   public:
     explicit MeshPacketQueue(size_t _maxLen);
 
@@ -26,7 +64,7 @@ class MeshPacketQueue
     bool empty();
 
     /** return amount of free packets in Queue */
-    size_t getFree() { return maxLen - queue.size(); }
+    size_t getFree() { return maxLen - heap.size(); }
 
     /** return total size of the Queue */
     size_t getMaxLen() { return maxLen; }
@@ -40,4 +78,4 @@ class MeshPacketQueue
 
     /* Attempt to find a packet from this queue. Return true if it was found. */
     bool find(const NodeNum from, const PacketId id);
-};
\ No newline at end of file
+};
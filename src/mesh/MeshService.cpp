@@ -18,6 +18,7 @@
 #include "modules/PositionModule.h"
 #include "modules/RoutingModule.h"
 #include "power.h"
+#include <algorithm>
 #include <assert.h>
 #include <string>
 
@@ -46,7 +47,7 @@ the new node can build its node db)
 
 MeshService *service;
 #ifdef ARDUINO_ARCH_RP2040
-CircularBuffer<char> serialLogBuffer(2000);
+LogRing serialLogBuffer(2048);
 CircularBuffer<int> powerFSMTriggerBuffer(3);
 #endif
 
@@ -109,7 +110,7 @@ int MeshService::handleFromRadio(const meshtastic_MeshPacket *mp)
     }
 
     printPacket("Forwarding to phone", mp);
-    sendToPhone(packetPool.allocCopy(*mp));
+    sendToPhone(MeshModule::keepReceived(*mp));
 
     return 0;
 }
@@ -301,6 +302,9 @@ bool MeshService::trySendPosition(NodeNum dest, bool wantReplies)
 
 void MeshService::sendToPhone(meshtastic_MeshPacket *p)
 {
+    // Decoding writes to the packet, which others may share
+    if (p->which_payload_variant != meshtastic_MeshPacket_decoded_tag)
+        p = packetPool.unshare(p);
     perhapsDecode(p);
 
 #ifdef ARCH_ESP32
@@ -314,26 +318,45 @@ void MeshService::sendToPhone(meshtastic_MeshPacket *p)
 #endif
 #endif
 
-    if (toPhoneQueue.numFree() == 0) {
+    for (auto q : clientQueues)
+        queueForPhone(*q, packetPool.share(p));
+    queueForPhone(toPhoneQueue, p);
+    fromNum++; // Notify observers, even if the packet was dropped, in case they are reconnected so they can get the packets
+}
+
+bool MeshService::queueForPhone(PointerQueue<meshtastic_MeshPacket> &q, meshtastic_MeshPacket *p)
+{
+    if (q.numFree() == 0) {
         if (p->decoded.portnum == meshtastic_PortNum_TEXT_MESSAGE_APP ||
             p->decoded.portnum == meshtastic_PortNum_RANGE_TEST_APP) {
             LOG_WARN("ToPhone queue is full, discard oldest");
-            meshtastic_MeshPacket *d = toPhoneQueue.dequeuePtr(0);
+            meshtastic_MeshPacket *d = q.dequeuePtr(0);
             if (d)
                 releaseToPool(d);
         } else {
             LOG_WARN("ToPhone queue is full, drop packet");
             releaseToPool(p);
-            fromNum++; // Make sure to notify observers in case they are reconnected so they can get the packets
-            return;
+            return false;
         }
     }
 
-    if (toPhoneQueue.enqueue(p, 0) == false) {
+    if (q.enqueue(p, 0) == false) {
         LOG_CRIT("Failed to queue a packet into toPhoneQueue!");
         abort();
     }
-    fromNum++;
+    return true;
+}
+
+void MeshService::addClientQueue(PointerQueue<meshtastic_MeshPacket> *q)
+{
+    clientQueues.push_back(q);
+}
+
+void MeshService::removeClientQueue(PointerQueue<meshtastic_MeshPacket> *q)
+{
+    clientQueues.erase(std::remove(clientQueues.begin(), clientQueues.end(), q), clientQueues.end());
+    while (meshtastic_MeshPacket *p = q->dequeuePtr(0))
+        releaseToPool(p);
 }
 
 void MeshService::sendMqttMessageToClientProxy(meshtastic_MqttClientProxyMessage *m)
@@ -399,8 +422,8 @@ meshtastic_NodeInfoLite *MeshService::refreshLocalMeshNode()
     meshtastic_PositionLite &position = node->position;
 
     // Update our local node info with our time (even if we don't decide to update anyone else)
-    node->last_heard =
-        getValidTime(RTCQualityFromNet); // This nodedb timestamp might be stale, so update it if our clock is kinda valid
+    // This nodedb timestamp might be stale, so update it if our clock is kinda valid
+    nodeDB->setLastHeard(node, getValidTime(RTCQualityFromNet), node->via_mqtt);
 
     position.time = getValidTime(RTCQualityFromNet);
 
@@ -448,7 +471,14 @@ int MeshService::onGPSChanged(const meshtastic::GPSStatus *newStatus)
 #endif
 bool MeshService::isToPhoneQueueEmpty()
 {
-    return toPhoneQueue.isEmpty();
+    // Clients with their own queue don't drain toPhoneQueue, any one of them keeping up counts as a phone that is there
+    if (toPhoneQueue.isEmpty())
+        return true;
+    for (auto q : clientQueues) {
+        if (q->isEmpty())
+            return true;
+    }
+    return false;
 }
 
 uint32_t MeshService::GetTimeSinceMeshPacket(const meshtastic_MeshPacket *mp)
@@ -3,6 +3,7 @@
 #include <Arduino.h>
 #include <assert.h>
 #include <string>
+#include <vector>
 
 #include "GPSStatus.h"
 #include "MemoryPool.h"
@@ -11,6 +12,7 @@
 #include "Observer.h"
 #include "PointerQueue.h"
 #include "CircularBuffer.h"
+#include "LogRing.h"
 #if defined(ARCH_PORTDUINO)
 #include "../platform/portduino/SimRadio.h"
 #endif
@@ -40,6 +42,9 @@ class MeshService
     /// FIXME - save this to flash on deep sleep
     PointerQueue<meshtastic_MeshPacket> toPhoneQueue;
 
+    /// Private queues of clients that are connected at the same time as others (see addClientQueue)
+    std::vector<PointerQueue<meshtastic_MeshPacket> *> clientQueues;
+
     // keep list of QueueStatus packets to be send to the phone
     PointerQueue<meshtastic_QueueStatus> toPhoneQueueStatusQueue;
 
@@ -85,6 +90,13 @@ class MeshService
     /// last few packets if needs to.
     meshtastic_MeshPacket *getForPhone() { return toPhoneQueue.dequeuePtr(0); }
 
+    /// Give a client its own share of every packet sent to the phone from now on, instead of competing for getForPhone()
+    /// with every other client.  For API servers that accept several connections at once.
+    void addClientQueue(PointerQueue<meshtastic_MeshPacket> *q);
+
+    /// Stop feeding q, releasing whatever it still holds
+    void removeClientQueue(PointerQueue<meshtastic_MeshPacket> *q);
+
     /// Allows the bluetooth handler to free packets after they have been sent
     void releaseToPool(meshtastic_MeshPacket *p) { packetPool.release(p); }
 
@@ -152,6 +164,7 @@ class MeshService
     /// Send an error response to the phone
     void sendRoutingErrorResponse(meshtastic_Routing_Error error, const meshtastic_MeshPacket *mp);
 
+    /// @return true if some phone is reading its packets as they come: toPhoneQueue, or the queue of any client with its own
     bool isToPhoneQueueEmpty();
 
     ErrorCode sendQueueStatusToPhone(const meshtastic_QueueStatus &qs, ErrorCode res, uint32_t mesh_packet_id);
@@ -167,11 +180,15 @@ class MeshService
     /// Handle a packet that just arrived from the radio.  This method does _not_ free the provided packet.  If it
     /// needs to keep the packet around, it makes a copy
     int handleFromRadio(const meshtastic_MeshPacket *p);
+
+    /// Queue p for a client, making room by dropping the oldest text message if needed
+    /// @return false if there was no room, p has been released
+    bool queueForPhone(PointerQueue<meshtastic_MeshPacket> &q, meshtastic_MeshPacket *p);
     friend class RoutingModule;
 };
 
 extern MeshService *service;
 #ifdef ARDUINO_ARCH_RP2040
-extern CircularBuffer<char> serialLogBuffer;
+extern LogRing serialLogBuffer;
 extern CircularBuffer<int> powerFSMTriggerBuffer;
 #endif
\ No newline at end of file
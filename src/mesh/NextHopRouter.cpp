@@ -5,6 +5,7 @@ NextHopRouter::NextHopRouter() {}
 PendingPacket::PendingPacket(meshtastic_MeshPacket *p, uint8_t numRetransmissions)
 {
     packet = p;
+    channel = p->channel;
     this->numRetransmissions = numRetransmissions - 1; // We subtract one, because we assume the user just did the first send
 }
 
@@ -22,8 +23,12 @@ ErrorCode NextHopRouter::send(meshtastic_MeshPacket *p)
 
     // If it's from us, ReliableRouter already handles retransmissions if want_ack is set. If a next hop is set and hop limit is
     // not 0 or want_ack is set, start retransmissions
-    if ((!isFromUs(p) || !p->want_ack) && p->next_hop != NO_NEXT_HOP_PREFERENCE && (p->hop_limit > 0 || p->want_ack))
-        startRetransmission(packetPool.allocCopy(*p)); // start retransmission for relayed packet
+    if ((!isFromUs(p) || !p->want_ack) && p->next_hop != NO_NEXT_HOP_PREFERENCE && (p->hop_limit > 0 || p->want_ack)) {
+        // start retransmission for relayed packet.  Retries are resent as they are, so give it the priority Router::send() will
+        meshtastic_MeshPacket *copy = packetPool.allocCopy(*p);
+        fixPriority(copy);
+        startRetransmission(copy);
+    }
 
     return Router::send(p);
 }
@@ -59,6 +64,16 @@ bool NextHopRouter::shouldFilterReceived(const meshtastic_MeshPacket *p)
     return Router::shouldFilterReceived(p);
 }
 
+void NextHopRouter::sniffSent(const meshtastic_MeshPacket *p)
+{
+    // Keep the encrypted packet, so retransmissions go straight to the radio instead of being encoded and encrypted again
+    PendingPacket *rec = findPendingPacket(getFrom(p), p->id);
+    if (rec && rec->packet->which_payload_variant == meshtastic_MeshPacket_decoded_tag)
+        *rec->packet = *p;
+
+    FloodingRouter::sniffSent(p);
+}
+
 void NextHopRouter::sniffReceived(const meshtastic_MeshPacket *p, const meshtastic_Routing *c)
 {
     NodeNum ourNodeNum = getNodeNum();
@@ -175,6 +190,7 @@ bool NextHopRouter::stopRetransmission(GlobalPacketId key)
                 packetPool.release(p);
             }
         }
+        retransmissions.remove(old);
         auto numErased = pending.erase(key);
         assert(numErased == 1);
         return true;
@@ -188,89 +204,94 @@ bool NextHopRouter::stopRetransmission(GlobalPacketId key)
 PendingPacket *NextHopRouter::startRetransmission(meshtastic_MeshPacket *p, uint8_t numReTx)
 {
     auto id = GlobalPacketId(p);
-    auto rec = PendingPacket(p, numReTx);
 
     stopRetransmission(getFrom(p), p->id);
 
-    setNextTx(&rec);
-    pending[id] = rec;
+    PendingPacket *rec = &pending[id];
+    *rec = PendingPacket(p, numReTx);
+    setNextTx(rec);
 
-    return &pending[id];
+    return rec;
 }
 
 /**
- * Do any retransmissions that are scheduled (FIXME - for the time being called from loop)
+ * Do any retransmissions that are due
  */
 int32_t NextHopRouter::doRetransmissions()
 {
     uint32_t now = millis();
-    int32_t d = INT32_MAX;
-
-    // FIXME, we should use a better datastructure rather than walking through this map.
-    // for(auto el: pending) {
-    for (auto it = pending.begin(), nextIt = it; it != pending.end(); it = nextIt) {
-        ++nextIt; // we use this odd pattern because we might be deleting it...
-        auto &p = it->second;
-
-        bool stillValid = true; // assume we'll keep this record around
-
-        // FIXME, handle 51 day rolloever here!!!
-        if (p.nextTxMsec <= now) {
-            if (p.numRetransmissions == 0) {
-                if (isFromUs(p.packet)) {
-                    LOG_DEBUG("Reliable send failed, returning a nak for fr=0x%x,to=0x%x,id=0x%x", p.packet->from, p.packet->to,
-                              p.packet->id);
-                    sendAckNak(meshtastic_Routing_Error_MAX_RETRANSMIT, getFrom(p.packet), p.packet->id, p.packet->channel);
-                }
-                // Note: we don't stop retransmission here, instead the Nak packet gets processed in sniffReceived
-                stopRetransmission(it->first);
-                stillValid = false; // just deleted it
-            } else {
-                LOG_DEBUG("Sending retransmission fr=0x%x,to=0x%x,id=0x%x, tries left=%d", p.packet->from, p.packet->to,
-                          p.packet->id, p.numRetransmissions);
-
-                if (!isBroadcast(p.packet->to)) {
-                    if (p.numRetransmissions == 1) {
-                        // Last retransmission, reset next_hop (fallback to FloodingRouter)
-                        p.packet->next_hop = NO_NEXT_HOP_PREFERENCE;
-                        // Also reset it in the nodeDB
-                        meshtastic_NodeInfoLite *sentTo = nodeDB->getMeshNode(p.packet->to);
-                        if (sentTo) {
-                            LOG_INFO("Resetting next hop for packet with dest 0x%x\n", p.packet->to);
-                            sentTo->next_hop = NO_NEXT_HOP_PREFERENCE;
-                        }
-                        FloodingRouter::send(packetPool.allocCopy(*p.packet));
-                    } else {
-                        NextHopRouter::send(packetPool.allocCopy(*p.packet));
+
+    // Only the records that are due come out of the queue, setNextTx() puts back the ones we retransmit
+    while (PendingPacket *due = retransmissions.popDue(now)) {
+        auto &p = *due;
+
+        if (p.numRetransmissions == 0) {
+            if (isFromUs(p.packet)) {
+                LOG_DEBUG("Reliable send failed, returning a nak for fr=0x%x,to=0x%x,id=0x%x", p.packet->from, p.packet->to,
+                          p.packet->id);
+                sendAckNak(meshtastic_Routing_Error_MAX_RETRANSMIT, getFrom(p.packet), p.packet->id, p.channel);
+            }
+            // Note: we don't stop retransmission here, instead the Nak packet gets processed in sniffReceived
+            stopRetransmission(GlobalPacketId(p.packet));
+        } else {
+            LOG_DEBUG("Sending retransmission fr=0x%x,to=0x%x,id=0x%x, tries left=%d", p.packet->from, p.packet->to,
+                      p.packet->id, p.numRetransmissions);
+
+            if (!isBroadcast(p.packet->to)) {
+                if (p.numRetransmissions == 1) {
+                    // Last retransmission, reset next_hop (fallback to FloodingRouter)
+                    // Also reset it in the nodeDB
+                    meshtastic_NodeInfoLite *sentTo = nodeDB->getMeshNode(p.packet->to);
+                    if (sentTo) {
+                        LOG_INFO("Resetting next hop for packet with dest 0x%x\n", p.packet->to);
+                        sentTo->next_hop = NO_NEXT_HOP_PREFERENCE;
                     }
+                    sendRetransmission(p, NO_NEXT_HOP_PREFERENCE);
                 } else {
-                    // Note: we call the superclass version because we don't want to have our version of send() add a new
-                    // retransmission record
-                    FloodingRouter::send(packetPool.allocCopy(*p.packet));
+                    sendRetransmission(p, getNextHop(p.packet->to, p.packet->relay_node));
                 }
-
-                // Queue again
-                --p.numRetransmissions;
-                setNextTx(&p);
+            } else {
+                sendRetransmission(p, p.packet->next_hop);
             }
+
+            // Queue again
+            --p.numRetransmissions;
+            setNextTx(&p);
         }
+    }
 
-        if (stillValid) {
-            // Update our desired sleep delay
-            int32_t t = p.nextTxMsec - now;
+    return retransmissions.msecUntilNext(now);
+}
 
-            d = min(t, d);
-        }
+void NextHopRouter::sendRetransmission(PendingPacket &p, uint8_t nextHop)
+{
+    if (p.packet->which_payload_variant == meshtastic_MeshPacket_decoded_tag) {
+        // The first try never got as far as the radio (duty cycle, encoding failed), so there is no on-air form to resend yet.
+        // A copy takes the full send(), whose sniffSent() then hands us the encrypted packet.
+        meshtastic_MeshPacket *copy = packetPool.allocCopy(*p.packet);
+        copy->next_hop = nextHop;
+        FloodingRouter::send(copy); // not our send(), it would start another retransmission record
+        return;
+    }
+
+    // A previous try may still wait in the tx queue, sharing the packet.  So a new next hop goes into a copy, which then
+    // becomes the pending packet.
+    if (p.packet->next_hop != nextHop) {
+        p.packet = packetPool.unshare(p.packet);
+        p.packet->next_hop = nextHop;
+        LOG_DEBUG("Setting next hop for packet with dest %x to %x", p.packet->to, nextHop);
     }
 
-    return d;
+    // Like send() does, but the relayer and everything else it would set is already set since the first try
+    wasSeenRecently(p.packet); // FIXME, move this to a sniffSent method
+    resend(packetPool.share(p.packet));
 }
 
 void NextHopRouter::setNextTx(PendingPacket *pending)
 {
     assert(iface);
     auto d = iface->getRetransmissionMsec(pending->packet);
-    pending->nextTxMsec = millis() + d;
+    retransmissions.schedule(pending, d, millis());
     LOG_DEBUG("Setting next retransmission in %u msecs: ", d);
     printPacket("", pending->packet);
     setReceivedMessage(); // Run ASAP, so we can figure out our correct sleep time
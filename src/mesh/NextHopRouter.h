@@ -1,6 +1,7 @@
 #pragma once
 
 #include "FloodingRouter.h"
+#include "RetransmissionQueue.h"
 #include <unordered_map>
 
 /**
@@ -26,22 +27,6 @@ struct GlobalPacketId {
     }
 };
 
-/**
- * A packet queued for retransmission
- */
-struct PendingPacket {
-    meshtastic_MeshPacket *packet;
-
-    /** The next time we should try to retransmit this packet */
-    uint32_t nextTxMsec = 0;
-
-    /** Starts at NUM_RETRANSMISSIONS -1 and counts down.  Once zero it will be removed from the list */
-    uint8_t numRetransmissions = 0;
-
-    PendingPacket() {}
-    explicit PendingPacket(meshtastic_MeshPacket *p, uint8_t numRetransmissions);
-};
-
 class GlobalPacketIdHashFunction
 {
   public:
@@ -97,6 +82,11 @@ class NextHopRouter : public FloodingRouter
      */
     std::unordered_map<GlobalPacketId, PendingPacket, GlobalPacketIdHashFunction> pending;
 
+    /**
+     * Deadlines of the packets in pending
+     */
+    RetransmissionQueue retransmissions;
+
     /**
      * Should this incoming filter be dropped?
      *
@@ -105,6 +95,11 @@ class NextHopRouter : public FloodingRouter
      */
     virtual bool shouldFilterReceived(const meshtastic_MeshPacket *p) override;
 
+    /**
+     * Remember the on-air form of packets we will retransmit
+     */
+    virtual void sniffSent(const meshtastic_MeshPacket *p) override;
+
     /**
      * Look for packets we need to relay
      */
@@ -130,7 +125,7 @@ class NextHopRouter : public FloodingRouter
     bool stopRetransmission(GlobalPacketId p);
 
     /**
-     * Do any retransmissions that are scheduled (FIXME - for the time being called from loop)
+     * Do any retransmissions that are due
      *
      * @return the number of msecs until our next retransmission or MAXINT if none scheduled
      */
@@ -138,6 +133,11 @@ class NextHopRouter : public FloodingRouter
 
     void setNextTx(PendingPacket *pending);
 
+    /**
+     * Put the next try of a pending packet on the air, handing the tx queue a share of it rather than a copy
+     */
+    void sendRetransmission(PendingPacket &p, uint8_t nextHop);
+
   private:
     /**
      * Get the next hop for a destination, given the relay node
@@ -0,0 +1,27 @@
+#include "NodeChangeTracker.h"
+
+#include <algorithm>
+
+void NodeChangeTracker::seed(uint16_t newEpoch)
+{
+    epoch = newEpoch & EPOCH_MASK;
+    generation = 0;
+    std::fill(changed.begin(), changed.end(), 0);
+}
+
+void NodeChangeTracker::touch(size_t pos)
+{
+    if (generation == UINT16_MAX)
+        reset(); // Out of generations, tokens from before the wrap would see the wrong nodes
+    if (pos >= changed.size())
+        changed.resize(pos + 1, 0);
+    changed[pos] = ++generation;
+}
+
+bool NodeChangeTracker::accept(uint32_t token, Generation &since) const
+{
+    if (!isToken(token) || ((token >> 16) & EPOCH_MASK) != epoch || (Generation)token > generation)
+        return false;
+    since = (Generation)token;
+    return true;
+}
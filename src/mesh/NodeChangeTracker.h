@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Remembers when each NodeDB record last changed, so a client that reconnects only needs the nodes changed since it last
+ * synced instead of the whole node list.
+ *
+ * Every change takes the next value of a 16 bit generation counter and stores it in the changed record's slot (slots are
+ * positions in the NodeDB meshNodes array, 2 bytes each).  A client is handed a sync token: the current generation in the low
+ * half, an epoch and a marker in the high half.  Handing the token back later asks for the records changed after that
+ * generation.
+ *
+ * Clients pick want_config_id nonces themselves, so only values carrying TOKEN_MARKER in their top bits are ever looked at as
+ * tokens; every other nonce (including the SPECIAL_NONCE_* values) is an ordinary one.  A client opts in by asking for a sync
+ * with SPECIAL_NONCE_NODES_SYNC and presenting the token it got back.
+ *
+ * Removals and bulk moves of records can't be described as "changed nodes", and the generation counter eventually wraps.
+ * Both start a new epoch, which invalidates every token issued so far, so those clients fall back to a full sync.  The first
+ * epoch should be random so tokens from before a reboot are not mistaken for current ones.
+ */
+class NodeChangeTracker
+{
+  public:
+    typedef uint16_t Generation;
+
+    /// The top 4 bits of every token, want_config_id values without it are never taken for tokens
+    static constexpr uint32_t TOKEN_MARKER = 0xa0000000;
+    static constexpr uint32_t TOKEN_MARKER_MASK = 0xf0000000;
+    /// Epochs are the 12 bits between the marker and the generation
+    static constexpr uint16_t EPOCH_MASK = 0x0fff;
+
+    /// @return true if value is in the range reserved for sync tokens (which doesn't mean it is a current one)
+    static bool isToken(uint32_t value) { return (value & TOKEN_MARKER_MASK) == TOKEN_MARKER; }
+
+    /// Forget everything and start at epoch (only its low 12 bits are used)
+    void seed(uint16_t epoch);
+
+    /// Record that the node at pos changed
+    void touch(size_t pos);
+
+    /// Records were removed or shuffled: forget all changes and start a new epoch
+    void reset() { seed(epoch + 1); }
+
+    /// @return the token a client should present next time to get only the nodes changed from now on
+    uint32_t getToken() const { return TOKEN_MARKER | ((uint32_t)epoch << 16) | generation; }
+
+    /// @param since receives the generation the client is up to date with
+    /// @return true if token is a sync token issued in the current epoch
+    bool accept(uint32_t token, Generation &since) const;
+
+    /// @return true if the node at pos changed after generation since
+    bool changedSince(size_t pos, Generation since) const { return pos < changed.size() && changed[pos] > since; }
+
+  private:
+    std::vector<Generation> changed; // by position in meshNodes, grown on demand
+    uint16_t epoch = 0;
+    Generation generation = 0;
+};
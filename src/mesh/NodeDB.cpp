@@ -10,7 +10,9 @@
 #include "MeshRadio.h"
 #include "MeshService.h"
 #include "NodeDB.h"
+#include "NodeDBJournal.h"
 #include "PacketHistory.h"
+#include "PbFileStream.h"
 #include "PowerFSM.h"
 #include "RTC.h"
 #include "Router.h"
@@ -194,6 +196,7 @@ static uint8_t ourMacAddr[6];
 NodeDB::NodeDB()
 {
     LOG_INFO("Init NodeDB");
+    changes.seed(random(0, 0x1000)); // so sync tokens from before a reboot are (almost certainly) refused
     loadFromDisk();
     cleanupMeshDB();
 
@@ -296,6 +299,7 @@ NodeDB::NodeDB()
     meshtastic_NodeInfoLite *info = getOrCreateMeshNode(getNodeNum());
     info->user = TypeConversions::ConvertToUserLite(owner);
     info->has_user = true;
+    nodeChanged(info);
 
     // If node database has not been saved for the first time, save it now
 #ifdef FSCom
@@ -482,6 +486,9 @@ bool NodeDB::factoryReset(bool eraseBleBonds)
     // first, remove the "/prefs" (this removes most prefs)
     spiLock->lock();
     rmDir("/prefs"); // this uses spilock internally...
+#if ARCH_PORTDUINO
+    nodeMap.close(); // Its file is gone, the next boot starts a new one
+#endif
 
 #ifdef FSCom
     if (FSCom.exists("/static/rangetest.csv") && !FSCom.remove("/static/rangetest.csv")) {
@@ -521,6 +528,7 @@ void NodeDB::installDefaultNodeDatabase()
     nodeDatabase.nodes = std::vector<meshtastic_NodeInfoLite>(MAX_NUM_NODES);
     numMeshNodes = 0;
     meshNodes = &nodeDatabase.nodes;
+    rebuildNodeIndexes();
 }
 
 void NodeDB::installDefaultConfig(bool preserveKey = false)
@@ -986,8 +994,13 @@ void NodeDB::resetNodes()
 {
     if (!config.position.fixed_position)
         clearLocalPosition();
+    // Records are not kept sorted, so make sure our own node is the one that survives in slot 0
+    int self = nodeIndex.find(*meshNodes, getNodeNum());
+    if (self > 0)
+        std::swap(meshNodes->at(0), meshNodes->at(self));
     numMeshNodes = 1;
     std::fill(nodeDatabase.nodes.begin() + 1, nodeDatabase.nodes.end(), meshtastic_NodeInfoLite());
+    rebuildNodeIndexes();
     devicestate.has_rx_text_message = false;
     devicestate.has_rx_waypoint = false;
     saveNodeDatabaseToDisk();
@@ -1008,8 +1021,9 @@ void NodeDB::removeNodeByNum(NodeNum nodeNum)
     numMeshNodes -= removed;
     std::fill(nodeDatabase.nodes.begin() + numMeshNodes, nodeDatabase.nodes.begin() + numMeshNodes + 1,
               meshtastic_NodeInfoLite());
+    rebuildNodeIndexes();
     LOG_DEBUG("NodeDB::removeNodeByNum purged %d entries. Save changes", removed);
-    saveNodeDatabaseToDisk();
+    saveNodeToDisk(nodeNum);
 }
 
 void NodeDB::clearLocalPosition()
@@ -1019,6 +1033,7 @@ void NodeDB::clearLocalPosition()
     node->position.longitude_i = 0;
     node->position.altitude = 0;
     node->position.time = 0;
+    nodeChanged(node);
     setLocalPosition(meshtastic_Position_init_default);
 }
 
@@ -1043,6 +1058,7 @@ void NodeDB::cleanupMeshDB()
     numMeshNodes -= removed;
     std::fill(nodeDatabase.nodes.begin() + numMeshNodes, nodeDatabase.nodes.begin() + numMeshNodes + removed,
               meshtastic_NodeInfoLite());
+    rebuildNodeIndexes();
     LOG_DEBUG("cleanupMeshDB purged %d entries", removed);
 }
 
@@ -1111,7 +1127,7 @@ void NodeDB::pickNewNodeNum()
 
 /** Load a protobuf from a file, return LoadFileResult */
 LoadFileResult NodeDB::loadProto(const char *filename, size_t protoSize, size_t objSize, const pb_msgdesc_t *fields,
-                                 void *dest_struct)
+                                 void *dest_struct, uint32_t *crc)
 {
     LoadFileResult state = LoadFileResult::OTHER_FAILURE;
 #ifdef FSCom
@@ -1121,15 +1137,17 @@ LoadFileResult NodeDB::loadProto(const char *filename, size_t protoSize, size_t
 
     if (f) {
         LOG_INFO("Load %s", filename);
-        pb_istream_t stream = {&readcb, &f, protoSize};
+        PbFileReader reader(f, protoSize);
         if (fields != &meshtastic_NodeDatabase_msg) // contains a vector object
             memset(dest_struct, 0, objSize);
-        if (!pb_decode(&stream, fields, dest_struct)) {
-            LOG_ERROR("Error: can't decode protobuf %s", PB_GET_ERROR(&stream));
+        if (!pb_decode(&reader.stream, fields, dest_struct)) {
+            LOG_ERROR("Error: can't decode protobuf %s", PB_GET_ERROR(&reader.stream));
             state = LoadFileResult::DECODE_FAILED;
         } else {
             LOG_INFO("Loaded %s successfully", filename);
             state = LoadFileResult::LOAD_SUCCESS;
+            if (crc)
+                *crc = reader.getCrc();
         }
         f.close();
     } else {
@@ -1176,22 +1194,55 @@ void NodeDB::loadFromDisk()
     }
 
 #endif
-    auto state = loadProto(nodeDatabaseFileName, getMaxNodesAllocatedSize(), sizeof(meshtastic_NodeDatabase),
-                           &meshtastic_NodeDatabase_msg, &nodeDatabase);
-    if (nodeDatabase.version < DEVICESTATE_MIN_VER) {
-        LOG_WARN("NodeDatabase %d is old, discard", nodeDatabase.version);
-        installDefaultNodeDatabase();
-    } else {
-        meshNodes = &nodeDatabase.nodes;
-        numMeshNodes = nodeDatabase.nodes.size();
-        LOG_INFO("Loaded saved nodedatabase version %d, with nodes count: %d", nodeDatabase.version, nodeDatabase.nodes.size());
-    }
+    LoadFileResult state;
+    if (!loadMappedNodeDatabase()) {
+        // The journal header names the snapshot it was written against by the CRC32 of the file
+        uint32_t nodeDatabaseCrc = 0;
+        state = loadProto(nodeDatabaseFileName, getMaxNodesAllocatedSize(), sizeof(meshtastic_NodeDatabase),
+                          &meshtastic_NodeDatabase_msg, &nodeDatabase, &nodeDatabaseCrc);
+        if (nodeDatabase.version < DEVICESTATE_MIN_VER) {
+            LOG_WARN("NodeDatabase %d is old, discard", nodeDatabase.version);
+            installDefaultNodeDatabase();
+        } else {
+            meshNodes = &nodeDatabase.nodes;
+            numMeshNodes = nodeDatabase.nodes.size();
+            LOG_INFO("Loaded saved nodedatabase version %d, with nodes count: %d", nodeDatabase.version,
+                     nodeDatabase.nodes.size());
+        }
 
-    if (numMeshNodes > MAX_NUM_NODES) {
-        LOG_WARN("Node count %d exceeds MAX_NUM_NODES %d, truncating", numMeshNodes, MAX_NUM_NODES);
-        numMeshNodes = MAX_NUM_NODES;
+        if (numMeshNodes > MAX_NUM_NODES) {
+            LOG_WARN("Node count %d exceeds MAX_NUM_NODES %d, truncating", numMeshNodes, MAX_NUM_NODES);
+            numMeshNodes = MAX_NUM_NODES;
+        }
+        meshNodes->resize(MAX_NUM_NODES);
+        rebuildNodeIndexes();
+
+        // Apply single node changes saved after the snapshot
+        // (Without a usable snapshot the journal stays unusable too, the next node change then does a full save)
+        if (state == LoadFileResult::LOAD_SUCCESS && nodeDatabase.version >= DEVICESTATE_MIN_VER) {
+            bool journalClean = journal.replay(
+                nodeDatabaseCrc,
+                [this](const meshtastic_NodeInfoLite &node) {
+                    int pos = nodeIndex.find(*meshNodes, node.num);
+                    meshtastic_NodeInfoLite *lite = pos >= 0 ? &meshNodes->at(pos) : getOrCreateMeshNode(node.num);
+                    *lite = node;
+                },
+                [this](NodeNum n) {
+                    int pos = nodeIndex.find(*meshNodes, n);
+                    if (pos >= 0)
+                        evictMeshNode(pos);
+                });
+            rebuildNodeIndexes(); // last_heard and favorites changed behind the back of the node list and online count
+            if (!journalClean)
+                saveNodeDatabaseToDisk();
+        }
+
+#if ARCH_PORTDUINO
+        // First start with a node map: fill it from nodes.proto
+        if (nodeMap.isOpen())
+            saveNodeDatabaseToDisk();
+#endif
     }
-    meshNodes->resize(MAX_NUM_NODES);
 
     // static DeviceState scratch; We no longer read into a tempbuf because this structure is 15KB of valuable RAM
     state = loadProto(deviceStateFileName, meshtastic_DeviceState_size, sizeof(meshtastic_DeviceState),
@@ -1343,19 +1394,21 @@ void NodeDB::loadFromDisk()
 
 /** Save a protobuf from a file, return true for success */
 bool NodeDB::saveProto(const char *filename, size_t protoSize, const pb_msgdesc_t *fields, const void *dest_struct,
-                       bool fullAtomic)
+                       bool fullAtomic, uint32_t *crc)
 {
     bool okay = false;
 #ifdef FSCom
     auto f = SafeFile(filename, fullAtomic);
 
     LOG_INFO("Save %s", filename);
-    pb_ostream_t stream = {&writecb, static_cast<Print *>(&f), protoSize};
+    PbFileWriter writer(f, protoSize);
 
-    if (!pb_encode(&stream, fields, dest_struct)) {
-        LOG_ERROR("Error: can't encode protobuf %s", PB_GET_ERROR(&stream));
+    if (!pb_encode(&writer.stream, fields, dest_struct)) {
+        LOG_ERROR("Error: can't encode protobuf %s", PB_GET_ERROR(&writer.stream));
     } else {
-        okay = true;
+        okay = writer.flush();
+        if (crc)
+            *crc = writer.getCrc();
     }
 
     bool writeSucceeded = f.close();
@@ -1391,8 +1444,41 @@ bool NodeDB::saveDeviceStateToDisk()
     return saveProto(deviceStateFileName, meshtastic_DeviceState_size, &meshtastic_DeviceState_msg, &devicestate, true);
 }
 
+bool NodeDB::loadMappedNodeDatabase()
+{
+#if ARCH_PORTDUINO
+    if (!settingsMap[nodedb_mmap])
+        return false;
+
+    spiLock->lock();
+    FSCom.mkdir("/prefs");
+    spiLock->unlock();
+    std::string path = std::string(portduinoVFS->mountpoint()) + nodeMapFileName;
+    if (!nodeMap.open(path.c_str(), MAX_NUM_NODES))
+        return false;
+
+    nodeDatabase.nodes = std::vector<meshtastic_NodeInfoLite>(MAX_NUM_NODES);
+    int count = nodeMap.load(nodeDatabase.nodes, nodeDatabase.version);
+    if (count < 0 || nodeDatabase.version < DEVICESTATE_MIN_VER) {
+        LOG_INFO("Node map %s is new or old, load %s", nodeMapFileName, nodeDatabaseFileName);
+        return false;
+    }
+    meshNodes = &nodeDatabase.nodes;
+    numMeshNodes = count;
+    rebuildNodeIndexes();
+    LOG_INFO("Loaded node map version %d, with nodes count: %d", nodeDatabase.version, numMeshNodes);
+    return true;
+#else
+    return false;
+#endif
+}
+
 bool NodeDB::saveNodeDatabaseToDisk()
 {
+#if ARCH_PORTDUINO
+    if (nodeMap.isOpen())
+        return nodeMap.save(*meshNodes, numMeshNodes, nodeDatabase.version);
+#endif
 #ifdef FSCom
     spiLock->lock();
     FSCom.mkdir("/prefs");
@@ -1400,7 +1486,30 @@ bool NodeDB::saveNodeDatabaseToDisk()
 #endif
     size_t nodeDatabaseSize;
     pb_get_encoded_size(&nodeDatabaseSize, meshtastic_NodeDatabase_fields, &nodeDatabase);
-    return saveProto(nodeDatabaseFileName, nodeDatabaseSize, &meshtastic_NodeDatabase_msg, &nodeDatabase, false);
+    uint32_t nodeDatabaseCrc;
+    if (!saveProto(nodeDatabaseFileName, nodeDatabaseSize, &meshtastic_NodeDatabase_msg, &nodeDatabase, false,
+                   &nodeDatabaseCrc))
+        return false;
+
+    // The snapshot now holds everything the journal did
+    LOG_INFO("Saved full node database, %u bytes (folded %u journal bytes)", (uint32_t)nodeDatabaseSize, journal.getSize());
+    journal.reset(nodeDatabaseCrc);
+    return true;
+}
+
+bool NodeDB::saveNodeToDisk(NodeNum n)
+{
+#if ARCH_PORTDUINO
+    if (nodeMap.isOpen()) // Only the changed records get written anyway
+        return saveNodeDatabaseToDisk();
+#endif
+    if (!journal.needsCompaction()) {
+        const meshtastic_NodeInfoLite *node = getMeshNode(n);
+        if (node ? journal.appendNode(*node) : journal.appendRemove(n))
+            return true;
+        LOG_WARN("Can't journal node 0x%x, save full node database", n);
+    }
+    return saveNodeDatabaseToDisk();
 }
 
 bool NodeDB::saveToDiskNoRetry(int saveWhat)
@@ -1482,7 +1591,7 @@ bool NodeDB::saveToDisk(int saveWhat)
 const meshtastic_NodeInfoLite *NodeDB::readNextMeshNode(uint32_t &readIndex)
 {
     if (readIndex < numMeshNodes)
-        return &meshNodes->at(readIndex++);
+        return getMeshNodeByIndex(readIndex++);
     else
         return NULL;
 }
@@ -1510,25 +1619,43 @@ uint32_t sinceReceived(const meshtastic_MeshPacket *p)
     return delta;
 }
 
-#define NUM_ONLINE_SECS (60 * 60 * 2) // 2 hrs to consider someone offline
-
 size_t NodeDB::getNumOnlineMeshNodes(bool localOnly)
 {
-    size_t numseen = 0;
-
-    // FIXME this implementation is kinda expensive
-    for (int i = 0; i < numMeshNodes; i++) {
-        if (localOnly && meshNodes->at(i).via_mqtt)
-            continue;
-        if (sinceLastSeen(&meshNodes->at(i)) < NUM_ONLINE_SECS)
-            numseen++;
+    uint32_t now = getTime();
+    size_t numseen = onlineNodes.getNumOnline(localOnly, now);
+    if (onlineNodes.needsRecount()) {
+        LOG_DEBUG("Clock went backwards, recount online nodes");
+        recountOnlineNodes();
+        numseen = onlineNodes.getNumOnline(localOnly, now);
     }
 
     return numseen;
 }
 
+void NodeDB::recountOnlineNodes()
+{
+    uint32_t now = getTime();
+    onlineNodes.clear(now);
+    for (size_t i = 0; i < numMeshNodes; i++)
+        onlineNodes.add(meshNodes->at(i).last_heard, meshNodes->at(i).via_mqtt, now);
+}
+
+void NodeDB::setLastHeard(meshtastic_NodeInfoLite *node, uint32_t lastHeard, bool viaMqtt)
+{
+    if (node->last_heard == lastHeard && node->via_mqtt == viaMqtt)
+        return;
+
+    uint32_t now = getTime();
+    onlineNodes.remove(node->last_heard, node->via_mqtt, now);
+    bool reorder = node->last_heard != lastHeard;
+    node->last_heard = lastHeard;
+    node->via_mqtt = viaMqtt;
+    onlineNodes.add(node->last_heard, node->via_mqtt, now);
+    if (reorder)
+        nodeOrderChanged(node);
+}
+
 #include "MeshModule.h"
-#include "Throttle.h"
 
 /** Update position info for this node based on received position data
  */
@@ -1570,6 +1697,7 @@ void NodeDB::updatePosition(uint32_t nodeId, const meshtastic_Position &p, RxSou
             info->position.time = tmp_time;
     }
     info->has_position = true;
+    nodeChanged(info);
     updateGUIforNode = info;
     notifyObservers(true); // Force an update whether or not our node counts have changed
 }
@@ -1593,6 +1721,7 @@ void NodeDB::updateTelemetry(uint32_t nodeId, const meshtastic_Telemetry &t, RxS
     }
     info->device_metrics = t.variant.device_metrics;
     info->has_device_metrics = true;
+    nodeChanged(info);
     updateGUIforNode = info;
     notifyObservers(true); // Force an update whether or not our node counts have changed
 }
@@ -1617,17 +1746,19 @@ void NodeDB::addFromContact(meshtastic_SharedContact contact)
         info->has_position = false;
         info->user.public_key.size = 0;
         info->user.public_key.bytes[0] = 0;
+        nodeChanged(info);
     } else {
-        info->last_heard = getValidTime(RTCQualityNTP);
         info->is_favorite = true;
         info->bitfield |= NODEINFO_BITFIELD_IS_KEY_MANUALLY_VERIFIED_MASK;
         // Mark the node's key as manually verified to indicate trustworthiness.
         updateGUIforNode = info;
         // powerFSM.trigger(EVENT_NODEDB_UPDATED); This event has been retired
-        sortMeshDB();
+        setLastHeard(info, getValidTime(RTCQualityNTP), info->via_mqtt);
+        nodeOrderChanged(info); // is_favorite may have changed even if last_heard did not
+        nodeChanged(info);
         notifyObservers(true); // Force an update whether or not our node counts have changed
     }
-    saveNodeDatabaseToDisk();
+    saveNodeToDisk(contact.node_num);
 }
 
 /** Update user info and channel for this node based on received user data
@@ -1690,18 +1821,12 @@ bool NodeDB::updateUser(uint32_t nodeId, meshtastic_User &p, uint8_t channelInde
     info->has_user = true;
 
     if (changed) {
+        nodeChanged(info);
         updateGUIforNode = info;
         notifyObservers(true); // Force an update whether or not our node counts have changed
 
-        // We just changed something about a User,
-        // store our DB unless we just did so less than a minute ago
-
-        if (!Throttle::isWithinTimespanMs(lastNodeDbSave, ONE_MINUTE_MS)) {
-            saveToDisk(SEGMENT_NODEDATABASE);
-            lastNodeDbSave = millis();
-        } else {
-            LOG_DEBUG("Defer NodeDB saveToDisk for now");
-        }
+        // We just changed something about a User, journaling just this node is cheap enough to do every time
+        saveNodeToDisk(nodeId);
     }
 
     return changed;
@@ -1723,20 +1848,18 @@ void NodeDB::updateFrom(const meshtastic_MeshPacket &mp)
             return;
         }
 
-        if (mp.rx_time) // if the packet has a valid timestamp use it to update our last_heard
-            info->last_heard = mp.rx_time;
+        // if the packet has a valid timestamp use it to update our last_heard, and store if we received it via MQTT
+        setLastHeard(info, mp.rx_time ? mp.rx_time : info->last_heard, mp.via_mqtt);
 
         if (mp.rx_snr)
             info->snr = mp.rx_snr; // keep the most recent SNR we received for this node.
 
-        info->via_mqtt = mp.via_mqtt; // Store if we received this packet via MQTT
-
         // If hopStart was set and there wasn't someone messing with the limit in the middle, add hopsAway
         if (mp.hop_start != 0 && mp.hop_limit <= mp.hop_start) {
             info->has_hops_away = true;
             info->hops_away = mp.hop_start - mp.hop_limit;
         }
-        sortMeshDB();
+        nodeChanged(info);
     }
 }
 
@@ -1745,44 +1868,138 @@ void NodeDB::set_favorite(bool is_favorite, uint32_t nodeId)
     meshtastic_NodeInfoLite *lite = getMeshNode(nodeId);
     if (lite && lite->is_favorite != is_favorite) {
         lite->is_favorite = is_favorite;
-        sortMeshDB();
-        saveNodeDatabaseToDisk();
+        nodeOrderChanged(lite);
+        nodeChanged(lite);
+        saveNodeToDisk(nodeId);
     }
 }
 
 void NodeDB::pause_sort(bool paused)
 {
     sortingIsPaused = paused;
+    if (!paused && nodeOrderDirty)
+        sortMeshDB();
+}
+
+bool NodeDB::nodeOrderBefore(size_t a, size_t b)
+{
+    const meshtastic_NodeInfoLite &na = meshNodes->at(a), &nb = meshNodes->at(b);
+    NodeNum us = getNodeNum();
+    if ((na.num == us) != (nb.num == us))
+        return na.num == us; // our own node is always first
+    if (na.is_favorite != nb.is_favorite)
+        return na.is_favorite;
+    if (na.last_heard != nb.last_heard)
+        return na.last_heard > nb.last_heard;
+    return a < b; // keep the order deterministic
+}
+
+void NodeDB::rebuildNodeIndexes()
+{
+    nodeIndex.rebuild(*meshNodes, numMeshNodes);
+    nodeOrder.resize(numMeshNodes);
+    for (size_t i = 0; i < numMeshNodes; i++)
+        nodeOrder[i] = i;
+    nodeOrderDirty = true;
+    sortMeshDB();
+    recountOnlineNodes();
+    changes.reset(); // records moved, and clients can't be told about removed nodes
 }
 
 void NodeDB::sortMeshDB()
 {
-    if (!sortingIsPaused && (lastSort == 0 || !Throttle::isWithinTimespanMs(lastSort, 1000 * 5))) {
-        lastSort = millis();
-        bool changed = true;
-        while (changed) { // dumb reverse bubble sort, but probably not bad for what we're doing
-            changed = false;
-            for (int i = numMeshNodes - 1; i > 0; i--) { // lowest case this should examine is i == 1
-                if (meshNodes->at(i - 1).num == getNodeNum()) {
-                    // noop
-                } else if (meshNodes->at(i).num ==
-                           getNodeNum()) { // in the oddball case our own node num is not at location 0, put it there
-                    // TODO: Look for at(i-1) also matching own node num, and throw the DB in the trash
-                    std::swap(meshNodes->at(i), meshNodes->at(i - 1));
-                    changed = true;
-                } else if (meshNodes->at(i).is_favorite && !meshNodes->at(i - 1).is_favorite) {
-                    std::swap(meshNodes->at(i), meshNodes->at(i - 1));
-                    changed = true;
-                } else if (!meshNodes->at(i).is_favorite && meshNodes->at(i - 1).is_favorite) {
-                    // noop
-                } else if (meshNodes->at(i).last_heard > meshNodes->at(i - 1).last_heard) {
-                    std::swap(meshNodes->at(i), meshNodes->at(i - 1));
-                    changed = true;
-                }
-            }
+    if (sortingIsPaused)
+        return;
+    std::sort(nodeOrder.begin(), nodeOrder.end(), [this](size_t a, size_t b) { return nodeOrderBefore(a, b); });
+    nodeOrderDirty = false;
+}
+
+void NodeDB::nodeOrderChanged(const meshtastic_NodeInfoLite *node)
+{
+    if (sortingIsPaused) {
+        nodeOrderDirty = true;
+        return;
+    }
+
+    size_t pos = node - meshNodes->data();
+    auto it = std::find(nodeOrder.begin(), nodeOrder.end(), pos);
+    if (it == nodeOrder.end())
+        return;
+
+    // Take the node out and binary search its new place, the rest of the list is still in order
+    nodeOrder.erase(it);
+    auto to = std::upper_bound(nodeOrder.begin(), nodeOrder.end(), pos,
+                               [this](size_t a, size_t b) { return nodeOrderBefore(a, b); });
+    nodeOrder.insert(to, pos);
+}
+
+int NodeDB::findEvictionCandidate()
+{
+    // Walk the node list from the back.  While it is in order that visits non-favorites by ascending last_heard, so the first
+    // "boring" node found is the oldest one and favorites mark the end of the candidates.  While sorting is paused the order
+    // may be stale and we have to look at every node.
+    bool sorted = !nodeOrderDirty;
+    uint32_t oldest = UINT32_MAX;
+    uint32_t oldestBoring = UINT32_MAX;
+    int oldestIndex = -1;
+    int oldestBoringIndex = -1;
+    for (size_t i = nodeOrder.size(); i-- > 0;) {
+        const meshtastic_NodeInfoLite &node = meshNodes->at(nodeOrder[i]);
+        if (node.num == getNodeNum())
+            continue; // never evict ourselves
+        if (node.is_favorite) {
+            if (sorted)
+                break;
+            continue;
+        }
+        if (node.is_ignored)
+            continue;
+        // Simply the oldest non-favorite, non-ignored, non-verified node
+        if (!(node.bitfield & NODEINFO_BITFIELD_IS_KEY_MANUALLY_VERIFIED_MASK) && node.last_heard < oldest) {
+            oldest = node.last_heard;
+            oldestIndex = nodeOrder[i];
+        }
+        // The oldest "boring" node
+        if (node.user.public_key.size == 0 && node.last_heard < oldestBoring) {
+            oldestBoring = node.last_heard;
+            oldestBoringIndex = nodeOrder[i];
+            if (sorted)
+                break;
         }
-        LOG_INFO("Sort took %u milliseconds", millis() - lastSort);
     }
+    // if we found a "boring" node, evict it
+    return oldestBoringIndex != -1 ? oldestBoringIndex : oldestIndex;
+}
+
+void NodeDB::evictMeshNode(size_t pos)
+{
+    size_t last = numMeshNodes - 1;
+    meshtastic_NodeInfoLite &victim = meshNodes->at(pos);
+    onlineNodes.remove(victim.last_heard, victim.via_mqtt, getTime());
+    nodeIndex.erase(*meshNodes, victim.num);
+    nodeOrder.erase(std::find(nodeOrder.begin(), nodeOrder.end(), pos));
+
+    // Fill the hole with the last record rather than shoving everything after it down the chain
+    if (pos != last) {
+        meshNodes->at(pos) = meshNodes->at(last);
+        nodeIndex.insert(*meshNodes, pos);
+        nodeOrder.erase(std::find(nodeOrder.begin(), nodeOrder.end(), last));
+        if (sortingIsPaused) {
+            nodeOrder.push_back(pos);
+            nodeOrderDirty = true;
+        } else {
+            // Ties in the list are broken by position, so the moved node may need a new place
+            auto to = std::upper_bound(nodeOrder.begin(), nodeOrder.end(), pos,
+                                       [this](size_t a, size_t b) { return nodeOrderBefore(a, b); });
+            nodeOrder.insert(to, pos);
+        }
+    }
+    meshNodes->at(last) = meshtastic_NodeInfoLite();
+    numMeshNodes--;
+    // Syncing clients keep their copy of the victim, like phones keep nodes we dropped while they were away.  The slot now
+    // holds another node though, so it counts as changed (the emptied last slot is touched when it is filled again).
+    if (pos != last)
+        changes.touch(pos);
 }
 
 uint8_t NodeDB::getMeshNodeChannel(NodeNum n)
@@ -1798,9 +2015,9 @@ uint8_t NodeDB::getMeshNodeChannel(NodeNum n)
 /// NOTE: This function might be called from an ISR
 meshtastic_NodeInfoLite *NodeDB::getMeshNode(NodeNum n)
 {
-    for (int i = 0; i < numMeshNodes; i++)
-        if (meshNodes->at(i).num == n)
-            return &meshNodes->at(i);
+    int i = nodeIndex.find(*meshNodes, n);
+    if (i >= 0 && i < numMeshNodes)
+        return &meshNodes->at(i);
 
     return NULL;
 }
@@ -1820,38 +2037,9 @@ meshtastic_NodeInfoLite *NodeDB::getOrCreateMeshNode(NodeNum n)
         if (isFull()) {
             LOG_INFO("Node database full with %i nodes and %u bytes free. Erasing oldest entry", numMeshNodes,
                      memGet.getFreeHeap());
-            // look for oldest node and erase it
-            uint32_t oldest = UINT32_MAX;
-            uint32_t oldestBoring = UINT32_MAX;
-            int oldestIndex = -1;
-            int oldestBoringIndex = -1;
-            for (int i = 1; i < numMeshNodes; i++) {
-                // Simply the oldest non-favorite, non-ignored, non-verified node
-                if (!meshNodes->at(i).is_favorite && !meshNodes->at(i).is_ignored &&
-                    !(meshNodes->at(i).bitfield & NODEINFO_BITFIELD_IS_KEY_MANUALLY_VERIFIED_MASK) &&
-                    meshNodes->at(i).last_heard < oldest) {
-                    oldest = meshNodes->at(i).last_heard;
-                    oldestIndex = i;
-                }
-                // The oldest "boring" node
-                if (!meshNodes->at(i).is_favorite && !meshNodes->at(i).is_ignored && meshNodes->at(i).user.public_key.size == 0 &&
-                    meshNodes->at(i).last_heard < oldestBoring) {
-                    oldestBoring = meshNodes->at(i).last_heard;
-                    oldestBoringIndex = i;
-                }
-            }
-            // if we found a "boring" node, evict it
-            if (oldestBoringIndex != -1) {
-                oldestIndex = oldestBoringIndex;
-            }
-
-            if (oldestIndex != -1) {
-                // Shove the remaining nodes down the chain
-                for (int i = oldestIndex; i < numMeshNodes - 1; i++) {
-                    meshNodes->at(i) = meshNodes->at(i + 1);
-                }
-                (numMeshNodes)--;
-            }
+            int oldestIndex = findEvictionCandidate();
+            if (oldestIndex != -1)
+                evictMeshNode(oldestIndex);
         }
         // add the node at the end
         lite = &meshNodes->at((numMeshNodes)++);
@@ -1859,6 +2047,11 @@ meshtastic_NodeInfoLite *NodeDB::getOrCreateMeshNode(NodeNum n)
         // everything is missing except the nodenum
         memset(lite, 0, sizeof(*lite));
         lite->num = n;
+        nodeIndex.insert(*meshNodes, numMeshNodes - 1);
+        nodeOrder.push_back(numMeshNodes - 1);
+        nodeOrderChanged(lite);
+        onlineNodes.add(lite->last_heard, lite->via_mqtt, getTime());
+        nodeChanged(lite);
         LOG_INFO("Adding node to database with %i nodes and %u bytes free!", numMeshNodes, memGet.getFreeHeap());
     }
 
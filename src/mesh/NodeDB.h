@@ -8,12 +8,17 @@
 #include <vector>
 
 #include "MeshTypes.h"
+#include "NodeChangeTracker.h"
+#include "NodeDBJournal.h"
+#include "NodeNumIndex.h"
 #include "NodeStatus.h"
+#include "OnlineNodeCounter.h"
 #include "configuration.h"
 #include "mesh-pb-constants.h"
 #include "mesh/generated/meshtastic/mesh.pb.h" // For CriticalErrorCode
 
 #if ARCH_PORTDUINO
+#include "NodeDBMmapStore.h"
 #include "PortduinoGlue.h"
 #endif
 
@@ -152,6 +157,12 @@ class NodeDB
     bool saveToDisk(int saveWhat = SEGMENT_CONFIG | SEGMENT_MODULECONFIG | SEGMENT_DEVICESTATE | SEGMENT_CHANNELS |
                                    SEGMENT_NODEDATABASE);
 
+    /// Persist the current state of a single node (or its removal, if it is no longer in the DB) by appending it to the node
+    /// journal, rather than rewriting the whole node database.  Falls back to a full save when the journal is due for
+    /// compaction or can't be written.
+    /// @return true if the save was successful
+    bool saveNodeToDisk(NodeNum n);
+
     /** Reinit radio config if needed, because either:
      * a) sometimes a buggy android app might send us bogus settings or
      * b) the client set factory_reset
@@ -219,19 +230,45 @@ class NodeDB
 
     bool factoryReset(bool eraseBleBonds = false);
 
+    /// @param crc if not NULL, receives the CRC32 of the file on success
     LoadFileResult loadProto(const char *filename, size_t protoSize, size_t objSize, const pb_msgdesc_t *fields,
-                             void *dest_struct);
+                             void *dest_struct, uint32_t *crc = nullptr);
+    /// @param crc if not NULL, receives the CRC32 of the bytes written on success
     bool saveProto(const char *filename, size_t protoSize, const pb_msgdesc_t *fields, const void *dest_struct,
-                   bool fullAtomic = true);
+                   bool fullAtomic = true, uint32_t *crc = nullptr);
 
     void installRoleDefaults(meshtastic_Config_DeviceConfig_Role role);
 
     const meshtastic_NodeInfoLite *readNextMeshNode(uint32_t &readIndex);
 
+    /// @return the node at position x of the node list (ourselves first, then favorites, then most recently heard)
     meshtastic_NodeInfoLite *getMeshNodeByIndex(size_t x)
     {
         assert(x < numMeshNodes);
-        return &meshNodes->at(x);
+        return &meshNodes->at(nodeOrder[x]);
+    }
+
+    /// Call after changing is_favorite of a node directly, so it moves to its new place in the node list
+    void nodeOrderChanged(const meshtastic_NodeInfoLite *node);
+
+    /// Record when we last heard from a node and how, keeping the node list order and the online node count current.
+    /// Always use this rather than writing last_heard/via_mqtt directly.
+    void setLastHeard(meshtastic_NodeInfoLite *node, uint32_t lastHeard, bool viaMqtt);
+
+    /// Call after changing a node record directly, so clients syncing incrementally are sent it again
+    void nodeChanged(const meshtastic_NodeInfoLite *node) { changes.touch(node - meshNodes->data()); }
+
+    /// @return token for a client to present on its next connection, to be sent only the nodes changed from now on
+    uint32_t getNodeSyncToken() const { return changes.getToken(); }
+
+    /// @param since receives the point the client is up to date with, for nodeChangedSince()
+    /// @return false if token is not one of ours or has been invalidated (nodes were removed since), a full sync is needed
+    bool acceptNodeSyncToken(uint32_t token, NodeChangeTracker::Generation &since) const { return changes.accept(token, since); }
+
+    /// @return true if node changed after the point since was taken
+    bool nodeChangedSince(const meshtastic_NodeInfoLite *node, NodeChangeTracker::Generation since) const
+    {
+        return changes.changedSince(node - meshNodes->data(), since);
     }
 
     virtual meshtastic_NodeInfoLite *getMeshNode(NodeNum n);
@@ -284,9 +321,17 @@ class NodeDB
 
   private:
     bool duplicateWarned = false;
-    uint32_t lastNodeDbSave = 0;    // when we last saved our db to flash
     uint32_t lastBackupAttempt = 0; // when we last tried a backup automatically or manually
-    uint32_t lastSort = 0;          // When last sorted the nodeDB
+    NodeNumIndex nodeIndex;         // NodeNum -> position in meshNodes, must be rebuilt whenever records move
+    // Positions in meshNodes in node list order. The records themselves are never sorted, only this small array is.
+    std::vector<NodeNumIndex::Slot> nodeOrder;
+    bool nodeOrderDirty = false; // a node changed while sorting was paused
+    OnlineNodeCounter onlineNodes;
+    NodeDBJournal journal; // single node changes since nodes.proto was last written
+    NodeChangeTracker changes; // when each record last changed, for incremental client syncs
+#if ARCH_PORTDUINO
+    NodeDBMmapStore nodeMap; // open if the config asks to keep nodes in a memory mapped file instead of nodes.proto
+#endif
     /// Find a node in our DB, create an empty NodeInfoLite if missing
     meshtastic_NodeInfoLite *getOrCreateMeshNode(NodeNum n);
 
@@ -315,7 +360,28 @@ class NodeDB
     bool saveChannelsToDisk();
     bool saveDeviceStateToDisk();
     bool saveNodeDatabaseToDisk();
+
+    /// Load the node database from the memory mapped node file, if the config asks for one
+    /// @return false if nodes.proto must be loaded instead
+    bool loadMappedNodeDatabase();
+
+    /// @return true if the record at position a of meshNodes belongs before the one at position b in the node list
+    bool nodeOrderBefore(size_t a, size_t b);
+
+    /// Rebuild nodeIndex and nodeOrder after records in meshNodes were added, removed or moved
+    void rebuildNodeIndexes();
+
+    /// Fully re-sort nodeOrder
     void sortMeshDB();
+
+    /// Rebuild the online node count from scratch
+    void recountOnlineNodes();
+
+    /// @return position in meshNodes of the node to drop when the DB is full, or -1 if every node must be kept
+    int findEvictionCandidate();
+
+    /// Remove the node at pos from meshNodes and all indexes, moving at most one other record
+    void evictMeshNode(size_t pos);
 };
 
 extern NodeDB *nodeDB;
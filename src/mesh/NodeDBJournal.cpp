@@ -0,0 +1,166 @@
+#include "NodeDBJournal.h"
+#include "FSCommon.h"
+#include "SPILock.h"
+#include "configuration.h"
+#include "mesh-pb-constants.h"
+#include <ErriezCRC32.h>
+#include <string.h>
+
+static void putU16(uint8_t *p, uint16_t v)
+{
+    p[0] = v;
+    p[1] = v >> 8;
+}
+
+static void putU32(uint8_t *p, uint32_t v)
+{
+    for (int i = 0; i < 4; i++)
+        p[i] = v >> (8 * i);
+}
+
+static uint16_t getU16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t getU32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+void NodeDBJournal::reset(uint32_t _snapshotCrc)
+{
+#ifdef FSCom
+    concurrency::LockGuard g(spiLock);
+    if (FSCom.exists(nodeJournalFileName))
+        FSCom.remove(nodeJournalFileName);
+#endif
+    snapshotCrc = _snapshotCrc;
+    fileSize = 0;
+    valid = true;
+}
+
+bool NodeDBJournal::replay(uint32_t _snapshotCrc, const std::function<void(const meshtastic_NodeInfoLite &)> &onUpdate,
+                           const std::function<void(NodeNum)> &onRemove)
+{
+    snapshotCrc = _snapshotCrc;
+    fileSize = 0;
+    valid = false;
+#ifdef FSCom
+    // Read the whole journal first so the callbacks are free to touch the filesystem
+    std::vector<uint8_t> buf;
+    {
+        concurrency::LockGuard g(spiLock);
+        if (!FSCom.exists(nodeJournalFileName)) {
+            valid = true;
+            return true;
+        }
+        auto f = FSCom.open(nodeJournalFileName, FILE_O_READ);
+        if (!f) {
+            LOG_ERROR("Could not open / read %s", nodeJournalFileName);
+            return false;
+        }
+        buf.resize(f.size());
+        buf.resize(f.read(buf.data(), buf.size()));
+        f.close();
+    }
+
+    if (buf.size() < HEADER_SIZE || getU32(&buf[0]) != MAGIC) {
+        LOG_WARN("Discard damaged node journal");
+        return false;
+    }
+    if (getU32(&buf[4]) != snapshotCrc) {
+        LOG_WARN("Discard node journal of a different node database snapshot");
+        return false;
+    }
+
+    uint32_t pos = HEADER_SIZE, numRecords = 0;
+    bool clean = true;
+    while (pos < buf.size()) {
+        const uint8_t *rec = &buf[pos];
+        size_t len = buf.size() - pos >= 3 ? getU16(rec + 1) : 0;
+        if (buf.size() - pos < RECORD_OVERHEAD + len || crc32Buffer(rec, 3 + len) != getU32(rec + 3 + len)) {
+            LOG_WARN("Node journal torn after %u records, ignore the remaining %u bytes", numRecords,
+                     (uint32_t)(buf.size() - pos));
+            clean = false;
+            break;
+        }
+
+        if (rec[0] == RECORD_NODE) {
+            meshtastic_NodeInfoLite node = meshtastic_NodeInfoLite_init_zero;
+            if (pb_decode_from_bytes(rec + 3, len, &meshtastic_NodeInfoLite_msg, &node))
+                onUpdate(node);
+        } else if (rec[0] == RECORD_REMOVE && len == 4) {
+            onRemove(getU32(rec + 3));
+        }
+        pos += RECORD_OVERHEAD + len;
+        numRecords++;
+    }
+    LOG_INFO("Replayed %u node journal records (%u bytes)", numRecords, pos);
+
+    fileSize = pos;
+    valid = clean;
+    return clean;
+#else
+    return false;
+#endif
+}
+
+bool NodeDBJournal::appendNode(const meshtastic_NodeInfoLite &node)
+{
+    uint8_t payload[meshtastic_NodeInfoLite_size];
+    size_t len = pb_encode_to_bytes(payload, sizeof(payload), &meshtastic_NodeInfoLite_msg, &node);
+    if (!len && node.num)
+        return false;
+    return appendRecord(RECORD_NODE, payload, len);
+}
+
+bool NodeDBJournal::appendRemove(NodeNum n)
+{
+    uint8_t payload[4];
+    putU32(payload, n);
+    return appendRecord(RECORD_REMOVE, payload, sizeof(payload));
+}
+
+bool NodeDBJournal::appendRecord(RecordKind kind, const uint8_t *payload, size_t len)
+{
+    if (!valid)
+        return false;
+#ifdef FSCom
+    // Header (if this starts the journal) and record go out in a single write
+    uint8_t buf[HEADER_SIZE + RECORD_OVERHEAD + meshtastic_NodeInfoLite_size];
+    uint32_t n = 0;
+    if (fileSize == 0) {
+        putU32(&buf[0], MAGIC);
+        putU32(&buf[4], snapshotCrc);
+        n = HEADER_SIZE;
+    }
+    uint8_t *rec = &buf[n];
+    rec[0] = kind;
+    putU16(rec + 1, len);
+    memcpy(rec + 3, payload, len);
+    putU32(rec + 3 + len, crc32Buffer(rec, 3 + len));
+    n += RECORD_OVERHEAD + len;
+
+    concurrency::LockGuard g(spiLock);
+    auto f = FSCom.open(nodeJournalFileName, fileSize ? FILE_O_APPEND : FILE_O_WRITE);
+    if (!f) {
+        LOG_ERROR("Could not open %s for writing", nodeJournalFileName);
+        valid = false;
+        return false;
+    }
+    bool okay = f.write(buf, n) == n;
+    f.close();
+    if (!okay) {
+        // A partial record is ignored by replay, but anything appended after it would be too
+        LOG_ERROR("Can't append to %s", nodeJournalFileName);
+        valid = false;
+        return false;
+    }
+    fileSize += n;
+    LOG_DEBUG("Appended %u bytes to node journal, now %u bytes", n, fileSize);
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "MeshTypes.h"
+#include "mesh/generated/meshtastic/deviceonly.pb.h"
+#include <functional>
+
+/// Once the journal grows past this many bytes it is folded back into a full nodes.proto snapshot
+#ifndef NODEDB_JOURNAL_MAX_BYTES
+#define NODEDB_JOURNAL_MAX_BYTES 8192
+#endif
+
+static constexpr const char *nodeJournalFileName = "/prefs/nodes.journal";
+
+/**
+ * Append-only log of single node changes made since the last full save of the node database.
+ *
+ * Rewriting all of nodes.proto because one node was favorited costs a flash write of the whole database.  Instead such changes
+ * append the node's current record (or a removal marker) here, a few hundred bytes.  On boot the journal is replayed on top of
+ * the snapshot; every full save starts a new, empty journal.
+ *
+ * The file starts with a header naming the CRC32 of the snapshot file it applies to, so a journal left behind by a crash
+ * during compaction is not replayed onto a newer snapshot.  Each record carries a CRC, replay stops at the first torn or
+ * corrupt record.
+ */
+class NodeDBJournal
+{
+  public:
+    /// A full snapshot with CRC32 snapshotCrc was just written, forget the old journal and start over against it
+    void reset(uint32_t snapshotCrc);
+
+    /**
+     * Apply the journal on top of a freshly loaded snapshot with CRC32 snapshotCrc, oldest record first.
+     *
+     * @return false if the journal belonged to another snapshot or had a damaged tail.  Whatever could be applied was, the
+     * caller should write a new snapshot before appending again.
+     */
+    bool replay(uint32_t snapshotCrc, const std::function<void(const meshtastic_NodeInfoLite &)> &onUpdate,
+                const std::function<void(NodeNum)> &onRemove);
+
+    /// Record the current state of a node
+    bool appendNode(const meshtastic_NodeInfoLite &node);
+
+    /// Record that a node was removed from the database
+    bool appendRemove(NodeNum n);
+
+    /// @return true if the journal is big enough that the next save should be a full snapshot
+    bool needsCompaction() const { return fileSize > NODEDB_JOURNAL_MAX_BYTES; }
+
+    /// @return size of the journal file in bytes
+    uint32_t getSize() const { return fileSize; }
+
+  private:
+    static constexpr uint32_t MAGIC = 0x324a444e; // "NDJ2", "NDJ1" journals named their snapshot by its size
+    static constexpr size_t HEADER_SIZE = 8;      // magic, snapshot CRC32
+    static constexpr size_t RECORD_OVERHEAD = 7;  // kind, payload length, CRC32
+
+    enum RecordKind : uint8_t { RECORD_NODE = 1, RECORD_REMOVE = 2 };
+
+    uint32_t snapshotCrc = 0;
+    uint32_t fileSize = 0; // 0 until the first record (and the header) is written
+    bool valid = false;    // we know which snapshot we are journaling against
+
+    bool appendRecord(RecordKind kind, const uint8_t *payload, size_t len);
+};
@@ -0,0 +1,140 @@
+#include "NodeDBMmapStore.h"
+
+#if ARCH_PORTDUINO
+#include <ErriezCRC32.h>
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+uint32_t NodeDBMmapStore::headerCrc(const Header &h)
+{
+    return crc32Buffer(&h, offsetof(Header, crc));
+}
+
+bool NodeDBMmapStore::headerMatches(const Header &h)
+{
+    return h.magic == MAGIC && h.recordSize == sizeof(meshtastic_NodeInfoLite) &&
+           h.encodedSize == meshtastic_NodeInfoLite_size && h.crc == headerCrc(h);
+}
+
+bool NodeDBMmapStore::open(const char *path, size_t capacity)
+{
+    close();
+    fd = ::open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        LOG_ERROR("Can't open %s, errno=%d", path, errno);
+        return false;
+    }
+
+    Header old = {};
+    bool usable = pread(fd, &old, sizeof(old), 0) == (ssize_t)sizeof(old) && headerMatches(old);
+
+    // Slots stay where they are when the capacity changes, shrinking just cuts off the last ones
+    size_t size = sizeof(Header) + capacity * sizeof(Slot);
+    void *mapping = MAP_FAILED;
+    if (ftruncate(fd, size) == 0)
+        mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        LOG_ERROR("Can't map %u bytes of %s, errno=%d", (unsigned)size, path, errno);
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    header = (Header *)mapping;
+    mappedSize = size;
+
+    if (!usable) {
+        LOG_INFO("Start new node map %s", path);
+        memset(header, 0, sizeof(*header));
+        header->magic = MAGIC;
+        header->recordSize = sizeof(meshtastic_NodeInfoLite);
+        header->encodedSize = meshtastic_NodeInfoLite_size;
+    }
+    if (!usable || header->capacity != capacity) {
+        header->capacity = capacity;
+        header->count = std::min(header->count, (uint32_t)capacity);
+        header->crc = headerCrc(*header);
+        sync(header, header + 1);
+    }
+    return true;
+}
+
+void NodeDBMmapStore::close()
+{
+    if (header) {
+        munmap(header, mappedSize);
+        header = NULL;
+        mappedSize = 0;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+int NodeDBMmapStore::load(std::vector<meshtastic_NodeInfoLite> &nodes, uint32_t &dbVersion)
+{
+    if (!header || header->dbVersion == 0)
+        return -1;
+
+    size_t count = std::min((size_t)header->count, nodes.size());
+    size_t n = 0;
+    for (size_t i = 0; i < count; i++) {
+        Slot *slot = getSlot(i);
+        if (slot->crc == crc32Buffer(&slot->node, sizeof(slot->node)))
+            nodes[n++] = slot->node;
+    }
+    if (n < count)
+        LOG_WARN("Dropped %u damaged node records", (unsigned)(count - n));
+
+    dbVersion = header->dbVersion;
+    return n;
+}
+
+bool NodeDBMmapStore::save(const std::vector<meshtastic_NodeInfoLite> &nodes, size_t count, uint32_t dbVersion)
+{
+    if (!header)
+        return false;
+
+    count = std::min({count, nodes.size(), (size_t)header->capacity});
+    Slot *first = NULL, *last = NULL;
+    dirtyRecords = 0;
+    for (size_t i = 0; i < count; i++) {
+        Slot *slot = getSlot(i);
+        if (memcmp(&slot->node, &nodes[i], sizeof(slot->node)) == 0)
+            continue;
+        memcpy(&slot->node, &nodes[i], sizeof(slot->node));
+        slot->crc = crc32Buffer(&slot->node, sizeof(slot->node));
+        first = first ? first : slot;
+        last = slot;
+        dirtyRecords++;
+    }
+
+    // The records must be on disk before a header that counts them
+    bool okay = !first || sync(first, last + 1);
+    if (okay && (header->count != count || header->dbVersion != dbVersion)) {
+        header->count = count;
+        header->dbVersion = dbVersion;
+        header->crc = headerCrc(*header);
+        okay = sync(header, header + 1);
+    }
+    LOG_DEBUG("Saved %u changed of %u nodes to node map", (unsigned)dirtyRecords, (unsigned)count);
+    return okay;
+}
+
+bool NodeDBMmapStore::sync(const void *start, const void *end)
+{
+    // msync wants a page aligned start
+    uintptr_t page = sysconf(_SC_PAGESIZE);
+    uintptr_t from = (uintptr_t)start & ~(page - 1);
+    if (msync((void *)from, (uintptr_t)end - from, MS_SYNC) < 0) {
+        LOG_ERROR("Can't write back node map, errno=%d", errno);
+        return false;
+    }
+    return true;
+}
+
+#endif
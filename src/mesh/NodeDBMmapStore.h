@@ -0,0 +1,86 @@
+#pragma once
+
+#include "configuration.h"
+
+#if ARCH_PORTDUINO
+#include "mesh/generated/meshtastic/deviceonly.pb.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+static constexpr const char *nodeMapFileName = "/prefs/nodes.mmap";
+
+/**
+ * Node database storage for Linux, where MaxNodes can be in the thousands: the NodeInfoLite records are kept as they are in
+ * RAM, one fixed size slot each, in a memory mapped file.
+ *
+ * Loading is a copy of the slots instead of a protobuf decode of all of nodes.proto.  Saving compares each node with its slot
+ * and rewrites only the ones that changed, so the kernel writes back only the pages they are on, instead of re-encoding and
+ * rewriting the whole database.
+ *
+ * Every slot carries a CRC of its record, a damaged record is dropped on load instead of the whole database.  The header
+ * names the size and protobuf limits of NodeInfoLite, a build with a different layout ignores the file and starts over from
+ * nodes.proto.
+ */
+class NodeDBMmapStore
+{
+  public:
+    ~NodeDBMmapStore() { close(); }
+
+    /// Map the file at path (a host path, not one in our file system), creating it or resizing it to hold capacity nodes
+    /// @return false if it couldn't be opened or mapped
+    bool open(const char *path, size_t capacity);
+
+    void close();
+
+    bool isOpen() const { return header != NULL; }
+
+    /**
+     * Copy the stored nodes to the start of nodes, which must already hold capacity (empty) records
+     * @param dbVersion receives the NodeDatabase version they were saved with
+     * @return number of nodes loaded, or -1 if nothing was ever saved to this file
+     */
+    int load(std::vector<meshtastic_NodeInfoLite> &nodes, uint32_t &dbVersion);
+
+    /// Store the first count of nodes, rewriting only the slots that changed, and msync them
+    /// @return false if writing back failed
+    bool save(const std::vector<meshtastic_NodeInfoLite> &nodes, size_t count, uint32_t dbVersion);
+
+    /// @return how many slots the last save rewrote
+    size_t getDirtyRecords() const { return dirtyRecords; }
+
+    /// @return where the NodeInfoLite of slot i starts in the file
+    static size_t recordOffset(size_t i) { return sizeof(Header) + i * sizeof(Slot) + offsetof(Slot, node); }
+
+  private:
+    static constexpr uint32_t MAGIC = 0x314d444e; // "NDM1"
+
+    struct Header {
+        uint32_t magic;
+        uint16_t recordSize;  // sizeof(meshtastic_NodeInfoLite)
+        uint16_t encodedSize; // meshtastic_NodeInfoLite_size, changes with the fields even when the struct size doesn't
+        uint32_t capacity;
+        uint32_t count;
+        uint32_t dbVersion; // 0 until the first save
+        uint32_t crc;       // of the fields above
+    };
+
+    struct Slot {
+        uint32_t crc; // of node
+        meshtastic_NodeInfoLite node;
+    };
+
+    int fd = -1;
+    Header *header = NULL; // start of the mapping
+    size_t mappedSize = 0;
+    size_t dirtyRecords = 0;
+
+    Slot *getSlot(size_t i) { return (Slot *)(header + 1) + i; }
+    static uint32_t headerCrc(const Header &h);
+    static bool headerMatches(const Header &h);
+
+    /// Write back the part of the mapping from start to end
+    bool sync(const void *start, const void *end);
+};
+
+#endif
@@ -0,0 +1,74 @@
+#include "NodeNumIndex.h"
+
+void NodeNumIndex::reset(size_t maxNodes)
+{
+    // Keep the load factor at or below 50% so probe sequences stay short
+    uint32_t size = 16;
+    uint8_t bits = 4;
+    while (size < maxNodes * 2) {
+        size <<= 1;
+        bits++;
+    }
+    mask = size - 1;
+    shift = 32 - bits;
+    slots.assign(size, EMPTY_SLOT);
+}
+
+void NodeNumIndex::rebuild(const std::vector<meshtastic_NodeInfoLite> &nodes, size_t count)
+{
+    reset(nodes.size() > count ? nodes.size() : count);
+    // Walk backwards so that if the array ever holds a duplicate the first occurrence wins, as with a linear scan
+    for (size_t i = count; i-- > 0;)
+        insert(nodes, i);
+}
+
+void NodeNumIndex::insert(const std::vector<meshtastic_NodeInfoLite> &nodes, size_t pos)
+{
+    if (slots.empty())
+        reset(nodes.size());
+
+    NodeNum n = nodes[pos].num;
+    for (uint32_t i = home(n);; i = (i + 1) & mask) {
+        if (slots[i] == EMPTY_SLOT || nodes[slots[i]].num == n) {
+            slots[i] = (Slot)pos;
+            return;
+        }
+    }
+}
+
+void NodeNumIndex::erase(const std::vector<meshtastic_NodeInfoLite> &nodes, NodeNum n)
+{
+    if (slots.empty())
+        return;
+
+    uint32_t i = home(n);
+    while (slots[i] != EMPTY_SLOT && nodes[slots[i]].num != n)
+        i = (i + 1) & mask;
+    if (slots[i] == EMPTY_SLOT)
+        return;
+
+    // Backward shift deletion: pull later members of the probe run into the hole so no tombstones are needed
+    for (uint32_t j = (i + 1) & mask; slots[j] != EMPTY_SLOT; j = (j + 1) & mask) {
+        uint32_t h = home(nodes[slots[j]].num);
+        // Only move the entry if its home is not cyclically inside (i, j]
+        if (((j - h) & mask) >= ((j - i) & mask)) {
+            slots[i] = slots[j];
+            i = j;
+        }
+    }
+    slots[i] = EMPTY_SLOT;
+}
+
+int NodeNumIndex::find(const std::vector<meshtastic_NodeInfoLite> &nodes, NodeNum n) const
+{
+    if (slots.empty())
+        return -1;
+
+    for (uint32_t i = home(n);; i = (i + 1) & mask) {
+        Slot s = slots[i];
+        if (s == EMPTY_SLOT)
+            return -1;
+        if (s < nodes.size() && nodes[s].num == n)
+            return s;
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "MeshTypes.h"
+#include <vector>
+
+/**
+ * A compact open-addressed hash from NodeNum to a position in the NodeDB meshNodes array.
+ *
+ * Only positions are stored, keys are read back from the node records themselves, so a slot costs 2 bytes (4 on portduino,
+ * where the node limit comes from config and may exceed 64k).  Lookups are constant time with linear probing, the table is
+ * kept at most half full.  Whoever moves records around in the array is responsible for calling rebuild() (or
+ * insert()/erase() for single-record changes) so the index stays consistent.
+ */
+class NodeNumIndex
+{
+  public:
+#if ARCH_PORTDUINO
+    typedef uint32_t Slot;
+#else
+    typedef uint16_t Slot;
+#endif
+    static constexpr Slot EMPTY_SLOT = (Slot)-1;
+
+    /// Size the table for up to maxNodes records and forget everything indexed so far
+    void reset(size_t maxNodes);
+
+    /// Throw away the current contents and index nodes[0..count)
+    void rebuild(const std::vector<meshtastic_NodeInfoLite> &nodes, size_t count);
+
+    /// Record that the node at nodes[pos] is now present, replacing any existing entry for the same NodeNum
+    void insert(const std::vector<meshtastic_NodeInfoLite> &nodes, size_t pos);
+
+    /// Forget the entry for n (if any).  nodes must still hold n at its indexed position.
+    void erase(const std::vector<meshtastic_NodeInfoLite> &nodes, NodeNum n);
+
+    /// @return the position of n in nodes, or -1 if it is not indexed
+    int find(const std::vector<meshtastic_NodeInfoLite> &nodes, NodeNum n) const;
+
+  private:
+    std::vector<Slot> slots;
+    uint32_t mask = 0;
+    uint8_t shift = 32;
+
+    /// Fibonacci hashing, node numbers are usually derived from MAC addresses so the low bits alone are poorly spread
+    inline uint32_t home(NodeNum n) const { return (uint32_t)(n * 2654435769u) >> shift; }
+};
@@ -0,0 +1,112 @@
+#include "OnlineNodeCounter.h"
+#include <algorithm>
+#include <string.h>
+
+void OnlineNodeCounter::clear(uint32_t now)
+{
+    memset(wheel, 0, sizeof(wheel));
+    future.clear();
+    currentBucket = now / BUCKET_SECS;
+    onlineLocal = onlineMqtt = 0;
+    recountNeeded = false;
+}
+
+void OnlineNodeCounter::advance(uint32_t now)
+{
+    uint32_t nowBucket = now / BUCKET_SECS;
+    if (nowBucket == currentBucket)
+        return;
+    if (nowBucket < currentBucket) {
+        // Clock stepped backwards, nodes we already expired might be online again
+        recountNeeded = true;
+        return;
+    }
+
+    // Each step the slot of the bucket that falls out of the window is reused for the new current bucket
+    uint32_t steps = std::min(nowBucket - currentBucket, NUM_BUCKETS);
+    for (uint32_t i = 1; i <= steps; i++) {
+        Bucket &b = wheel[(currentBucket + i) % NUM_BUCKETS];
+        onlineLocal -= b.local;
+        onlineMqtt -= b.mqtt;
+        b.local = b.mqtt = 0;
+    }
+    currentBucket = nowBucket;
+
+    // Future buckets we reached are either inside the window now or already expired (if the clock jumped a long way)
+    size_t reached = 0;
+    while (reached < future.size() && future[reached].number <= currentBucket) {
+        const Bucket &f = future[reached++];
+        if (f.number + NUM_BUCKETS > currentBucket) {
+            Bucket &b = wheel[f.number % NUM_BUCKETS];
+            b.local += f.local;
+            b.mqtt += f.mqtt;
+        } else {
+            onlineLocal -= f.local;
+            onlineMqtt -= f.mqtt;
+        }
+    }
+    if (reached)
+        future.erase(future.begin(), future.begin() + reached);
+}
+
+OnlineNodeCounter::Bucket *OnlineNodeCounter::find(uint32_t lastHeard, bool create)
+{
+    uint32_t number = lastHeard / BUCKET_SECS;
+    if (number > currentBucket) {
+        auto it = std::lower_bound(future.begin(), future.end(), number,
+                                   [](const Bucket &b, uint32_t n) { return b.number < n; });
+        if (it == future.end() || it->number != number) {
+            if (!create)
+                return NULL;
+            it = future.insert(it, Bucket{number, 0, 0});
+        }
+        return &*it;
+    }
+    if (number + NUM_BUCKETS > currentBucket)
+        return &wheel[number % NUM_BUCKETS];
+    return NULL; // Already offline, not counted anywhere
+}
+
+void OnlineNodeCounter::add(uint32_t lastHeard, bool viaMqtt, uint32_t now)
+{
+    advance(now);
+    if (recountNeeded)
+        return; // The owner will rebuild everything anyway
+
+    Bucket *b = find(lastHeard, true);
+    if (!b)
+        return;
+    if (viaMqtt) {
+        b->mqtt++;
+        onlineMqtt++;
+    } else {
+        b->local++;
+        onlineLocal++;
+    }
+}
+
+void OnlineNodeCounter::remove(uint32_t lastHeard, bool viaMqtt, uint32_t now)
+{
+    advance(now);
+    if (recountNeeded)
+        return;
+
+    Bucket *b = find(lastHeard, false);
+    if (!b)
+        return;
+    if (viaMqtt && b->mqtt) {
+        b->mqtt--;
+        onlineMqtt--;
+    } else if (!viaMqtt && b->local) {
+        b->local--;
+        onlineLocal--;
+    }
+    if (lastHeard / BUCKET_SECS > currentBucket && !b->local && !b->mqtt)
+        future.erase(future.begin() + (b - future.data()));
+}
+
+size_t OnlineNodeCounter::getNumOnline(bool localOnly, uint32_t now)
+{
+    advance(now);
+    return localOnly ? onlineLocal : onlineLocal + onlineMqtt;
+}
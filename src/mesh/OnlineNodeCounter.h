@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#define NUM_ONLINE_SECS (60 * 60 * 2) // 2 hrs to consider someone offline
+
+/**
+ * Incrementally maintained count of "online" nodes (heard within the last NUM_ONLINE_SECS), split by whether they were last
+ * heard locally or via MQTT.
+ *
+ * Nodes are counted in a wheel of one minute buckets keyed by last_heard.  As the clock advances whole buckets fall off the
+ * back of the wheel, so reading the count is O(1) amortized instead of a scan of the NodeDB.  The price is a resolution of one
+ * bucket: a node drops offline up to a minute early.  Nodes heard "in the future" (our clock is behind, e.g. no RTC yet) wait in
+ * a small sorted list until the clock reaches them, they count as online meanwhile, same as sinceLastSeen() clamps them to 0.
+ *
+ * Every add() must be matched by a remove() with the same values before the node changes.  If the clock steps backwards the
+ * counter can not be corrected incrementally, needsRecount() then tells the owner to clear() and add() every node again.
+ */
+class OnlineNodeCounter
+{
+  public:
+#if ARCH_PORTDUINO
+    typedef uint32_t Count;
+#else
+    typedef uint16_t Count;
+#endif
+
+    static constexpr uint32_t BUCKET_SECS = 60;
+    static constexpr uint32_t NUM_BUCKETS = NUM_ONLINE_SECS / BUCKET_SECS;
+
+    /// Forget all nodes and align the wheel to now
+    void clear(uint32_t now);
+
+    /// Count a node last heard at lastHeard
+    void add(uint32_t lastHeard, bool viaMqtt, uint32_t now);
+
+    /// Stop counting a node previously add()ed with these values
+    void remove(uint32_t lastHeard, bool viaMqtt, uint32_t now);
+
+    /// @return number of nodes heard within NUM_ONLINE_SECS of now
+    size_t getNumOnline(bool localOnly, uint32_t now);
+
+    /// @return true if the clock went backwards and the owner must clear() and re-add all nodes
+    bool needsRecount() const { return recountNeeded; }
+
+  private:
+    struct Bucket {
+        uint32_t number; // lastHeard / BUCKET_SECS, only used for future buckets
+        Count local;
+        Count mqtt;
+    };
+
+    Bucket wheel[NUM_BUCKETS] = {};
+    std::vector<Bucket> future; // sorted by number, buckets after currentBucket
+    uint32_t currentBucket = 0; // bucket number of "now" the wheel is aligned to
+    size_t onlineLocal = 0, onlineMqtt = 0;
+    bool recountNeeded = false;
+
+    /// Expire buckets that left the window and pull in future buckets that entered it
+    void advance(uint32_t now);
+
+    /// @return the bucket a node heard at lastHeard is counted in, or NULL if it is already offline
+    Bucket *find(uint32_t lastHeard, bool create);
+};
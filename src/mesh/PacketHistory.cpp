@@ -23,18 +23,41 @@ PacketHistory::PacketHistory(uint32_t size) : recentPacketsCapacity(0), recentPa
         size = PACKETHISTORY_MAX; // Use default size if invalid
     }
 
-    // Allocate memory for the recent packets array
+    // Hash table is a power of two at least twice the number of records, so probe runs stay short
+    uint32_t hashSize = 16;
+    uint8_t hashBits = 4;
+    while (hashSize < size * 2) {
+        hashSize <<= 1;
+        hashBits++;
+    }
+
+    // Allocate memory for the recent packets array and its index
     recentPacketsCapacity = size;
     recentPackets = new PacketRecord[recentPacketsCapacity];
-    if (!recentPackets) { // No logging here, console/log probably uninitialized yet.
+    hashSlots = new Slot[hashSize];
+    lruPrev = new Slot[recentPacketsCapacity];
+    lruNext = new Slot[recentPacketsCapacity];
+    if (!recentPackets || !hashSlots || !lruPrev || !lruNext) { // No logging here, console/log probably uninitialized yet.
         LOG_ERROR("Packet History - Memory allocation failed for size=%d entries / %d Bytes", size,
-                  sizeof(PacketRecord) * recentPacketsCapacity);
+                  (sizeof(PacketRecord) + 2 * sizeof(Slot)) * recentPacketsCapacity + sizeof(Slot) * hashSize);
+        delete[] recentPackets;
+        delete[] hashSlots;
+        delete[] lruPrev;
+        delete[] lruNext;
+        recentPackets = NULL;
+        hashSlots = lruPrev = lruNext = NULL;
         recentPacketsCapacity = 0; // mark allocation fail
         return;                    // return early
     }
+    hashMask = hashSize - 1;
+    hashShift = 32 - hashBits;
 
     // Initialize the recent packets array to zero
     memset(recentPackets, 0, sizeof(PacketRecord) * recentPacketsCapacity);
+    for (uint32_t i = 0; i < hashSize; i++)
+        hashSlots[i] = EMPTY_SLOT;
+    for (uint32_t i = 0; i < recentPacketsCapacity; i++)
+        lruPrev[i] = lruNext[i] = EMPTY_SLOT;
 }
 
 PacketHistory::~PacketHistory()
@@ -42,6 +65,10 @@ PacketHistory::~PacketHistory()
     recentPacketsCapacity = 0;
     delete[] recentPackets;
     recentPackets = NULL;
+    delete[] hashSlots;
+    delete[] lruPrev;
+    delete[] lruNext;
+    hashSlots = lruPrev = lruNext = NULL;
 }
 
 /** Update recentPackets and return true if we have already seen this packet */
@@ -161,15 +188,17 @@ PacketHistory::PacketRecord *PacketHistory::find(NodeNum sender, PacketId id)
         return NULL;
     }
 
-    PacketRecord *it = NULL;
-    for (it = recentPackets; it < (recentPackets + recentPacketsCapacity); ++it) {
+    for (uint32_t i = hashHome(sender, id);; i = (i + 1) & hashMask) {
+        Slot s = hashSlots[i];
+        if (s == EMPTY_SLOT)
+            break;
+        PacketRecord *it = &recentPackets[s];
         if (it->id == id && it->sender == sender) {
 #if VERBOSE_PACKET_HISTORY
             LOG_DEBUG("Packet History - find: s=%08x id=%08x FOUND nh=%02x rby=%02x %02x %02x age=%d slot=%d/%d", it->sender,
                       it->id, it->next_hop, it->relayed_by[0], it->relayed_by[1], it->relayed_by[2], millis() - (it->rxTimeMsec),
-                      it - recentPackets, recentPacketsCapacity);
+                      s, recentPacketsCapacity);
 #endif
-            // only the first match is returned, so be careful not to create duplicate entries
             return it; // Return pointer to the found record
         }
     }
@@ -186,42 +215,34 @@ void PacketHistory::insert(const PacketRecord &r)
     uint32_t now_millis = millis(); // Should not jump with time changes
     uint32_t OldtrxTimeMsec = 0;
     PacketRecord *tu = NULL; // Will insert here.
-    PacketRecord *it = NULL;
 
-    // Find a free, matching or oldest used slot in the recentPackets array
-    for (it = recentPackets; it < (recentPackets + recentPacketsCapacity); ++it) {
-        if (it->id == 0 && it->sender == 0 /*&& rxTimeMsec == 0*/) { // Record is empty
-            tu = it;                                                 // Remember the free slot
+    if (r.rxTimeMsec == 0) {
+#if VERBOSE_PACKET_HISTORY
+        LOG_WARN("Packet History - insert: I will not store packet with rxTimeMsec = 0.");
+#endif
+        return; // Return early if we can't update the history
+    }
+
+    // A matching record is updated in place, otherwise take a never used slot, otherwise reuse the least recently inserted one
+    tu = find(r.sender, r.id);
+    if (tu != NULL) {
+        OldtrxTimeMsec = now_millis - tu->rxTimeMsec;
 #if VERBOSE_PACKET_HISTORY >= 2
-            LOG_DEBUG("Packet History - insert: Free slot@ %d/%d", tu - recentPackets, recentPacketsCapacity);
+        LOG_DEBUG("Packet History - insert: Matched slot@ %d/%d age=%d", tu - recentPackets, recentPacketsCapacity,
+                  OldtrxTimeMsec);
 #endif
-            // We have that, Exit the loop
-            it = (recentPackets + recentPacketsCapacity);
-        } else if (it->id == r.id && it->sender == r.sender) { // Record matches the packet we want to insert
-            tu = it;                                           // Remember the matching slot
-            OldtrxTimeMsec = now_millis - it->rxTimeMsec;      // ..and save current entry's age
+    } else if (recentPacketsUsed < recentPacketsCapacity) {
+        tu = &recentPackets[recentPacketsUsed++];
 #if VERBOSE_PACKET_HISTORY >= 2
-            LOG_DEBUG("Packet History - insert: Matched slot@ %d/%d age=%d", tu - recentPackets, recentPacketsCapacity,
-                      OldtrxTimeMsec);
+        LOG_DEBUG("Packet History - insert: Free slot@ %d/%d", tu - recentPackets, recentPacketsCapacity);
 #endif
-            // We have that, Exit the loop
-            it = (recentPackets + recentPacketsCapacity);
-        } else {
-            if (it->rxTimeMsec == 0) {
-                LOG_WARN(
-                    "Packet History - insert: Found packet s=%08x id=%08x with rxTimeMsec = 0, slot %d/%d. Should never happen!",
-                    it->sender, it->id, it - recentPackets, recentPacketsCapacity);
-            }
-            if ((now_millis - it->rxTimeMsec) > OldtrxTimeMsec) { // 49.7 days rollover friendly
-                OldtrxTimeMsec = now_millis - it->rxTimeMsec;
-                tu = it; // remember the oldest packet
+    } else if (lruHead != EMPTY_SLOT) {
+        tu = &recentPackets[lruPrev[lruHead]];
+        OldtrxTimeMsec = now_millis - tu->rxTimeMsec; // 49.7 days rollover friendly
 #if VERBOSE_PACKET_HISTORY >= 2
-                LOG_DEBUG("Packet History - insert: Older slot@ %d/%d age=%d", tu - recentPackets, recentPacketsCapacity,
-                          OldtrxTimeMsec);
+        LOG_DEBUG("Packet History - insert: Older slot@ %d/%d age=%d", tu - recentPackets, recentPacketsCapacity,
+                  OldtrxTimeMsec);
 #endif
-            }
-            // keep looking for oldest till entire array is checked
-        }
     }
 
     if (tu == NULL) {
@@ -230,22 +251,23 @@ void PacketHistory::insert(const PacketRecord &r)
         return; // Return early if we can't update the history
     }
 
+    bool matched = (tu->id == r.id && tu->sender == r.sender);
+    Slot slot = tu - recentPackets;
+
 #if VERBOSE_PACKET_HISTORY
     if (tu->id == 0 && tu->sender == 0) {
-        LOG_DEBUG("Packet History - insert: slot@ %d/%d is NEW", tu - recentPackets, recentPacketsCapacity);
-    } else if (tu->id == r.id && tu->sender == r.sender) {
-        LOG_DEBUG("Packet History - insert: slot@ %d/%d MATCHED, age=%d", tu - recentPackets, recentPacketsCapacity,
-                  OldtrxTimeMsec);
+        LOG_DEBUG("Packet History - insert: slot@ %d/%d is NEW", slot, recentPacketsCapacity);
+    } else if (matched) {
+        LOG_DEBUG("Packet History - insert: slot@ %d/%d MATCHED, age=%d", slot, recentPacketsCapacity, OldtrxTimeMsec);
     } else {
-        LOG_DEBUG("Packet History - insert: slot@ %d/%d REUSE OLDEST, age=%d", tu - recentPackets, recentPacketsCapacity,
-                  OldtrxTimeMsec);
+        LOG_DEBUG("Packet History - insert: slot@ %d/%d REUSE OLDEST, age=%d", slot, recentPacketsCapacity, OldtrxTimeMsec);
     }
 #endif
 
     // If we are reusing a slot, we should warn if the packet is too recent
 #if RECENT_WARN_AGE > 0
     if (tu->rxTimeMsec && (OldtrxTimeMsec < RECENT_WARN_AGE)) {
-        if (!(tu->id == r.id && tu->sender == r.sender)) {
+        if (!matched) {
 #if VERBOSE_PACKET_HISTORY
             LOG_WARN("Packet History - insert: Reusing slot aged %ds < %ds RECENT_WARN_AGE", OldtrxTimeMsec / 1000,
                      RECENT_WARN_AGE / 1000);
@@ -262,7 +284,7 @@ void PacketHistory::insert(const PacketRecord &r)
 #if PACKET_HISTORY_TRACE_AGING
     if (tu->rxTimeMsec != 0) {
         LOG_INFO("Packet History - insert: Reusing slot aged %.3fs TRACE %s", OldtrxTimeMsec / 1000.,
-                 (tu->id == r.id && tu->sender == r.sender) ? "MATCHED PACKET" : "OLDEST SLOT");
+                 matched ? "MATCHED PACKET" : "OLDEST SLOT");
     } else {
         LOG_INFO("Packet History - insert: Using new slot @uptime %.3fs TRACE NEW", millis() / 1000.);
     }
@@ -271,27 +293,89 @@ void PacketHistory::insert(const PacketRecord &r)
 #endif
 
 #if VERBOSE_PACKET_HISTORY
-    LOG_DEBUG("Packet History - insert: Store slot@ %d/%d s=%08x id=%08x nh=%02x rby=%02x %02x %02x rxT=%d BEFORE",
-              tu - recentPackets, recentPacketsCapacity, tu->sender, tu->id, tu->next_hop, tu->relayed_by[0], tu->relayed_by[1],
-              tu->relayed_by[2], tu->rxTimeMsec);
+    LOG_DEBUG("Packet History - insert: Store slot@ %d/%d s=%08x id=%08x nh=%02x rby=%02x %02x %02x rxT=%d BEFORE", slot,
+              recentPacketsCapacity, tu->sender, tu->id, tu->next_hop, tu->relayed_by[0], tu->relayed_by[1], tu->relayed_by[2],
+              tu->rxTimeMsec);
 #endif
 
-    if (r.rxTimeMsec == 0) {
-#if VERBOSE_PACKET_HISTORY
-        LOG_WARN("Packet History - insert: I will not store packet with rxTimeMsec = 0.");
-#endif
-        return; // Return early if we can't update the history
-    }
+    if (!matched && tu->rxTimeMsec != 0)
+        hashErase(slot); // Evicting the oldest record, forget its key before it is overwritten
 
     *tu = r; // store the packet
 
+    if (!matched)
+        hashInsert(slot);
+    lruTouch(slot);
+
 #if VERBOSE_PACKET_HISTORY
-    LOG_DEBUG("Packet History - insert: Store slot@ %d/%d s=%08x id=%08x nh=%02x rby=%02x %02x %02x rxT=%d AFTER",
-              tu - recentPackets, recentPacketsCapacity, tu->sender, tu->id, tu->next_hop, tu->relayed_by[0], tu->relayed_by[1],
-              tu->relayed_by[2], tu->rxTimeMsec);
+    LOG_DEBUG("Packet History - insert: Store slot@ %d/%d s=%08x id=%08x nh=%02x rby=%02x %02x %02x rxT=%d AFTER", slot,
+              recentPacketsCapacity, tu->sender, tu->id, tu->next_hop, tu->relayed_by[0], tu->relayed_by[1], tu->relayed_by[2],
+              tu->rxTimeMsec);
 #endif
 }
 
+/** Add the record in slot s to the hash index. The key must not already be present. */
+void PacketHistory::hashInsert(Slot s)
+{
+    const PacketRecord &r = recentPackets[s];
+    uint32_t i = hashHome(r.sender, r.id);
+    while (hashSlots[i] != EMPTY_SLOT)
+        i = (i + 1) & hashMask;
+    hashSlots[i] = s;
+}
+
+/** Remove the record in slot s from the hash index, using backward shift deletion so no tombstones are needed */
+void PacketHistory::hashErase(Slot s)
+{
+    const PacketRecord &r = recentPackets[s];
+    uint32_t i = hashHome(r.sender, r.id);
+    while (hashSlots[i] != EMPTY_SLOT && hashSlots[i] != s)
+        i = (i + 1) & hashMask;
+    if (hashSlots[i] == EMPTY_SLOT)
+        return;
+
+    for (uint32_t j = (i + 1) & hashMask; hashSlots[j] != EMPTY_SLOT; j = (j + 1) & hashMask) {
+        const PacketRecord &m = recentPackets[hashSlots[j]];
+        uint32_t h = hashHome(m.sender, m.id);
+        // Only move the entry if its home is not cyclically inside (i, j]
+        if (((j - h) & hashMask) >= ((j - i) & hashMask)) {
+            hashSlots[i] = hashSlots[j];
+            i = j;
+        }
+    }
+    hashSlots[i] = EMPTY_SLOT;
+}
+
+/** Make slot s the most recently inserted record of the LRU ring, linking it in if it is new */
+void PacketHistory::lruTouch(Slot s)
+{
+    if (lruHead == EMPTY_SLOT) {
+        lruPrev[s] = lruNext[s] = s;
+        lruHead = s;
+        return;
+    }
+    if (s == lruHead)
+        return;
+    if (s == lruPrev[lruHead]) {
+        // The oldest record becomes the newest: rotating the ring is enough
+        lruHead = s;
+        return;
+    }
+
+    // Unlink if already part of the ring, a slot that was just claimed for the first time is not
+    if (lruNext[s] != EMPTY_SLOT) {
+        lruNext[lruPrev[s]] = lruNext[s];
+        lruPrev[lruNext[s]] = lruPrev[s];
+    }
+
+    Slot tail = lruPrev[lruHead];
+    lruPrev[s] = tail;
+    lruNext[s] = lruHead;
+    lruNext[tail] = s;
+    lruPrev[lruHead] = s;
+    lruHead = s;
+}
+
 /* Check if a certain node was a relayer of a packet in the history given an ID and sender
  * @return true if node was indeed a relayer, false if not */
 bool PacketHistory::wasRelayer(const uint8_t relayer, const uint32_t id, const NodeNum sender)
@@ -23,6 +23,33 @@ class PacketHistory
         0; // Can be set in constructor, no need to recompile. Used to allocate memory for mx_recentPackets.
     PacketRecord *recentPackets = NULL; // Simple and fixed in size. Debloat.
 
+    // Index into recentPackets. Kept outside PacketRecord so records stay 16B.
+#if ARCH_PORTDUINO
+    typedef uint32_t Slot;
+#else
+    typedef uint16_t Slot;
+#endif
+    static constexpr Slot EMPTY_SLOT = (Slot)-1;
+
+    // Open-addressed hash of (sender, id) -> slot in recentPackets, at most half full, linear probing
+    Slot *hashSlots = NULL;
+    uint32_t hashMask = 0;
+    uint8_t hashShift = 32;
+
+    // LRU ring through the used slots of recentPackets: lruHead is the most recently inserted, lruPrev[lruHead] the oldest
+    Slot *lruPrev = NULL;
+    Slot *lruNext = NULL;
+    Slot lruHead = EMPTY_SLOT;
+    uint32_t recentPacketsUsed = 0; // Slots [0, recentPacketsUsed) are in use, the rest have never been filled
+
+    uint32_t hashHome(NodeNum sender, PacketId id) const
+    {
+        return (uint32_t)((sender * 2654435769u) ^ (id * 2246822519u)) >> hashShift;
+    }
+    void hashInsert(Slot s);
+    void hashErase(Slot s);
+    void lruTouch(Slot s);
+
     /** Find a packet record in history.
      * @param sender NodeNum
      * @param id PacketId
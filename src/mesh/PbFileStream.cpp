@@ -0,0 +1,68 @@
+#include "PbFileStream.h"
+#include "SPILock.h"
+#include <algorithm>
+#include <string.h>
+
+#ifdef FSCom
+
+PbFileReader::PbFileReader(File &file, size_t maxSize) : stream({&read, this, maxSize}), file(file) {}
+
+bool PbFileReader::read(pb_istream_t *stream, uint8_t *buf, size_t count)
+{
+    PbFileReader *reader = (PbFileReader *)stream->state;
+
+    while (count) {
+        if (reader->pos == reader->len) {
+            int got = reader->file.read(reader->block, sizeof(reader->block));
+            reader->pos = 0;
+            reader->len = got > 0 ? got : 0;
+            if (reader->len == 0) {
+                // Like readcb, let pb_decode take the end of the file as the end of the message rather than an error
+                stream->bytes_left = 0;
+                return false;
+            }
+            reader->crc = crc32Update(reader->block, reader->len, reader->crc);
+        }
+
+        size_t n = std::min(count, reader->len - reader->pos);
+        if (buf) { // NULL means skip
+            memcpy(buf, reader->block + reader->pos, n);
+            buf += n;
+        }
+        reader->pos += n;
+        count -= n;
+    }
+    return true;
+}
+
+PbFileWriter::PbFileWriter(Print &out, size_t maxSize) : stream({&write, this, maxSize, 0}), out(out) {}
+
+bool PbFileWriter::write(pb_ostream_t *stream, const uint8_t *buf, size_t count)
+{
+    PbFileWriter *writer = (PbFileWriter *)stream->state;
+
+    while (count) {
+        size_t n = std::min(count, sizeof(writer->block) - writer->len);
+        memcpy(writer->block + writer->len, buf, n);
+        writer->len += n;
+        buf += n;
+        count -= n;
+        if (writer->len == sizeof(writer->block) && !writer->flush())
+            return false;
+    }
+    return true;
+}
+
+bool PbFileWriter::flush()
+{
+    if (len == 0)
+        return true;
+
+    crc = crc32Update(block, len, crc);
+    concurrency::LockGuard g(spiLock);
+    bool ok = out.write(block, len) == len;
+    len = 0;
+    return ok;
+}
+
+#endif
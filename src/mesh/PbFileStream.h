@@ -0,0 +1,75 @@
+#pragma once
+
+#include "FSCommon.h"
+#include "configuration.h"
+#include <ErriezCRC32.h>
+#include <pb_decode.h>
+#include <pb_encode.h>
+
+#ifdef FSCom
+
+/// Bytes moved between nanopb and the file system at a time, a multiple of the flash page size of our file systems
+#ifndef PB_FILE_BLOCK_SIZE
+#ifdef ARCH_PORTDUINO
+#define PB_FILE_BLOCK_SIZE 4096
+#else
+#define PB_FILE_BLOCK_SIZE 512
+#endif
+#endif
+
+/**
+ * A pb_istream_t that reads a File a block at a time.  nanopb asks for a few bytes per field, readcb passes each of those tiny
+ * reads to the file system.
+ *
+ * The caller should hold spiLock while decoding.
+ */
+class PbFileReader
+{
+  public:
+    /// @param maxSize the most bytes the message may have
+    PbFileReader(File &file, size_t maxSize);
+
+    /// @return CRC32 of the bytes read from the file so far, after a successful decode that is the whole file
+    uint32_t getCrc() const { return crc32Final(crc); }
+
+    pb_istream_t stream;
+
+  private:
+    File &file;
+    uint8_t block[PB_FILE_BLOCK_SIZE];
+    size_t pos = 0; // next unread byte in block
+    size_t len = 0; // bytes in block
+    uint32_t crc = CRC32_INITIAL;
+
+    static bool read(pb_istream_t *stream, uint8_t *buf, size_t count);
+};
+
+/**
+ * A pb_ostream_t that collects what nanopb writes and passes it on (usually to a SafeFile) a block at a time, taking spiLock
+ * once per block rather than once per field like writecb.
+ */
+class PbFileWriter
+{
+  public:
+    /// @param maxSize the most bytes the message may have
+    PbFileWriter(Print &out, size_t maxSize);
+
+    /// Write out what is still buffered, call this once encoding is done
+    /// @return false if out didn't take everything
+    bool flush();
+
+    /// @return CRC32 of the bytes flushed so far, after the final flush() the same as PbFileReader::getCrc() of the file
+    uint32_t getCrc() const { return crc32Final(crc); }
+
+    pb_ostream_t stream;
+
+  private:
+    Print &out;
+    uint8_t block[PB_FILE_BLOCK_SIZE];
+    size_t len = 0; // bytes in block
+    uint32_t crc = CRC32_INITIAL;
+
+    static bool write(pb_ostream_t *stream, const uint8_t *buf, size_t count);
+};
+
+#endif
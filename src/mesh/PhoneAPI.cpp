@@ -31,9 +31,6 @@
 #include "Throttle.h"
 #include <RTC.h>
 
-// Flag to indicate a heartbeat was received and we should send queue status
-bool heartbeatReceived = false;
-
 PhoneAPI::PhoneAPI()
 {
     lastContactMsec = millis();
@@ -43,6 +40,18 @@ PhoneAPI::PhoneAPI()
 PhoneAPI::~PhoneAPI()
 {
     close();
+    if (packetQueue) {
+        service->removeClientQueue(packetQueue);
+        delete packetQueue;
+    }
+}
+
+void PhoneAPI::usePrivatePacketQueue()
+{
+    if (!packetQueue) {
+        packetQueue = new PointerQueue<meshtastic_MeshPacket>(MAX_RX_TOPHONE);
+        service->addClientQueue(packetQueue);
+    }
 }
 
 void PhoneAPI::handleStartConfig()
@@ -58,7 +67,14 @@ void PhoneAPI::handleStartConfig()
     }
 
     // even if we were already connected - restart our state machine
-    if (config_nonce == SPECIAL_NONCE_ONLY_NODES) {
+    // Only nonces in the range reserved for sync tokens are looked at, any other nonce is just a nonce
+    onlyChangedNodes = NodeChangeTracker::isToken(config_nonce) && nodeDB->acceptNodeSyncToken(config_nonce, nodeSyncSince);
+    if (onlyChangedNodes || config_nonce == SPECIAL_NONCE_NODES_SYNC) {
+        // Taken before streaming, so nodes that change while we send are sent again next time
+        nodeSyncToken = nodeDB->getNodeSyncToken();
+        state = STATE_SEND_OWN_NODEINFO;
+        LOG_INFO("Client syncs %s nodes, next token=0x%08x", onlyChangedNodes ? "changed" : "all", nodeSyncToken);
+    } else if (config_nonce == SPECIAL_NONCE_ONLY_NODES) {
         // If client only wants node info, jump directly to sending nodes
         state = STATE_SEND_OWN_NODEINFO;
         LOG_INFO("Client only wants node info, skipping other config");
@@ -101,6 +117,8 @@ void PhoneAPI::close()
         fromRadioNum = 0;
         config_nonce = 0;
         config_state = 0;
+        nodeSyncToken = 0;
+        onlyChangedNodes = false;
         pauseBluetoothLogging = false;
     }
 }
@@ -252,7 +270,7 @@ size_t PhoneAPI::getFromRadio(uint8_t *buf)
             // Should allow us to resume sending NodeInfo in STATE_SEND_OTHER_NODEINFOS
             nodeInfoForPhone.num = 0;
         }
-        if (config_nonce == SPECIAL_NONCE_ONLY_NODES) {
+        if (config_nonce == SPECIAL_NONCE_ONLY_NODES || nodeSyncToken) {
             // If client only wants node info, jump directly to sending nodes
             state = STATE_SEND_OTHER_NODEINFOS;
         } else {
@@ -454,8 +472,8 @@ size_t PhoneAPI::getFromRadio(uint8_t *buf)
     case STATE_SEND_FILEMANIFEST: {
         LOG_DEBUG("FromRadio=STATE_SEND_FILEMANIFEST");
         // last element
-        if (config_state == filesManifest.size() ||
-            config_nonce == SPECIAL_NONCE_ONLY_NODES) { // also handles an empty filesManifest
+        if (config_state == filesManifest.size() || config_nonce == SPECIAL_NONCE_ONLY_NODES ||
+            nodeSyncToken) { // also handles an empty filesManifest
             config_state = 0;
             filesManifest.clear();
             // Skip to complete packet
@@ -521,12 +539,31 @@ size_t PhoneAPI::getFromRadio(uint8_t *buf)
     return 0;
 }
 
+size_t PhoneAPI::getFromRadioDelimited(uint8_t *buf)
+{
+    static_assert(MAX_TO_FROM_RADIO_SIZE < 0x4000, "FromRadio length must fit in a 2 byte varint");
+
+    size_t len = getFromRadio(buf + 2);
+    if (len == 0)
+        return 0;
+    if (len < 0x80) {
+        buf[0] = len;
+        memmove(buf + 1, buf + 2, len);
+        return len + 1;
+    }
+    buf[0] = 0x80 | (len & 0x7f);
+    buf[1] = len >> 7;
+    return len + 2;
+}
+
 void PhoneAPI::sendConfigComplete()
 {
     LOG_INFO("Config Send Complete");
     fromRadioScratch.which_payload_variant = meshtastic_FromRadio_config_complete_id_tag;
-    fromRadioScratch.config_complete_id = config_nonce;
+    fromRadioScratch.config_complete_id = nodeSyncToken ? nodeSyncToken : config_nonce;
     config_nonce = 0;
+    nodeSyncToken = 0;
+    onlyChangedNodes = false;
     state = STATE_SEND_PACKETS;
     pauseBluetoothLogging = false;
 }
@@ -586,6 +623,9 @@ bool PhoneAPI::available()
     case STATE_SEND_OTHER_NODEINFOS:
         if (nodeInfoForPhone.num == 0) {
             auto nextNode = nodeDB->readNextMeshNode(readIndex);
+            // The client already has the nodes that didn't change
+            while (nextNode && onlyChangedNodes && !nodeDB->nodeChangedSince(nextNode, nodeSyncSince))
+                nextNode = nodeDB->readNextMeshNode(readIndex);
             if (nextNode) {
                 nodeInfoForPhone = TypeConversions::ConvertToNodeInfo(nextNode);
                 bool isUs = nodeInfoForPhone.num == nodeDB->getNodeNum();
@@ -626,7 +666,7 @@ bool PhoneAPI::available()
 #endif
 
         if (!packetForPhone)
-            packetForPhone = service->getForPhone();
+            packetForPhone = packetQueue ? packetQueue->dequeuePtr(0) : service->getForPhone();
         hasPacket = !!packetForPhone;
         return hasPacket;
     }
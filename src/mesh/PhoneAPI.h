@@ -1,6 +1,8 @@
 #pragma once
 
+#include "NodeChangeTracker.h"
 #include "Observer.h"
+#include "PointerQueue.h"
 #include "mesh-pb-constants.h"
 #include "meshtastic/portnums.pb.h"
 #include <iterator>
@@ -18,8 +20,17 @@
 #error "meshtastic_ToRadio_size is too large for our BLE packets"
 #endif
 
+// A FromRadio prefixed by its length as a varint, which always fits in 2 bytes
+#define MAX_DELIMITED_FROM_RADIO_SIZE (MAX_TO_FROM_RADIO_SIZE + 2)
+
 #define SPECIAL_NONCE_ONLY_CONFIG 69420
 #define SPECIAL_NONCE_ONLY_NODES 69421 // ( ͡° ͜ʖ ͡°)
+// Like SPECIAL_NONCE_ONLY_NODES, but config_complete_id carries a node sync token instead of the nonce.  Sending that token as
+// want_config_id on a later connection gets only the nodes changed since.  Tokens are always 0xaxxxxxxx (see
+// NodeChangeTracker::TOKEN_MARKER), nonces outside that range are never taken for one.  A token we no longer accept (we
+// rebooted, or nodes were removed) is treated like any other nonce: the full config is sent and the token echoed back, the
+// client should then drop its cached nodes and start over with this nonce.
+#define SPECIAL_NONCE_NODES_SYNC 69422
 
 /**
  * Provides our protobuf based API which phone/PC clients can use to talk to our device
@@ -65,6 +76,12 @@ class PhoneAPI
     /// downloads it
     meshtastic_MeshPacket *packetForPhone = NULL;
 
+    /// Our own queue of packets for the phone, if we share the device with other clients (see usePrivatePacketQueue)
+    PointerQueue<meshtastic_MeshPacket> *packetQueue = NULL;
+
+    /// The client sent a heartbeat, answer with the queue status
+    bool heartbeatReceived = false;
+
     // file transfer packets destined for phone. Push it to the queue then free it.
     meshtastic_XModem xmodemPacketForPhone = meshtastic_XModem_init_zero;
 
@@ -87,6 +104,12 @@ class PhoneAPI
     uint32_t config_nonce = 0;
     uint32_t readIndex = 0;
 
+    /// Node sync token to answer with in config_complete_id, 0 unless the client asked for a node sync
+    uint32_t nodeSyncToken = 0;
+    /// Only send nodes changed since nodeSyncSince, the client has the rest cached
+    bool onlyChangedNodes = false;
+    NodeChangeTracker::Generation nodeSyncSince = 0;
+
     std::vector<meshtastic_FileInfo> filesManifest = {};
 
     void resetReadIndex() { readIndex = 0; }
@@ -120,6 +143,14 @@ class PhoneAPI
      */
     size_t getFromRadio(uint8_t *buf);
 
+    /**
+     * Like getFromRadio, but the FromRadio is prefixed by its length as a varint (protobuf's delimited format), so several can be
+     * sent back to back, e.g. in one HTTP response.
+     *
+     * We assume buf is at least MAX_DELIMITED_FROM_RADIO_SIZE bytes long.
+     */
+    size_t getFromRadioDelimited(uint8_t *buf);
+
     void sendConfigComplete();
 
     /**
@@ -153,6 +184,10 @@ class PhoneAPI
     /// begin a new connection
     void handleStartConfig();
 
+    /// Receive every packet for the phone into a queue of our own, for transports where several clients are connected at once.
+    /// Otherwise clients take packets from the one shared queue, and each sees only some of them.
+    void usePrivatePacketQueue();
+
   private:
     void releasePhonePacket();
 
@@ -353,6 +353,7 @@ void RadioLibInterface::clampToLateRebroadcastWindow(NodeNum from, PacketId id)
     // Look for non-late packets only, so we don't do this twice!
     meshtastic_MeshPacket *p = txQueue.remove(from, id, true, false);
     if (p) {
+        p = packetPool.unshare(p); // a retransmission shares its packet with the pending record, which must not change
         p->tx_after = millis() + getTxDelayMsecWeightedWorst(p->rx_snr);
         if (txQueue.enqueue(p)) {
             LOG_DEBUG("Move existing queued packet to the late rebroadcast window %dms from now", p->tx_after - millis());
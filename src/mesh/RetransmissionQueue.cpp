@@ -0,0 +1,96 @@
+#include "RetransmissionQueue.h"
+#include <assert.h>
+
+void RetransmissionQueue::siftUp(size_t pos)
+{
+    PendingPacket *p = heap[pos];
+    while (pos > 0) {
+        size_t parent = (pos - 1) / 2;
+        if (!before(p, heap[parent]))
+            break;
+        heap[pos] = heap[parent];
+        heap[pos]->heapPos = pos;
+        pos = parent;
+    }
+    heap[pos] = p;
+    p->heapPos = pos;
+}
+
+void RetransmissionQueue::siftDown(size_t pos)
+{
+    PendingPacket *p = heap[pos];
+    size_t n = heap.size();
+    while (true) {
+        size_t child = 2 * pos + 1;
+        if (child >= n)
+            break;
+        if (child + 1 < n && before(heap[child + 1], heap[child]))
+            child++;
+        if (!before(heap[child], p))
+            break;
+        heap[pos] = heap[child];
+        heap[pos]->heapPos = pos;
+        pos = child;
+    }
+    heap[pos] = p;
+    p->heapPos = pos;
+}
+
+void RetransmissionQueue::schedule(PendingPacket *p, uint32_t delayMsec, uint32_t now)
+{
+    p->nextTxMsec = clock(now) + delayMsec;
+    if (p->heapPos == PendingPacket::NOT_QUEUED) {
+        assert(heap.size() < PendingPacket::NOT_QUEUED);
+        heap.push_back(p);
+        siftUp(heap.size() - 1);
+    } else {
+        // May have moved either way
+        siftUp(p->heapPos);
+        siftDown(p->heapPos);
+    }
+}
+
+void RetransmissionQueue::remove(PendingPacket *p)
+{
+    size_t pos = p->heapPos;
+    if (pos == PendingPacket::NOT_QUEUED)
+        return;
+    assert(pos < heap.size() && heap[pos] == p);
+
+    p->heapPos = PendingPacket::NOT_QUEUED;
+    PendingPacket *last = heap.back();
+    heap.pop_back();
+    if (last != p) {
+        heap[pos] = last;
+        last->heapPos = pos;
+        siftUp(pos);
+        siftDown(last->heapPos);
+    }
+}
+
+PendingPacket *RetransmissionQueue::popDue(uint32_t now)
+{
+    if (heap.empty() || (int32_t)(heap[0]->nextTxMsec - clock(now)) > 0)
+        return NULL;
+    PendingPacket *p = heap[0];
+    remove(p);
+    return p;
+}
+
+int32_t RetransmissionQueue::msecUntilNext(uint32_t now) const
+{
+    if (heap.empty())
+        return INT32_MAX;
+    int32_t d = heap[0]->nextTxMsec - clock(now);
+    return d > 0 ? d : 0;
+}
+
+void RetransmissionQueue::delayAll(uint32_t msec, PendingPacket *except)
+{
+    delayed += msec;
+    if (except && except->heapPos != PendingPacket::NOT_QUEUED) {
+        // Its deadline stays where it was in millis() time, so it moves earlier in ours
+        except->nextTxMsec -= msec;
+        siftUp(except->heapPos);
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "MeshTypes.h"
+
+#include <vector>
+
+/**
+ * A packet queued for retransmission
+ */
+struct PendingPacket {
+    /** Decoded until it is first sent, from then on the encrypted form that went on the air */
+    meshtastic_MeshPacket *packet;
+
+    /** Channel index the packet was sent on (packet->channel turns into the channel hash once encrypted) */
+    uint8_t channel = 0;
+
+    /** The next time we should try to retransmit this packet, in RetransmissionQueue time (see there) */
+    uint32_t nextTxMsec = 0;
+
+    /** Starts at NUM_RETRANSMISSIONS -1 and counts down.  Once zero it will be removed from the list */
+    uint8_t numRetransmissions = 0;
+
+    /** Where this packet sits in the RetransmissionQueue heap, NOT_QUEUED if it is not scheduled */
+    uint16_t heapPos = NOT_QUEUED;
+
+    static constexpr uint16_t NOT_QUEUED = UINT16_MAX;
+
+    PendingPacket() {}
+    explicit PendingPacket(meshtastic_MeshPacket *p, uint8_t numRetransmissions);
+};
+
+/**
+ * Retransmission deadlines of pending packets, earliest first.
+ *
+ * A binary min-heap of the records, so finding out that nothing is due (the common case) is O(1) and each due packet costs
+ * O(log n), instead of a walk over every pending packet.  Deadlines are compared as signed differences, so they keep their
+ * order across the 49 day millis() rollover as long as they are less than 24 days apart.
+ *
+ * Every pending retransmission gets pushed back by the airtime of each packet we send or receive.  Rather than touching every
+ * record, deadlines are kept in a clock that runs behind millis() by the total delay so far, delayAll() just moves that clock.
+ *
+ * The queue does not own the records, they must stay put while queued and be remove()d before they go away.
+ */
+class RetransmissionQueue
+{
+  public:
+    /// (Re)schedule p to be due delayMsec after now
+    void schedule(PendingPacket *p, uint32_t delayMsec, uint32_t now);
+
+    /// Take p out of the queue, if it is queued
+    void remove(PendingPacket *p);
+
+    /// @return the earliest record due at now, taken out of the queue, or NULL if none is due yet
+    PendingPacket *popDue(uint32_t now);
+
+    /// @return the number of msecs until the next record is due (0 if overdue), or INT32_MAX if the queue is empty
+    int32_t msecUntilNext(uint32_t now) const;
+
+    /// Push every queued deadline, except the one of 'except', back by msec
+    void delayAll(uint32_t msec, PendingPacket *except = NULL);
+
+    size_t size() const { return heap.size(); }
+
+  private:
+    std::vector<PendingPacket *> heap; // heap[0] is due first
+    uint32_t delayed = 0;              // total delayAll() so far, deadlines are in millis() - delayed
+
+    uint32_t clock(uint32_t now) const { return now - delayed; }
+
+    static bool before(const PendingPacket *a, const PendingPacket *b)
+    {
+        return (int32_t)(a->nextTxMsec - b->nextTxMsec) < 0; // wraparound safe
+    }
+
+    void siftUp(size_t pos);
+    void siftDown(size_t pos);
+};
@@ -11,6 +11,7 @@
 #include "mesh-pb-constants.h"
 #include "meshUtils.h"
 #include "modules/RoutingModule.h"
+#include <pb_decode.h>
 #if !MESHTASTIC_EXCLUDE_MQTT
 #include "mqtt/MQTT.h"
 #endif
@@ -31,13 +32,29 @@
     (MAX_RX_TOPHONE + MAX_RX_FROMRADIO + 2 * MAX_TX_QUEUE +                                                                      \
      2) // max number of packets which can be in flight (either queued from reception or queued for sending)
 
-// static MemoryPool<MeshPacket> staticPool(MAX_PACKETS);
-static MemoryDynamic<meshtastic_MeshPacket> staticPool;
+static MemoryPool<meshtastic_MeshPacket> staticPool(MAX_PACKETS);
 
 Allocator<meshtastic_MeshPacket> &packetPool = staticPool;
+MemoryPool<meshtastic_MeshPacket> &packetSlabPool = staticPool;
 
 static uint8_t bytes[MAX_LORA_PAYLOAD_LEN + 1] __attribute__((__aligned__));
 
+#if ENABLE_JSON_LOGGING || ARCH_PORTDUINO
+/// Log p as JSON at trace level, serialized on the stack rather than the heap unless it is too big for that
+static void traceJson(const meshtastic_MeshPacket *p, bool encrypted)
+{
+    char json[MESHPACKET_JSON_SIZE];
+    size_t length = encrypted ? MeshPacketSerializer::JsonSerializeEncrypted(p, json, sizeof(json))
+                              : MeshPacketSerializer::JsonSerialize(p, json, sizeof(json), false);
+    if (length > 0)
+        LOG_TRACE("%s", json);
+    else if (encrypted)
+        LOG_TRACE("%s", MeshPacketSerializer::JsonSerializeEncrypted(p).c_str());
+    else
+        LOG_TRACE("%s", MeshPacketSerializer::JsonSerialize(p, false).c_str());
+}
+#endif
+
 /**
  * Constructor
  *
@@ -208,19 +225,11 @@ ErrorCode Router::rawSend(meshtastic_MeshPacket *p)
 }
 
 /**
- * Send a packet on a suitable interface.  This routine will
- * later free() the packet to pool.  This routine is not allowed to stall.
- * If the txmit queue is full it might return an error.
+ * Drop p, and tell whoever needs to know, if sending it now would violate the duty cycle.
+ * @return the error p was dropped with, or meshtastic_Routing_Error_NONE if it may be sent
  */
-ErrorCode Router::send(meshtastic_MeshPacket *p)
+meshtastic_Routing_Error Router::perhapsAbortForDutyCycle(meshtastic_MeshPacket *p)
 {
-    if (isToUs(p)) {
-        LOG_ERROR("BUG! send() called with packet destined for local node!");
-        packetPool.release(p);
-        return meshtastic_Routing_Error_BAD_REQUEST;
-    } // should have already been handled by sendLocal
-
-    // Abort sending if we are violating the duty cycle
     if (!config.lora.override_duty_cycle && myRegion->dutyCycle < 100) {
         float hourlyTxPercent = airTime->utilizationTXPercent();
         if (hourlyTxPercent > myRegion->dutyCycle) {
@@ -245,6 +254,25 @@ ErrorCode Router::send(meshtastic_MeshPacket *p)
             return err;
         }
     }
+    return meshtastic_Routing_Error_NONE;
+}
+
+/**
+ * Send a packet on a suitable interface.  This routine will
+ * later free() the packet to pool.  This routine is not allowed to stall.
+ * If the txmit queue is full it might return an error.
+ */
+ErrorCode Router::send(meshtastic_MeshPacket *p)
+{
+    if (isToUs(p)) {
+        LOG_ERROR("BUG! send() called with packet destined for local node!");
+        packetPool.release(p);
+        return meshtastic_Routing_Error_BAD_REQUEST;
+    } // should have already been handled by sendLocal
+
+    auto dutyCycleErr = perhapsAbortForDutyCycle(p);
+    if (dutyCycleErr != meshtastic_Routing_Error_NONE)
+        return dutyCycleErr;
 
     // PacketId nakId = p->decoded.which_ackVariant == SubPacket_fail_id_tag ? p->decoded.ackVariant.fail_id : 0;
     // assert(!nakId); // I don't think we ever send 0hop naks over the wire (other than to the phone), test that assumption with
@@ -299,10 +327,24 @@ ErrorCode Router::send(meshtastic_MeshPacket *p)
     }
 #endif
 
+    sniffSent(p);
+
     assert(iface); // This should have been detected already in sendLocal (or we just received a packet from outside)
     return iface->send(p);
 }
 
+ErrorCode Router::resend(meshtastic_MeshPacket *p)
+{
+    auto dutyCycleErr = perhapsAbortForDutyCycle(p);
+    if (dutyCycleErr != meshtastic_Routing_Error_NONE)
+        return dutyCycleErr;
+
+    sniffSent(p);
+
+    assert(iface);
+    return iface->send(p);
+}
+
 /** Attempt to cancel a previously sent packet.  Returns true if a packet was found we could cancel */
 bool Router::cancelSending(NodeNum from, PacketId id)
 {
@@ -329,6 +371,32 @@ void Router::sniffReceived(const meshtastic_MeshPacket *p, const meshtastic_Rout
     // FIXME, update nodedb here for any packet that passes through us
 }
 
+/**
+ * Cheap check whether decrypted bytes could be a meshtastic_Data, before paying for a full decode.  Walks the protobuf wire
+ * format without storing anything and requires a non zero portnum (a wrong key yields noise, which almost never survives this).
+ */
+static bool looksLikeData(const uint8_t *buf, size_t len)
+{
+    pb_istream_t stream = pb_istream_from_buffer(buf, len);
+    bool hasPortnum = false;
+    while (stream.bytes_left) {
+        pb_wire_type_t wireType;
+        uint32_t tag;
+        bool eof;
+        if (!pb_decode_tag(&stream, &wireType, &tag, &eof))
+            return false;
+        if (tag == meshtastic_Data_portnum_tag && wireType == PB_WT_VARINT) {
+            uint64_t portnum;
+            if (!pb_decode_varint(&stream, &portnum))
+                return false;
+            hasPortnum = portnum != meshtastic_PortNum_UNKNOWN_APP;
+        } else if (!pb_skip_field(&stream, wireType)) {
+            return false;
+        }
+    }
+    return hasPortnum;
+}
+
 DecodeState perhapsDecode(meshtastic_MeshPacket *p)
 {
     concurrency::LockGuard g(cryptLock);
@@ -388,19 +456,26 @@ DecodeState perhapsDecode(meshtastic_MeshPacket *p)
 
     // assert(p->which_payloadVariant == MeshPacket_encrypted_tag);
     if (!decrypted) {
-        // Try to find a channel that works with this hash
-        for (chIndex = 0; chIndex < channels.getNumChannels(); chIndex++) {
+        // Try to find a channel that works with this hash, only channels whose hash matches are worth an AES pass
+        uint8_t candidates = channels.getChannelsForHash(p->channel);
+        uint32_t attempts = 0;
+        for (chIndex = 0; candidates && chIndex < channels.getNumChannels(); chIndex++, candidates >>= 1) {
             // Try to use this hash/channel pair
-            if (channels.decryptForHash(chIndex, p->channel)) {
+            if ((candidates & 1) && channels.decryptForHash(chIndex, p->channel)) {
                 // we have to copy into a scratch buffer, because these bytes are a union with the decoded protobuf. Create a
                 // fresh copy for each decrypt attempt.
                 memcpy(bytes, p->encrypted.bytes, rawSize);
                 // Try to decrypt the packet if we can
                 crypto->decrypt(p->from, p->id, rawSize, bytes);
+                attempts++;
 
                 // printBytes("plaintext", bytes, p->encrypted.size);
 
                 // Take those raw bytes and convert them back into a well structured protobuf we can understand
+                if (!looksLikeData(bytes, rawSize)) {
+                    LOG_ERROR("Invalid protobufs in received mesh packet id=0x%08x (bad psk?)!", p->id);
+                    continue;
+                }
                 meshtastic_Data decodedtmp;
                 memset(&decodedtmp, 0, sizeof(decodedtmp));
                 if (!pb_decode_from_bytes(bytes, rawSize, &meshtastic_Data_msg, &decodedtmp)) {
@@ -415,6 +490,12 @@ DecodeState perhapsDecode(meshtastic_MeshPacket *p)
                 }
             }
         }
+        if (router && attempts) {
+            router->rxDecryptAttempts += attempts;
+            router->rxDecryptPackets++;
+        }
+        if (attempts > 1)
+            LOG_DEBUG("Packet id=0x%08x took %u decrypt attempts", p->id, attempts);
     }
     if (decrypted) {
         // parsing was successful
@@ -444,10 +525,10 @@ DecodeState perhapsDecode(meshtastic_MeshPacket *p)
 
         printPacket("decoded message", p);
 #if ENABLE_JSON_LOGGING
-        LOG_TRACE("%s", MeshPacketSerializer::JsonSerialize(p, false).c_str());
+        traceJson(p, false);
 #elif ARCH_PORTDUINO
         if (settingsStrings[traceFilename] != "" || settingsMap[logoutputlevel] == level_trace) {
-            LOG_TRACE("%s", MeshPacketSerializer::JsonSerialize(p, false).c_str());
+            traceJson(p, false);
         }
 #endif
         return DecodeState::DECODE_SUCCESS;
@@ -682,12 +763,12 @@ void Router::perhapsHandleReceived(meshtastic_MeshPacket *p)
 #if ENABLE_JSON_LOGGING
     // Even ignored packets get logged in the trace
     p->rx_time = getValidTime(RTCQualityFromNet); // store the arrival timestamp for the phone
-    LOG_TRACE("%s", MeshPacketSerializer::JsonSerializeEncrypted(p).c_str());
+    traceJson(p, true);
 #elif ARCH_PORTDUINO
     // Even ignored packets get logged in the trace
     if (settingsStrings[traceFilename] != "" || settingsMap[logoutputlevel] == level_trace) {
         p->rx_time = getValidTime(RTCQualityFromNet); // store the arrival timestamp for the phone
-        LOG_TRACE("%s", MeshPacketSerializer::JsonSerializeEncrypted(p).c_str());
+        traceJson(p, true);
     }
 #endif
     // assert(radioConfig.has_preferences);
@@ -87,10 +87,22 @@ class Router : protected concurrency::OSThread, protected PacketHistory
     virtual ErrorCode send(meshtastic_MeshPacket *p);
     virtual ErrorCode rawSend(meshtastic_MeshPacket *p);
 
+    /**
+     * Send again a packet that went through send() before, exactly as it went on the air.  Nothing but the duty cycle is
+     * checked and the packet isn't modified, so it may be shared with whoever keeps it for the next try.
+     *
+     * NOTE: This method will free the provided packet (even if we return an error code)
+     */
+    ErrorCode resend(meshtastic_MeshPacket *p);
+
     /* Statistics for the amount of duplicate received packets and the amount of times we cancel a relay because someone did it
         before us */
     uint32_t rxDupe = 0, txRelayCanceled = 0;
 
+    /* Statistics for channel decryption: packets we tried to decrypt with a channel key and how many AES passes (candidate
+        channels) that took in total */
+    uint32_t rxDecryptPackets = 0, rxDecryptAttempts = 0;
+
   protected:
     friend class RoutingModule;
 
@@ -110,6 +122,12 @@ class Router : protected concurrency::OSThread, protected PacketHistory
      */
     virtual void sniffReceived(const meshtastic_MeshPacket *p, const meshtastic_Routing *c);
 
+    /**
+     * Every packet this node sends over the radio will be passed through this method, encoded and encrypted as it goes on the
+     * air, just before it is handed to the interface.
+     */
+    virtual void sniffSent(const meshtastic_MeshPacket *p) {}
+
     /**
      * Send an ack or a nak packet back towards whoever sent idFrom
      */
@@ -138,6 +156,9 @@ class Router : protected concurrency::OSThread, protected PacketHistory
 
     /** Frees the provided packet, and generates a NAK indicating the specifed error while sending */
     void abortSendAndNak(meshtastic_Routing_Error err, meshtastic_MeshPacket *p);
+
+    /** Frees the provided packet if sending it would violate the duty cycle, see send() */
+    meshtastic_Routing_Error perhapsAbortForDutyCycle(meshtastic_MeshPacket *p);
 };
 
 enum DecodeState { DECODE_SUCCESS, DECODE_FAILURE, DECODE_FATAL };
@@ -49,7 +49,9 @@ void StreamAPI::writeStream()
     if (canWrite) {
         uint32_t len;
         do {
-            // Send every packet we can
+            // Send every packet we can, as long as the stream has room for it
+            if (txSpace() < MAX_STREAM_BUF_SIZE)
+                break;
             len = getFromRadio(txBuf + HEADER_LEN);
             emitTxBuffer(len);
         } while (len);
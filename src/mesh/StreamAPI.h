@@ -4,6 +4,7 @@
 #include "Stream.h"
 #include "concurrency/OSThread.h"
 #include <cstdarg>
+#include <cstdint>
 
 // A To/FromRadio packet + our 32 bit header
 #define MAX_STREAM_BUF_SIZE (MAX_TO_FROM_RADIO_SIZE + sizeof(uint32_t))
@@ -84,6 +85,10 @@ class StreamAPI : public PhoneAPI
     /// Are we allowed to write packets to our output stream (subclasses can turn this off - i.e. SerialConsole)
     bool canWrite = true;
 
+    /// How many bytes the stream can take right now.  writeStream() stops once a whole packet might not fit, so transports
+    /// with bounded output buffers don't have to block.
+    virtual size_t txSpace() { return SIZE_MAX; }
+
     /// Subclasses can use this scratch buffer if they wish
     uint8_t txBuf[MAX_STREAM_BUF_SIZE] = {0};
 
@@ -0,0 +1,202 @@
+#include "configuration.h"
+
+#if ARCH_PORTDUINO
+#include "PosixServerAPI.h"
+#include "WiFiServerAPI.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+// Output a session may have waiting for its socket before it stops producing packets
+#define SESSION_TX_LIMIT (4 * MAX_STREAM_BUF_SIZE)
+
+static PosixServerPort *apiPort;
+
+void initApiServer(int port)
+{
+    if (!apiPort) {
+        apiPort = new PosixServerPort(port);
+        if (apiPort->init())
+            LOG_INFO("API server listen on TCP port %d", apiPort->getPort());
+    }
+}
+
+void deInitApiServer()
+{
+    if (apiPort) {
+        delete apiPort;
+        apiPort = nullptr;
+    }
+}
+
+static bool wouldBlock()
+{
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+}
+
+size_t SocketStream::write(const uint8_t *buffer, size_t size)
+{
+    out.insert(out.end(), buffer, buffer + size);
+    return size;
+}
+
+bool SocketStream::sendTo(int fd)
+{
+    while (sent < out.size()) {
+        ssize_t n = send(fd, out.data() + sent, out.size() - sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (!wouldBlock())
+                return false;
+            break;
+        }
+        sent += n;
+    }
+    if (sent == out.size())
+        out.clear();
+    else
+        out.erase(out.begin(), out.begin() + sent);
+    sent = 0;
+    return true;
+}
+
+PosixServerAPI::PosixServerAPI(int fd) : StreamAPI(&stream), fd(fd)
+{
+    LOG_INFO("Incoming API connection");
+    usePrivatePacketQueue(); // Other clients may be connected at the same time
+}
+
+PosixServerAPI::~PosixServerAPI()
+{
+    ::close(fd);
+}
+
+void PosixServerAPI::close()
+{
+    closed = true;
+    StreamAPI::close();
+}
+
+size_t PosixServerAPI::txSpace()
+{
+    return stream.pending() < SESSION_TX_LIMIT ? SESSION_TX_LIMIT - stream.pending() : 0;
+}
+
+PosixServerPort::PosixServerPort(int port) : concurrency::OSThread("ApiServer"), port(port) {}
+
+PosixServerPort::~PosixServerPort()
+{
+    for (auto session : sessions)
+        delete session;
+    if (listenFd >= 0)
+        ::close(listenFd);
+}
+
+bool PosixServerPort::init()
+{
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        LOG_ERROR("Can't create API server socket, errno=%d", errno);
+        return false;
+    }
+
+    int one = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    socklen_t addrLen = sizeof(addr);
+    if (bind(listenFd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(listenFd, SOMAXCONN) < 0 ||
+        getsockname(listenFd, (struct sockaddr *)&addr, &addrLen) < 0) {
+        LOG_ERROR("Can't listen on TCP port %d, errno=%d", port, errno);
+        ::close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    fcntl(listenFd, F_SETFL, fcntl(listenFd, F_GETFL) | O_NONBLOCK);
+    port = ntohs(addr.sin_port);
+    return true;
+}
+
+void PosixServerPort::acceptClients()
+{
+    int fd;
+    while ((fd = accept(listenFd, NULL, NULL)) >= 0) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)); // Our packets are small and already batched
+
+        if (sessions.size() == MAX_API_CLIENTS) {
+            LOG_INFO("Force close oldest TCP connection");
+            delete sessions.front();
+            sessions.erase(sessions.begin());
+        }
+        sessions.push_back(new PosixServerAPI(fd));
+        LOG_INFO("%u of %d API connections in use", (unsigned)sessions.size(), MAX_API_CLIENTS);
+    }
+    if (!wouldBlock())
+        LOG_WARN("API server accept failed, errno=%d", errno);
+}
+
+int32_t PosixServerPort::serviceClients()
+{
+    if (listenFd < 0)
+        return disable();
+
+    fds.resize(sessions.size() + 1);
+    fds[0] = {listenFd, POLLIN, 0};
+    for (size_t i = 0; i < sessions.size(); i++)
+        fds[i + 1] = {sessions[i]->getFd(), (short)(POLLIN | (sessions[i]->hasOutput() ? POLLOUT : 0)), 0};
+    if (poll(fds.data(), fds.size(), 0) < 0) {
+        if (!wouldBlock())
+            LOG_ERROR("API server poll failed, errno=%d", errno);
+        return 100;
+    }
+
+    int32_t delay = 100; // only check occasionally for incoming connections
+    size_t n = sessions.size();
+    for (size_t k = 0; k < n; k++) {
+        size_t i = (firstServed + k) % n;
+        PosixServerAPI *session = sessions[i];
+        short revents = fds[i + 1].revents;
+        bool ok = !(revents & (POLLERR | POLLNVAL));
+
+        int32_t wanted = 0;
+        if (ok && (revents & (POLLIN | POLLHUP))) {
+            ssize_t got = recv(session->getFd(), rxChunk, sizeof(rxChunk), 0);
+            if (got > 0)
+                wanted = session->runOncePart(rxChunk, got);
+            else
+                ok = got < 0 && wouldBlock(); // 0 is the client hanging up
+        } else if (ok) {
+            wanted = session->runOncePart(rxChunk, 0); // Nothing to read, but there may be packets to send
+        }
+        ok = ok && session->flushOutput() && !session->isClosed();
+
+        if (!ok) {
+            LOG_INFO("Client dropped connection, close API session");
+            delete session;
+            sessions[i] = NULL;
+        } else {
+            delay = std::min(delay, session->hasOutput() ? 5 : wanted);
+        }
+    }
+    sessions.erase(std::remove(sessions.begin(), sessions.end(), nullptr), sessions.end());
+    firstServed = sessions.empty() ? 0 : (firstServed + 1) % sessions.size();
+
+    if (fds[0].revents & POLLIN)
+        acceptClients();
+    return delay;
+}
+
+#endif
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "ServerAPI.h"
+
+#if ARCH_PORTDUINO
+#include <poll.h>
+#include <vector>
+
+/**
+ * The output side of a client socket.  What StreamAPI writes is buffered here, and sent when poll() says the socket can take
+ * more, so a slow client never blocks the others.  Input doesn't come through here: the server reads the socket and hands the
+ * bytes to the session.
+ */
+class SocketStream : public Stream
+{
+  public:
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    using Print::write;
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override;
+
+    /// Bytes written but not sent yet
+    size_t pending() const { return out.size() - sent; }
+
+    /// Send as much as the socket takes without blocking
+    /// @return false if the connection failed
+    bool sendTo(int fd);
+
+  private:
+    std::vector<uint8_t> out;
+    size_t sent = 0; // bytes at the front of out already sent
+};
+
+/**
+ * One API client connected over TCP.  Unlike ServerAPI this isn't a thread of its own, PosixServerPort drives every session
+ * from one poll() loop.
+ */
+class PosixServerAPI : public StreamAPI
+{
+  public:
+    explicit PosixServerAPI(int fd);
+
+    /// Closes the socket
+    virtual ~PosixServerAPI();
+
+    /// override close to also end the session, the server then drops it
+    virtual void close() override;
+
+    int getFd() const { return fd; }
+    bool isClosed() const { return closed; }
+    bool hasOutput() const { return stream.pending() > 0; }
+
+    /// @return false if the connection failed
+    bool flushOutput() { return stream.sendTo(fd); }
+
+  protected:
+    /// Like ServerAPI, don't publish EVENT_SERIAL_CONNECTED/DISCONNECTED for network links
+    virtual void onConnectionChanged(bool connected) override {}
+
+    virtual bool checkIsConnected() override { return !closed; }
+
+    /// Stop producing packets once a few are waiting for the socket
+    virtual size_t txSpace() override;
+
+  private:
+    SocketStream stream;
+    int fd;
+    bool closed = false;
+};
+
+/**
+ * Listens for API clients and serves all of them from one thread: each run poll()s the listening socket and every session
+ * without waiting, reads at most one chunk per session and lets each one write only as much as its bounded output buffer takes.
+ * Sessions take turns going first.  Up to MAX_API_CLIENTS are served, a new client beyond that replaces the oldest one.
+ */
+class PosixServerPort : private concurrency::OSThread
+{
+  public:
+    explicit PosixServerPort(int port);
+    ~PosixServerPort();
+
+    /// Start listening
+    /// @return false if the port couldn't be opened
+    bool init();
+
+    /// @return the port we listen on (the one the OS picked, if we were asked for port 0)
+    int getPort() const { return port; }
+
+    size_t getNumClients() const { return sessions.size(); }
+
+    /// Accept new clients and give every session one turn
+    /// @return msecs until there is likely more to do
+    int32_t serviceClients();
+
+  protected:
+    virtual int32_t runOnce() override { return serviceClients(); }
+
+  private:
+    int port;
+    int listenFd = -1;
+    std::vector<PosixServerAPI *> sessions; // oldest first
+    std::vector<struct pollfd> fds;         // listenFd, then one per session, reused between runs
+    size_t firstServed = 0;                 // rotates, so no session always goes first
+    char rxChunk[1024];
+
+    void acceptClients();
+};
+
+#endif
@@ -6,6 +6,9 @@ template <typename T>
 ServerAPI<T>::ServerAPI(T &_client) : StreamAPI(&client), concurrency::OSThread("ServerAPI"), client(_client)
 {
     LOG_INFO("Incoming API connection");
+#if MAX_API_CLIENTS > 1
+    usePrivatePacketQueue(); // Other clients may be connected at the same time
+#endif
 }
 
 template <typename T> ServerAPI<T>::~ServerAPI()
@@ -57,8 +60,18 @@ template <class T, class U> int32_t APIServerPort<T, U>::runOnce()
     auto client = U::available();
 #endif
     if (client) {
-        // Close any previous connection (see FIXME in header file)
-        if (openAPI) {
+        // Reuse the slots of connections that dropped
+        size_t kept = 0;
+        for (size_t i = 0; i < numOpen; i++) {
+            if (openAPIs[i]->isClientConnected())
+                openAPIs[kept++] = openAPIs[i];
+            else
+                delete openAPIs[i];
+        }
+        numOpen = kept;
+
+        // Close the oldest connection if we are full
+        if (numOpen == MAX_API_CLIENTS) {
 #if RAK_4631
             // RAK13800 Ethernet requests periodically take more time
             // This backoff addresses most cases keeping max wait < 1s
@@ -70,10 +83,14 @@ template <class T, class U> int32_t APIServerPort<T, U>::runOnce()
             }
 #endif
             LOG_INFO("Force close previous TCP connection");
-            delete openAPI;
+            delete openAPIs[0];
+            numOpen--;
+            for (size_t i = 0; i < numOpen; i++)
+                openAPIs[i] = openAPIs[i + 1];
         }
 
-        openAPI = new T(client);
+        openAPIs[numOpen++] = new T(client);
+        LOG_INFO("%u of %d API connections in use", (unsigned)numOpen, MAX_API_CLIENTS);
     }
 
 #if RAK_4631
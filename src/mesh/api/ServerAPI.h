@@ -4,6 +4,17 @@
 
 #define SERVER_API_DEFAULT_PORT 4403
 
+// How many API clients can be connected at once.  Each one costs a few KB for its PhoneAPI state and buffers.
+#ifndef MAX_API_CLIENTS
+#if defined(ARCH_PORTDUINO)
+#define MAX_API_CLIENTS 32
+#elif defined(ARCH_ESP32)
+#define MAX_API_CLIENTS 3
+#else
+#define MAX_API_CLIENTS 1
+#endif
+#endif
+
 /**
  * Provides both debug printing and, if the client starts sending protobufs to us, switches to send/receive protobufs
  * (and starts dropping debug printing - FIXME, eventually those prints should be encapsulated in protobufs).
@@ -21,6 +32,9 @@ template <class T> class ServerAPI : public StreamAPI, private concurrency::OSTh
     /// override close to also shutdown the TCP link
     virtual void close();
 
+    /// @return true if the TCP link is still up
+    bool isClientConnected() { return client.connected(); }
+
   protected:
     /// We override this method to prevent publishing EVENT_SERIAL_CONNECTED/DISCONNECTED for wifi links (we want the board to
     /// stay in the POWERED state to prevent disabling wifi)
@@ -37,12 +51,12 @@ template <class T> class ServerAPI : public StreamAPI, private concurrency::OSTh
  */
 template <class T, class U> class APIServerPort : public U, private concurrency::OSThread
 {
-    /** The currently open port
+    /** The currently open connections, oldest first
      *
-     * FIXME: We currently only allow one open TCP connection at a time, because we depend on the loop() call in this class to
-     * delegate to the worker.  Once coroutines are implemented we can relax this restriction.
+     * Each one runs as its own thread.  When all MAX_API_CLIENTS are in use a new connection replaces the oldest one.
      */
-    T *openAPI = NULL;
+    T *openAPIs[MAX_API_CLIENTS] = {};
+    size_t numOpen = 0;
 #if defined(RAK_4631) || defined(RAK11310)
     // Track wait time for RAK13800 Ethernet requests
     int32_t waitTime = 100;
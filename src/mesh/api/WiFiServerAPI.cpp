@@ -4,6 +4,7 @@
 #if HAS_WIFI
 #include "WiFiServerAPI.h"
 
+#ifndef ARCH_PORTDUINO // portduino serves any number of clients from PosixServerAPI instead
 static WiFiServerPort *apiPort;
 
 void initApiServer(int port)
@@ -22,6 +23,7 @@ void deInitApiServer()
         apiPort = nullptr;
     }
 }
+#endif
 
 WiFiServerAPI::WiFiServerAPI(WiFiClient &_client) : ServerAPI(_client)
 {
@@ -175,26 +175,21 @@ void handleAPIv1FromRadio(HTTPRequest *req, HTTPResponse *res)
         return;
     }
 
-    uint8_t txBuf[MAX_STREAM_BUF_SIZE];
-    uint32_t len = 1;
-
-    if (params->getQueryParameter("all", valueAll)) {
-
-        // If all is true, return all the buffers we have available
-        //   to us at this point in time.
-        if (valueAll == "true") {
-            while (len) {
-                len = webAPI.getFromRadio(txBuf);
-                res->write(txBuf, len);
-            }
-
-            // Otherwise, just return one protobuf
-        } else {
-            len = webAPI.getFromRadio(txBuf);
-            res->write(txBuf, len);
+    uint8_t txBuf[MAX_DELIMITED_FROM_RADIO_SIZE];
+    uint32_t len = 0;
+
+    // If all is true, return all the buffers we have available to us at this point in time, each prefixed by its length
+    // (protobuf's delimited format) so the client can split them again.
+    // Unlike the native web server we can't hold the request open until something arrives: handlers run on the main loop, and
+    // nothing would arrive while we wait.
+    if (params->getQueryParameter("all", valueAll) && valueAll == "true") {
+        size_t n;
+        while ((n = webAPI.getFromRadioDelimited(txBuf)) > 0) {
+            res->write(txBuf, n);
+            len += n;
         }
 
-        // the param "all" was not specified. Return just one protobuf
+        // Otherwise, just return one protobuf
     } else {
         len = webAPI.getFromRadio(txBuf);
         res->write(txBuf, len);
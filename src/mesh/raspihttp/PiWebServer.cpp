@@ -56,6 +56,8 @@ mail:   marchammermann@googlemail.com
 #include <ulfius.h>
 #include <yder.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <string>
 
@@ -253,15 +255,105 @@ int handleAPIv1ToRadio(const struct _u_request *req, struct _u_response *res, vo
     return U_CALLBACK_COMPLETE;
 }
 
+size_t HttpAPI::readFromRadio(uint8_t *buf, bool delimited)
+{
+    std::lock_guard<std::mutex> lock(apiMutex);
+    return delimited ? getFromRadioDelimited(buf) : getFromRadio(buf);
+}
+
+bool HttpAPI::handleToRadio(const uint8_t *buf, size_t len)
+{
+    std::lock_guard<std::mutex> lock(apiMutex);
+    return PhoneAPI::handleToRadio(buf, len);
+}
+
+size_t HttpAPI::waitFromRadio(uint8_t *buf, uint32_t msecs, bool delimited)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(msecs);
+    std::unique_lock<std::mutex> lock(dataMutex);
+    while (true) {
+        uint32_t seen = dataNotifications;
+        lock.unlock();
+        size_t len = readFromRadio(buf, delimited);
+        lock.lock();
+
+        auto now = std::chrono::steady_clock::now();
+        if (len || now >= deadline)
+            return len;
+        // New packets are announced, the config download and queue status replies are not: check again now and then
+        dataReady.wait_until(lock, std::min(deadline, now + std::chrono::milliseconds(100)),
+                             [&] { return dataNotifications != seen; });
+    }
+}
+
+void HttpAPI::onNowHasData(uint32_t fromRadioNum)
+{
+    std::lock_guard<std::mutex> lock(dataMutex);
+    dataNotifications++;
+    dataReady.notify_all();
+}
+
+/**
+ * A fromradio?stream=true response in progress
+ */
+struct FromRadioStream {
+    HttpAPI *api;
+    std::chrono::steady_clock::time_point end; // when we stop, so the client reconnects
+    std::string pending;                       // delimited FromRadio not handed to the web server yet
+};
+
+/**
+ * Streaming callback for fromradio?stream=true: blocks until there is something to send, then sends everything available
+ */
+static ssize_t callback_fromradio_stream(void *cls, uint64_t pos, char *buf, size_t max)
+{
+    (void)(pos);
+    FromRadioStream *stream = (FromRadioStream *)cls;
+
+    if (stream->pending.empty()) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= stream->end)
+            return U_STREAM_END;
+        uint32_t msecs = std::chrono::duration_cast<std::chrono::milliseconds>(stream->end - now).count();
+
+        uint8_t txBuf[MAX_DELIMITED_FROM_RADIO_SIZE];
+        size_t len = stream->api->waitFromRadio(txBuf, msecs, true);
+        while (len) {
+            stream->pending.append((const char *)txBuf, len);
+            len = stream->api->readFromRadio(txBuf, true);
+        }
+        if (stream->pending.empty())
+            return U_STREAM_END;
+    }
+
+    size_t n = std::min(max, stream->pending.size());
+    memcpy(buf, stream->pending.data(), n);
+    stream->pending.erase(0, n);
+    return n;
+}
+
+static void callback_fromradio_stream_free(void *cls)
+{
+    delete (FromRadioStream *)cls;
+}
+
 /*
  * Adapt the radioapi to the Webservice handleAPIv1FromRadio
  * Trigger : WebGui(POLL)->handleAPIv1FromRadio->phoneapi->Meshtastic(Radio) events
+ *
+ * Query parameters:
+ *   all=true     every FromRadio available, each prefixed by its length (protobuf's delimited format)
+ *   wait=msecs   if nothing is available yet, hold the request open up to msecs (at most FROMRADIO_MAX_WAIT_MSEC) for it
+ *   stream=true  a chunked response of delimited FromRadio, sent as they arrive, for FROMRADIO_STREAM_MSEC
  */
 int handleAPIv1FromRadio(const struct _u_request *req, struct _u_response *res, void *user_data)
 {
 
     // LOG_DEBUG("handleAPIv1FromRadio radio -> web");
-    std::string valueAll;
+    HttpAPI *api = static_cast<HttpAPI *>(user_data);
+    const char *valueAll = u_map_get(req->map_url, "all");
+    const char *valueWait = u_map_get(req->map_url, "wait");
+    const char *valueStream = u_map_get(req->map_url, "stream");
 
     // Status code is 200 OK by default.
     ulfius_add_header_to_response(res, "Content-Type", "application/x-protobuf");
@@ -275,27 +367,33 @@ int handleAPIv1FromRadio(const struct _u_request *req, struct _u_response *res,
         return U_CALLBACK_COMPLETE;
     }
 
-    uint8_t txBuf[MAX_STREAM_BUF_SIZE];
-    uint32_t len = 1;
+    if (o_strcmp(valueStream, "true") == 0) {
+        FromRadioStream *stream = new FromRadioStream{api, std::chrono::steady_clock::now() +
+                                                               std::chrono::milliseconds(FROMRADIO_STREAM_MSEC)};
+        if (ulfius_set_stream_response(res, 200, callback_fromradio_stream, callback_fromradio_stream_free,
+                                       U_STREAM_SIZE_UNKNOWN, MAX_DELIMITED_FROM_RADIO_SIZE, stream) != U_OK) {
+            LOG_DEBUG("handleAPIv1FromRadio - Error ulfius_set_stream_response");
+            delete stream;
+            return U_CALLBACK_ERROR;
+        }
+        return U_CALLBACK_COMPLETE;
+    }
+
+    uint32_t wait = valueWait ? std::min(strtoul(valueWait, NULL, 10), (unsigned long)FROMRADIO_MAX_WAIT_MSEC) : 0;
+    uint8_t txBuf[MAX_DELIMITED_FROM_RADIO_SIZE];
 
-    if (valueAll == "true") {
+    if (o_strcmp(valueAll, "true") == 0) {
+        std::string body;
+        size_t len = api->waitFromRadio(txBuf, wait, true);
         while (len) {
-            len = static_cast<HttpAPI *>(user_data)->getFromRadio(txBuf);
-            ulfius_set_response_properties(res, U_OPT_STATUS, 200, U_OPT_BINARY_BODY, txBuf, len);
-            const char *tmpa = (const char *)txBuf;
-            ulfius_set_string_body_response(res, 200, tmpa);
-            // LOG_DEBUG("\n----webAPI response all:----");
-            // LOG_DEBUG(tmpa);
-            // LOG_DEBUG("");
+            body.append((const char *)txBuf, len);
+            len = api->readFromRadio(txBuf, true);
         }
+        ulfius_set_binary_body_response(res, 200, body.data(), body.size());
         // Otherwise, just return one protobuf
     } else {
-        len = static_cast<HttpAPI *>(user_data)->getFromRadio(txBuf);
-        const char *tmpa = (const char *)txBuf;
-        ulfius_set_binary_body_response(res, 200, tmpa, len);
-        // LOG_DEBUG("\n----webAPI response:");
-        // LOG_DEBUG(tmpa);
-        // LOG_DEBUG("");
+        size_t len = api->waitFromRadio(txBuf, wait, false);
+        ulfius_set_binary_body_response(res, 200, (const char *)txBuf, len);
     }
 
     // LOG_DEBUG("end radio->web", len);
@@ -5,10 +5,17 @@
 #include "ulfius-cfg.h"
 #include "ulfius.h"
 #include <Arduino.h>
+#include <condition_variable>
 #include <functional>
+#include <mutex>
 
 #define STATIC_FILE_CHUNK 256
 
+// Longest a fromradio request waits for something to send (?wait=<msecs>)
+#define FROMRADIO_MAX_WAIT_MSEC 30000
+// How long a fromradio?stream=true response stays open, then the client reconnects
+#define FROMRADIO_STREAM_MSEC 60000
+
 void initWebServer();
 void createSSLCert();
 int callback_static_file(const struct _u_request *request, struct _u_response *response, void *user_data);
@@ -27,14 +34,32 @@ class HttpAPI : public PhoneAPI
 {
 
   public:
-    // Nothing here yet
+    /**
+     * Like getFromRadio (or getFromRadioDelimited), but if nothing is available wait up to msecs for something to arrive.
+     * Called from the web server's threads, so a long-polling request doesn't hold up the mesh.
+     */
+    size_t waitFromRadio(uint8_t *buf, uint32_t msecs, bool delimited);
+
+    /**
+     * getFromRadio (or getFromRadioDelimited) for the web server's threads.  Long polls and streams overlap, so calls into
+     * the PhoneAPI state machine are taken one at a time.
+     */
+    size_t readFromRadio(uint8_t *buf, bool delimited);
+
+    virtual bool handleToRadio(const uint8_t *buf, size_t len) override;
 
   private:
-    // Nothing here yet
+    std::mutex apiMutex; // held for each call into PhoneAPI from a web server thread, never while waiting for data
+    std::mutex dataMutex;
+    std::condition_variable dataReady;
+    uint32_t dataNotifications = 0; // bumped by onNowHasData, so waiters can tell they were woken
 
   protected:
     /// Check the current underlying physical link to see if the client is currently connected
     virtual bool checkIsConnected() override { return true; } // FIXME, be smarter about this
+
+    /// Wake requests waiting for packets
+    virtual void onNowHasData(uint32_t fromRadioNum) override;
 };
 
 class PiWebServerThread
@@ -326,7 +326,9 @@ bool AdminModule::handleReceivedProtobuf(const meshtastic_MeshPacket &mp, meshta
         meshtastic_NodeInfoLite *node = nodeDB->getMeshNode(r->set_favorite_node);
         if (node != NULL) {
             node->is_favorite = true;
-            saveChanges(SEGMENT_NODEDATABASE, false);
+            nodeDB->nodeOrderChanged(node);
+            nodeDB->nodeChanged(node);
+            saveNodeChange(node->num);
             if (screen)
                 screen->setFrames(graphics::Screen::FOCUS_PRESERVE); // <-- Rebuild screens
         }
@@ -337,7 +339,9 @@ bool AdminModule::handleReceivedProtobuf(const meshtastic_MeshPacket &mp, meshta
         meshtastic_NodeInfoLite *node = nodeDB->getMeshNode(r->remove_favorite_node);
         if (node != NULL) {
             node->is_favorite = false;
-            saveChanges(SEGMENT_NODEDATABASE, false);
+            nodeDB->nodeOrderChanged(node);
+            nodeDB->nodeChanged(node);
+            saveNodeChange(node->num);
             if (screen)
                 screen->setFrames(graphics::Screen::FOCUS_PRESERVE); // <-- Rebuild screens
         }
@@ -352,7 +356,8 @@ bool AdminModule::handleReceivedProtobuf(const meshtastic_MeshPacket &mp, meshta
             node->has_position = false;
             node->user.public_key.size = 0;
             node->user.public_key.bytes[0] = 0;
-            saveChanges(SEGMENT_NODEDATABASE, false);
+            nodeDB->nodeChanged(node);
+            saveNodeChange(node->num);
         }
         break;
     }
@@ -361,7 +366,8 @@ bool AdminModule::handleReceivedProtobuf(const meshtastic_MeshPacket &mp, meshta
         meshtastic_NodeInfoLite *node = nodeDB->getMeshNode(r->remove_ignored_node);
         if (node != NULL) {
             node->is_ignored = false;
-            saveChanges(SEGMENT_NODEDATABASE, false);
+            nodeDB->nodeChanged(node);
+            saveNodeChange(node->num);
         }
         break;
     }
@@ -370,6 +376,7 @@ bool AdminModule::handleReceivedProtobuf(const meshtastic_MeshPacket &mp, meshta
         meshtastic_NodeInfoLite *node = nodeDB->getMeshNode(nodeDB->getNodeNum());
         node->has_position = true;
         node->position = TypeConversions::ConvertToPositionLite(r->set_fixed_position);
+        nodeDB->nodeChanged(node);
         nodeDB->setLocalPosition(r->set_fixed_position);
         config.position.fixed_position = true;
         saveChanges(SEGMENT_NODEDATABASE | SEGMENT_CONFIG, false);
@@ -1273,6 +1280,15 @@ void AdminModule::saveChanges(int saveWhat, bool shouldReboot)
     }
 }
 
+void AdminModule::saveNodeChange(NodeNum nodeNum)
+{
+    if (!hasOpenEditTransaction) {
+        nodeDB->saveNodeToDisk(nodeNum); // Only journals this node instead of rewriting the whole node database
+    } else {
+        LOG_INFO("Delay save of changes to disk until the open transaction is committed");
+    }
+}
+
 void AdminModule::handleStoreDeviceUIConfig(const meshtastic_DeviceUIConfig &uicfg)
 {
     nodeDB->saveProto("/prefs/uiconfig.proto", meshtastic_DeviceUIConfig_size, &meshtastic_DeviceUIConfig_msg, &uicfg);
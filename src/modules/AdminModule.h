@@ -40,6 +40,8 @@ class AdminModule : public ProtobufModule<meshtastic_AdminMessage>, public Obser
     uint session_time = 0;
 
     void saveChanges(int saveWhat, bool shouldReboot = true);
+    /// Like saveChanges(SEGMENT_NODEDATABASE, false), but only for a change to a single node
+    void saveNodeChange(NodeNum nodeNum);
 
     /**
      * Getters
@@ -32,7 +32,7 @@ bool NodeInfoModule::handleReceivedProtobuf(const meshtastic_MeshPacket &mp, mes
 
     // if user has changed while packet was not for us, inform phone
     if (hasChanged && !wasBroadcast && !isToUs(&mp))
-        service->sendToPhone(packetPool.allocCopy(mp));
+        service->sendToPhone(keepReceived(mp));
 
     // LOG_DEBUG("did handleReceived");
     return false; // Let others look at this message also if they want
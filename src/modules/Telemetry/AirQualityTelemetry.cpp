@@ -136,7 +136,7 @@ bool AirQualityTelemetryModule::handleReceivedProtobuf(const meshtastic_MeshPack
         if (lastMeasurementPacket != nullptr)
             packetPool.release(lastMeasurementPacket);
 
-        lastMeasurementPacket = packetPool.allocCopy(mp);
+        lastMeasurementPacket = keepReceived(mp);
     }
 
     return false; // Let others look at this message also if they want
@@ -1,5 +1,6 @@
 #include "DeviceTelemetry.h"
 #include "../mesh/generated/meshtastic/telemetry.pb.h"
+#include "CryptoEngine.h"
 #include "Default.h"
 #include "MeshService.h"
 #include "NodeDB.h"
@@ -141,7 +142,15 @@ meshtastic_Telemetry DeviceTelemetryModule::getLocalStatsTelemetry()
     if (router) {
         telemetry.variant.local_stats.num_rx_dupe = router->rxDupe;
         telemetry.variant.local_stats.num_tx_relay_canceled = router->txRelayCanceled;
+        LOG_DEBUG("Channel decryption: %u packets, %u attempts", router->rxDecryptPackets, router->rxDecryptAttempts);
     }
+    LOG_DEBUG("Packet pool: %u/%u in use, high water %u, %u times empty (%u from heap), %u allocs, %u shared",
+              packetSlabPool.getInUse(), packetSlabPool.getCapacity(), packetSlabPool.getHighWaterMark(),
+              packetSlabPool.getAllocFailures(), packetSlabPool.getHeapFallbacks(), packetSlabPool.getNumAllocs(),
+              packetSlabPool.getNumShares());
+#if !(MESHTASTIC_EXCLUDE_PKI)
+    LOG_DEBUG("PKI shared key cache: %u hits, %u misses", crypto->sharedKeyCacheHits, crypto->sharedKeyCacheMisses);
+#endif
 
     LOG_INFO("Sending local stats: uptime=%i, channel_utilization=%f, air_util_tx=%f, num_online_nodes=%i, num_total_nodes=%i",
              telemetry.variant.local_stats.uptime_seconds, telemetry.variant.local_stats.channel_utilization,
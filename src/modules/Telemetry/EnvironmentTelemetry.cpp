@@ -526,7 +526,7 @@ bool EnvironmentTelemetryModule::handleReceivedProtobuf(const meshtastic_MeshPac
         if (lastMeasurementPacket != nullptr)
             packetPool.release(lastMeasurementPacket);
 
-        lastMeasurementPacket = packetPool.allocCopy(mp);
+        lastMeasurementPacket = keepReceived(mp);
     }
 
     return false; // Let others look at this message also if they want
@@ -160,7 +160,7 @@ bool HealthTelemetryModule::handleReceivedProtobuf(const meshtastic_MeshPacket &
         if (lastMeasurementPacket != nullptr)
             packetPool.release(lastMeasurementPacket);
 
-        lastMeasurementPacket = packetPool.allocCopy(mp);
+        lastMeasurementPacket = keepReceived(mp);
     }
 
     return false; // Let others look at this message also if they want
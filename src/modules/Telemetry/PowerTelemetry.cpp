@@ -181,7 +181,7 @@ bool PowerTelemetryModule::handleReceivedProtobuf(const meshtastic_MeshPacket &m
         if (lastMeasurementPacket != nullptr)
             packetPool.release(lastMeasurementPacket);
 
-        lastMeasurementPacket = packetPool.allocCopy(mp);
+        lastMeasurementPacket = keepReceived(mp);
     }
 
     return false; // Let others look at this message also if they want
@@ -683,21 +683,37 @@ void MQTT::publishQueuedMessages()
     if (!env.validDecode || env.packet == NULL || env.channel_id == NULL)
         return;
 
-    auto jsonString = MeshPacketSerializer::JsonSerialize(env.packet);
-    if (jsonString.length() == 0)
-        return;
-
     std::string topicJson;
     if (env.packet->pki_encrypted) {
         topicJson = jsonTopic + "PKI/" + owner.id;
     } else {
         topicJson = jsonTopic + env.channel_id + "/" + owner.id;
     }
-    LOG_INFO("JSON publish message to %s, %u bytes: %s", topicJson.c_str(), jsonString.length(), jsonString.c_str());
-    publish(topicJson.c_str(), jsonString.c_str(), false);
+    publishJson(topicJson, env.packet);
 #endif // ARCH_NRF52 NRF52_USE_JSON
 }
 
+#if !defined(ARCH_NRF52) || NRF52_USE_JSON
+void MQTT::publishJson(const std::string &topic, const meshtastic_MeshPacket *p)
+{
+    // Serialized on the stack, so neither the heap nor a buffer kept in MQTT for nodes without json_enabled
+    char json[MESHPACKET_JSON_SIZE];
+    size_t length = MeshPacketSerializer::JsonSerialize(p, json, sizeof(json));
+    if (length > 0) {
+        LOG_INFO("JSON publish message to %s, %u bytes: %s", topic.c_str(), length, json);
+        publish(topic.c_str(), json, false);
+        return;
+    }
+
+    // Too big for the buffer, fall back to building it on the heap
+    auto jsonString = MeshPacketSerializer::JsonSerialize(p, false);
+    if (jsonString.length() == 0)
+        return;
+    LOG_INFO("JSON publish message to %s, %u bytes: %s", topic.c_str(), jsonString.length(), jsonString.c_str());
+    publish(topic.c_str(), jsonString.c_str(), false);
+}
+#endif
+
 void MQTT::onSend(const meshtastic_MeshPacket &mp_encrypted, const meshtastic_MeshPacket &mp_decoded, ChannelIndex chIndex)
 {
     if (mp_encrypted.via_mqtt)
@@ -763,12 +779,8 @@ void MQTT::onSend(const meshtastic_MeshPacket &mp_encrypted, const meshtastic_Me
         if (!moduleConfig.mqtt.json_enabled)
             return;
         // handle json topic
-        auto jsonString = MeshPacketSerializer::JsonSerialize(&mp_decoded);
-        if (jsonString.length() == 0)
-            return;
         std::string topicJson = jsonTopic + channelId + "/" + owner.id;
-        LOG_INFO("JSON publish message to %s, %u bytes: %s", topicJson.c_str(), jsonString.length(), jsonString.c_str());
-        publish(topicJson.c_str(), jsonString.c_str(), false);
+        publishJson(topicJson, &mp_decoded);
 #endif // ARCH_NRF52 NRF52_USE_JSON
     } else {
         LOG_INFO("MQTT not connected, queue packet");
@@ -129,6 +129,11 @@ class MQTT : private concurrency::OSThread
 
     void publishQueuedMessages();
 
+#if !defined(ARCH_NRF52) || NRF52_USE_JSON
+    /// Publish the JSON for p on topic
+    void publishJson(const std::string &topic, const meshtastic_MeshPacket *p);
+#endif
+
     void publishNodeInfo();
 
     // Check if we should report unencrypted information about our node for consumption by a map
@@ -813,6 +813,7 @@ bool loadConfig(const char *configPath)
 
         if (yamlConfig["General"]) {
             settingsMap[maxnodes] = (yamlConfig["General"]["MaxNodes"]).as<int>(200);
+            settingsMap[nodedb_mmap] = (yamlConfig["General"]["NodeDBStorage"]).as<std::string>("protobuf") == "mmap";
             settingsMap[maxtophone] = (yamlConfig["General"]["MaxMessageQueue"]).as<int>(100);
             settingsStrings[config_directory] = (yamlConfig["General"]["ConfigDirectory"]).as<std::string>("");
             settingsStrings[available_directory] =
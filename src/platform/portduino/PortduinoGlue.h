@@ -108,6 +108,7 @@ enum configNames {
     websslcertpath,
     maxtophone,
     maxnodes,
+    nodedb_mmap,
     ascii_logs,
     config_directory,
     available_directory,
@@ -90,7 +90,7 @@ std::string JSON::Stringify(const JSONValue *value)
  */
 bool JSON::SkipWhitespace(const char **data)
 {
-    while (**data != 0 && (**data == ' ' || **data == '\t' || **data == '\r' || **data == '\n'))
+    while (**data != 0 && IsWhitespace(**data))
         (*data)++;
 
     return **data != 0;
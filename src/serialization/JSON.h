@@ -60,6 +60,9 @@ class JSON
     static JSONValue *Parse(const char *data);
     static std::string Stringify(const JSONValue *value);
 
+    /// The whitespace Parse() allows around and between values
+    static bool IsWhitespace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
   protected:
     static bool SkipWhitespace(const char **data);
     static bool ExtractString(const char **data, std::string &str);
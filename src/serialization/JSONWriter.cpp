@@ -0,0 +1,149 @@
+#include "JSONWriter.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+void JSONWriter::put(char c)
+{
+    // Always keep a byte for the terminating 0
+    if (len + 1 < size)
+        buf[len++] = c;
+    else
+        overflowed = true;
+}
+
+void JSONWriter::put(const char *s, size_t n)
+{
+    if (len + n < size) {
+        memcpy(buf + len, s, n);
+        len += n;
+    } else {
+        overflowed = true;
+    }
+}
+
+void JSONWriter::separate()
+{
+    if (needComma)
+        put(',');
+    needComma = true;
+}
+
+void JSONWriter::open(char c)
+{
+    separate();
+    put(c);
+    needComma = false;
+}
+
+void JSONWriter::close(char c)
+{
+    put(c);
+    needComma = true;
+}
+
+void JSONWriter::key(const char *name)
+{
+    value(name);
+    put(':');
+    needComma = false;
+}
+
+void JSONWriter::value(double number)
+{
+    separate();
+    if (isinf(number) || isnan(number)) {
+        put("null", 4);
+        return;
+    }
+
+    // Same as the std::stringstream with precision(15) in JSONValue::StringifyImpl
+    char num[32];
+    int n = snprintf(num, sizeof(num), "%.15g", number);
+    put(num, n);
+}
+
+void JSONWriter::value(bool b)
+{
+    separate();
+    if (b)
+        put("true", 4);
+    else
+        put("false", 5);
+}
+
+void JSONWriter::value(const char *str)
+{
+    value(str, strlen(str));
+}
+
+// Escapes like JSONValue::StringifyString, char for char
+void JSONWriter::value(const char *str, size_t n)
+{
+    separate();
+    put('"');
+    for (size_t i = 0; i < n; i++) {
+        char chr = str[i];
+
+        if (chr == '"' || chr == '\\' || chr == '/') {
+            put('\\');
+            put(chr);
+        } else if (chr == '\b') {
+            put("\\b", 2);
+        } else if (chr == '\f') {
+            put("\\f", 2);
+        } else if (chr == '\n') {
+            put("\\n", 2);
+        } else if (chr == '\r') {
+            put("\\r", 2);
+        } else if (chr == '\t') {
+            put("\\t", 2);
+        } else if (chr < 0x20 || chr == 0x7F) {
+            char escaped[7];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", chr);
+            put(escaped, strlen(escaped));
+        } else if (chr < 0x80) {
+            put(chr);
+        } else {
+            // Copy a whole UTF-8 sequence, if there is enough of it left
+            size_t remain = n - i - 1;
+            size_t follow = 0;
+            if ((chr & 0xE0) == 0xC0 && remain >= 1)
+                follow = 1;
+            else if ((chr & 0xF0) == 0xE0 && remain >= 2)
+                follow = 2;
+            else if ((chr & 0xF8) == 0xF0 && remain >= 3)
+                follow = 3;
+            put(str + i, follow + 1);
+            i += follow;
+        }
+    }
+    put('"');
+}
+
+void JSONWriter::hexValue(const uint8_t *bytes, size_t n)
+{
+    static const char digits[] = "0123456789ABCDEF";
+
+    separate();
+    put('"');
+    for (size_t i = 0; i < n; i++) {
+        put(digits[bytes[i] >> 4]);
+        put(digits[bytes[i] & 0x0F]);
+    }
+    put('"');
+}
+
+void JSONWriter::rawValue(const char *json, size_t n)
+{
+    separate();
+    put(json, n);
+}
+
+size_t JSONWriter::finish()
+{
+    if (size == 0)
+        return 0;
+    buf[len] = 0;
+    return overflowed ? 0 : len;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Writes JSON text straight into a caller provided buffer, without allocating anything.
+ *
+ * The output is what JSONValue::Stringify() would make of the same values: numbers are printed like doubles with 15
+ * significant digits and strings are escaped the same way.  Unlike a JSONObject the writer doesn't sort the members of an
+ * object, callers that want the same text as Stringify() have to add them in sorted order.
+ *
+ * If the buffer runs out the writer stops writing and finish() returns 0, so callers only need to check once at the end.
+ */
+class JSONWriter
+{
+  public:
+    JSONWriter(char *buf, size_t size) : buf(buf), size(size) {}
+
+    void beginObject() { open('{'); }
+    void beginObject(const char *key)
+    {
+        this->key(key);
+        open('{');
+    }
+    void endObject() { close('}'); }
+
+    void beginArray() { open('['); }
+    void beginArray(const char *key)
+    {
+        this->key(key);
+        open('[');
+    }
+    void endArray() { close(']'); }
+
+    /// Start an object member, the value that follows belongs to it
+    void key(const char *name);
+
+    void value(int number) { value((double)number); }
+    void value(unsigned int number) { value((double)number); }
+    void value(double number);
+    void value(bool b);
+    void value(const char *str);
+    void value(const char *str, size_t len);
+
+    /// Like JSONValue(bytes).Stringify() of the hex string for bytes, but without building that string first
+    void hexValue(const uint8_t *bytes, size_t len);
+
+    /// Insert text that is already valid JSON as the next value
+    void rawValue(const char *json, size_t len);
+
+    template <typename T> void add(const char *name, T v)
+    {
+        key(name);
+        value(v);
+    }
+
+    /// Terminate the text
+    /// @return its length (without the terminating 0), or 0 if it didn't fit
+    size_t finish();
+
+    bool hasOverflowed() const { return overflowed; }
+
+  private:
+    char *buf;
+    size_t size;
+    size_t len = 0;
+    bool overflowed = false;
+    bool needComma = false; // A value was written at this level, the next key or array element needs a separator
+
+    void separate();
+    void open(char c);
+    void close(char c);
+    void put(char c);
+    void put(const char *s, size_t n);
+};
@@ -1,6 +1,7 @@
 #ifndef NRF52_USE_JSON
 #include "MeshPacketSerializer.h"
 #include "JSON.h"
+#include "JSONWriter.h"
 #include "NodeDB.h"
 #include "mesh/generated/meshtastic/mqtt.pb.h"
 #include "mesh/generated/meshtastic/telemetry.pb.h"
@@ -465,4 +466,441 @@ std::string MeshPacketSerializer::JsonSerializeEncrypted(const meshtastic_MeshPa
     delete value;
     return jsonStr;
 }
-#endif
\ No newline at end of file
+// JSON::Parse() only succeeds on text that starts and ends like a JSON value.  Checking for that first saves trying, and the
+// allocations that come with it, for nearly every plain text message.  This must never turn down text the parser takes, so it
+// follows the parser exactly: only its whitespace is trimmed (not \v or \f), true/false/null in any case, and numbers end in
+// a digit ("1." is not a number to it either).
+static bool mightBeJSON(const char *str)
+{
+    size_t len = strlen(str);
+    while (len && JSON::IsWhitespace(str[len - 1]))
+        len--;
+    while (len && JSON::IsWhitespace(*str)) {
+        str++;
+        len--;
+    }
+    if (!len)
+        return false;
+
+    char first = *str, last = str[len - 1];
+    bool startsLikeValue = strchr("\"[{-0123456789tTfFnN", first) != NULL;
+    bool endsLikeValue = strchr("\"]}0123456789eElL", last) != NULL;
+    return startsLikeValue && endsLikeValue;
+}
+
+size_t MeshPacketSerializer::JsonSerialize(const meshtastic_MeshPacket *mp, char *buf, size_t size, bool shouldLog)
+{
+    // Members are written in the order a JSONObject keeps them (sorted by name), so the text is the same as from the
+    // std::string version.  The payload sorts between "id" and "rssi", and "type" comes last, after we know it.
+    const char *msgType = "";
+    JSONWriter json(buf, size);
+
+    json.beginObject();
+    json.add("channel", (unsigned int)mp->channel);
+    json.add("from", (unsigned int)mp->from);
+    if (mp->hop_start != 0 && mp->hop_limit <= mp->hop_start) {
+        json.add("hop_start", (unsigned int)(mp->hop_start));
+        json.add("hops_away", (unsigned int)(mp->hop_start - mp->hop_limit));
+    }
+    json.add("id", (unsigned int)mp->id);
+
+    if (mp->which_payload_variant == meshtastic_MeshPacket_decoded_tag) {
+        switch (mp->decoded.portnum) {
+        case meshtastic_PortNum_TEXT_MESSAGE_APP: {
+            msgType = "text";
+            // convert bytes to string
+            if (shouldLog)
+                LOG_DEBUG("got text message of size %u", mp->decoded.payload.size);
+
+            char payloadStr[(mp->decoded.payload.size) + 1];
+            memcpy(payloadStr, mp->decoded.payload.bytes, mp->decoded.payload.size);
+            payloadStr[mp->decoded.payload.size] = 0; // null terminated string
+            // check if this is a JSON payload
+            JSONValue *json_value = mightBeJSON(payloadStr) ? JSON::Parse(payloadStr) : NULL;
+            if (json_value != NULL) {
+                if (shouldLog)
+                    LOG_INFO("text message payload is of type json");
+
+                // if it is, then we can just use the json value
+                std::string valueStr = json_value->Stringify();
+                json.key("payload");
+                json.rawValue(valueStr.c_str(), valueStr.length());
+                delete json_value;
+            } else {
+                if (shouldLog)
+                    LOG_INFO("text message payload is of type plaintext");
+
+                json.beginObject("payload");
+                json.add("text", (const char *)payloadStr);
+                json.endObject();
+            }
+            break;
+        }
+        case meshtastic_PortNum_TELEMETRY_APP: {
+            msgType = "telemetry";
+            meshtastic_Telemetry scratch;
+            meshtastic_Telemetry *decoded = NULL;
+            memset(&scratch, 0, sizeof(scratch));
+            if (pb_decode_from_bytes(mp->decoded.payload.bytes, mp->decoded.payload.size, &meshtastic_Telemetry_msg, &scratch)) {
+                decoded = &scratch;
+                json.beginObject("payload");
+                if (decoded->which_variant == meshtastic_Telemetry_device_metrics_tag) {
+                    const meshtastic_DeviceMetrics &m = decoded->variant.device_metrics;
+                    json.add("air_util_tx", m.air_util_tx);
+                    if (m.has_battery_level) {
+                        json.add("battery_level", (int)m.battery_level);
+                    }
+                    json.add("channel_utilization", m.channel_utilization);
+                    json.add("uptime_seconds", (unsigned int)m.uptime_seconds);
+                    json.add("voltage", m.voltage);
+                } else if (decoded->which_variant == meshtastic_Telemetry_environment_metrics_tag) {
+                    // Avoid sending 0s for sensors that could be 0
+                    const meshtastic_EnvironmentMetrics &m = decoded->variant.environment_metrics;
+                    if (m.has_barometric_pressure)
+                        json.add("barometric_pressure", m.barometric_pressure);
+                    if (m.has_current)
+                        json.add("current", m.current);
+                    if (m.has_distance)
+                        json.add("distance", m.distance);
+                    if (m.has_gas_resistance)
+                        json.add("gas_resistance", m.gas_resistance);
+                    if (m.has_iaq)
+                        json.add("iaq", (unsigned int)m.iaq);
+                    if (m.has_ir_lux)
+                        json.add("ir_lux", m.ir_lux);
+                    if (m.has_lux)
+                        json.add("lux", m.lux);
+                    if (m.has_radiation)
+                        json.add("radiation", m.radiation);
+                    if (m.has_rainfall_1h)
+                        json.add("rainfall_1h", m.rainfall_1h);
+                    if (m.has_rainfall_24h)
+                        json.add("rainfall_24h", m.rainfall_24h);
+                    if (m.has_relative_humidity)
+                        json.add("relative_humidity", m.relative_humidity);
+                    if (m.has_soil_moisture)
+                        json.add("soil_moisture", (unsigned int)m.soil_moisture);
+                    if (m.has_soil_temperature)
+                        json.add("soil_temperature", m.soil_temperature);
+                    if (m.has_temperature)
+                        json.add("temperature", m.temperature);
+                    if (m.has_uv_lux)
+                        json.add("uv_lux", m.uv_lux);
+                    if (m.has_voltage)
+                        json.add("voltage", m.voltage);
+                    if (m.has_weight)
+                        json.add("weight", m.weight);
+                    if (m.has_white_lux)
+                        json.add("white_lux", m.white_lux);
+                    if (m.has_wind_direction)
+                        json.add("wind_direction", (unsigned int)m.wind_direction);
+                    if (m.has_wind_gust)
+                        json.add("wind_gust", m.wind_gust);
+                    if (m.has_wind_lull)
+                        json.add("wind_lull", m.wind_lull);
+                    if (m.has_wind_speed)
+                        json.add("wind_speed", m.wind_speed);
+                } else if (decoded->which_variant == meshtastic_Telemetry_air_quality_metrics_tag) {
+                    // "pm100" sorts before "pm10_e"
+                    const meshtastic_AirQualityMetrics &m = decoded->variant.air_quality_metrics;
+                    if (m.has_pm10_standard)
+                        json.add("pm10", (unsigned int)m.pm10_standard);
+                    if (m.has_pm100_standard)
+                        json.add("pm100", (unsigned int)m.pm100_standard);
+                    if (m.has_pm100_environmental)
+                        json.add("pm100_e", (unsigned int)m.pm100_environmental);
+                    if (m.has_pm10_environmental)
+                        json.add("pm10_e", (unsigned int)m.pm10_environmental);
+                    if (m.has_pm25_standard)
+                        json.add("pm25", (unsigned int)m.pm25_standard);
+                    if (m.has_pm25_environmental)
+                        json.add("pm25_e", (unsigned int)m.pm25_environmental);
+                } else if (decoded->which_variant == meshtastic_Telemetry_power_metrics_tag) {
+                    const meshtastic_PowerMetrics &m = decoded->variant.power_metrics;
+                    if (m.has_ch1_current)
+                        json.add("current_ch1", m.ch1_current);
+                    if (m.has_ch2_current)
+                        json.add("current_ch2", m.ch2_current);
+                    if (m.has_ch3_current)
+                        json.add("current_ch3", m.ch3_current);
+                    if (m.has_ch1_voltage)
+                        json.add("voltage_ch1", m.ch1_voltage);
+                    if (m.has_ch2_voltage)
+                        json.add("voltage_ch2", m.ch2_voltage);
+                    if (m.has_ch3_voltage)
+                        json.add("voltage_ch3", m.ch3_voltage);
+                }
+                json.endObject();
+            } else if (shouldLog) {
+                LOG_ERROR(errStr, msgType);
+            }
+            break;
+        }
+        case meshtastic_PortNum_NODEINFO_APP: {
+            msgType = "nodeinfo";
+            meshtastic_User scratch;
+            memset(&scratch, 0, sizeof(scratch));
+            if (pb_decode_from_bytes(mp->decoded.payload.bytes, mp->decoded.payload.size, &meshtastic_User_msg, &scratch)) {
+                json.beginObject("payload");
+                json.add("hardware", (int)scratch.hw_model);
+                json.add("id", (const char *)scratch.id);
+                json.add("longname", (const char *)scratch.long_name);
+                json.add("role", (int)scratch.role);
+                json.add("shortname", (const char *)scratch.short_name);
+                json.endObject();
+            } else if (shouldLog) {
+                LOG_ERROR(errStr, msgType);
+            }
+            break;
+        }
+        case meshtastic_PortNum_POSITION_APP: {
+            msgType = "position";
+            meshtastic_Position scratch;
+            meshtastic_Position *decoded = NULL;
+            memset(&scratch, 0, sizeof(scratch));
+            if (pb_decode_from_bytes(mp->decoded.payload.bytes, mp->decoded.payload.size, &meshtastic_Position_msg, &scratch)) {
+                decoded = &scratch;
+                json.beginObject("payload");
+                if ((int)decoded->HDOP) {
+                    json.add("HDOP", (int)decoded->HDOP);
+                }
+                if ((int)decoded->PDOP) {
+                    json.add("PDOP", (int)decoded->PDOP);
+                }
+                if ((int)decoded->VDOP) {
+                    json.add("VDOP", (int)decoded->VDOP);
+                }
+                if ((int)decoded->altitude) {
+                    json.add("altitude", (int)decoded->altitude);
+                }
+                if ((int)decoded->ground_speed) {
+                    json.add("ground_speed", (unsigned int)decoded->ground_speed);
+                }
+                if (int(decoded->ground_track)) {
+                    json.add("ground_track", (unsigned int)decoded->ground_track);
+                }
+                json.add("latitude_i", (int)decoded->latitude_i);
+                json.add("longitude_i", (int)decoded->longitude_i);
+                if ((int)decoded->precision_bits) {
+                    json.add("precision_bits", (int)decoded->precision_bits);
+                }
+                if (int(decoded->sats_in_view)) {
+                    json.add("sats_in_view", (unsigned int)decoded->sats_in_view);
+                }
+                if ((int)decoded->time) {
+                    json.add("time", (unsigned int)decoded->time);
+                }
+                if ((int)decoded->timestamp) {
+                    json.add("timestamp", (unsigned int)decoded->timestamp);
+                }
+                json.endObject();
+            } else if (shouldLog) {
+                LOG_ERROR(errStr, msgType);
+            }
+            break;
+        }
+        case meshtastic_PortNum_WAYPOINT_APP: {
+            msgType = "waypoint";
+            meshtastic_Waypoint scratch;
+            memset(&scratch, 0, sizeof(scratch));
+            if (pb_decode_from_bytes(mp->decoded.payload.bytes, mp->decoded.payload.size, &meshtastic_Waypoint_msg, &scratch)) {
+                json.beginObject("payload");
+                json.add("description", (const char *)scratch.description);
+                json.add("expire", (unsigned int)scratch.expire);
+                json.add("id", (unsigned int)scratch.id);
+                json.add("latitude_i", (int)scratch.latitude_i);
+                json.add("locked_to", (unsigned int)scratch.locked_to);
+                json.add("longitude_i", (int)scratch.longitude_i);
+                json.add("name", (const char *)scratch.name);
+                json.endObject();
+            } else if (shouldLog) {
+                LOG_ERROR(errStr, msgType);
+            }
+            break;
+        }
+        case meshtastic_PortNum_NEIGHBORINFO_APP: {
+            msgType = "neighborinfo";
+            meshtastic_NeighborInfo scratch;
+            memset(&scratch, 0, sizeof(scratch));
+            if (pb_decode_from_bytes(mp->decoded.payload.bytes, mp->decoded.payload.size, &meshtastic_NeighborInfo_msg,
+                                     &scratch)) {
+                json.beginObject("payload");
+                json.add("last_sent_by_id", (unsigned int)scratch.last_sent_by_id);
+                json.beginArray("neighbors");
+                for (uint8_t i = 0; i < scratch.neighbors_count; i++) {
+                    json.beginObject();
+                    json.add("node_id", (unsigned int)scratch.neighbors[i].node_id);
+                    json.add("snr", (int)scratch.neighbors[i].snr);
+                    json.endObject();
+                }
+                json.endArray();
+                json.add("neighbors_count", (int)scratch.neighbors_count);
+                json.add("node_broadcast_interval_secs", (unsigned int)scratch.node_broadcast_interval_secs);
+                json.add("node_id", (unsigned int)scratch.node_id);
+                json.endObject();
+            } else if (shouldLog) {
+                LOG_ERROR(errStr, msgType);
+            }
+            break;
+        }
+        case meshtastic_PortNum_TRACEROUTE_APP: {
+            if (mp->decoded.request_id) { // Only report the traceroute response
+                msgType = "traceroute";
+                meshtastic_RouteDiscovery scratch;
+                meshtastic_RouteDiscovery *decoded = NULL;
+                memset(&scratch, 0, sizeof(scratch));
+                if (pb_decode_from_bytes(mp->decoded.payload.bytes, mp->decoded.payload.size, &meshtastic_RouteDiscovery_msg,
+                                         &scratch)) {
+                    decoded = &scratch;
+
+                    // Lambda function for adding a long name to the route
+                    auto addToRoute = [&json](NodeNum num) {
+                        char long_name[40] = "Unknown";
+                        meshtastic_NodeInfoLite *node = nodeDB->getMeshNode(num);
+                        bool name_known = node ? node->has_user : false;
+                        if (name_known)
+                            memcpy(long_name, node->user.long_name, sizeof(long_name));
+                        json.value((const char *)long_name);
+                    };
+
+                    json.beginObject("payload");
+                    json.beginArray("route"); // Route this message took
+                    addToRoute(mp->to);       // Started at the original transmitter (destination of response)
+                    for (uint8_t i = 0; i < decoded->route_count; i++) {
+                        addToRoute(decoded->route[i]);
+                    }
+                    addToRoute(mp->from); // Ended at the original destination (source of response)
+                    json.endArray();
+
+                    json.beginArray("route_back"); // Route this message took back
+                    addToRoute(mp->from);          // Started at the original destination (source of response)
+                    for (uint8_t i = 0; i < decoded->route_back_count; i++) {
+                        addToRoute(decoded->route_back[i]);
+                    }
+                    addToRoute(mp->to); // Ended at the original transmitter (destination of response)
+                    json.endArray();
+
+                    json.beginArray("snr_back"); // Snr for reverse route
+                    for (uint8_t i = 0; i < decoded->snr_back_count; i++) {
+                        json.value((float)decoded->snr_back[i] / 4);
+                    }
+                    json.endArray();
+
+                    json.beginArray("snr_towards"); // Snr for forward route
+                    for (uint8_t i = 0; i < decoded->snr_towards_count; i++) {
+                        json.value((float)decoded->snr_towards[i] / 4);
+                    }
+                    json.endArray();
+                    json.endObject();
+                } else if (shouldLog) {
+                    LOG_ERROR(errStr, msgType);
+                }
+            }
+            break;
+        }
+        case meshtastic_PortNum_DETECTION_SENSOR_APP: {
+            msgType = "detection";
+            char payloadStr[(mp->decoded.payload.size) + 1];
+            memcpy(payloadStr, mp->decoded.payload.bytes, mp->decoded.payload.size);
+            payloadStr[mp->decoded.payload.size] = 0; // null terminated string
+            json.beginObject("payload");
+            json.add("text", (const char *)payloadStr);
+            json.endObject();
+            break;
+        }
+#ifdef ARCH_ESP32
+        case meshtastic_PortNum_PAXCOUNTER_APP: {
+            msgType = "paxcounter";
+            meshtastic_Paxcount scratch;
+            memset(&scratch, 0, sizeof(scratch));
+            if (pb_decode_from_bytes(mp->decoded.payload.bytes, mp->decoded.payload.size, &meshtastic_Paxcount_msg, &scratch)) {
+                json.beginObject("payload");
+                json.add("ble_count", (unsigned int)scratch.ble);
+                json.add("uptime", (unsigned int)scratch.uptime);
+                json.add("wifi_count", (unsigned int)scratch.wifi);
+                json.endObject();
+            } else if (shouldLog) {
+                LOG_ERROR(errStr, msgType);
+            }
+            break;
+        }
+#endif
+        case meshtastic_PortNum_REMOTE_HARDWARE_APP: {
+            meshtastic_HardwareMessage scratch;
+            memset(&scratch, 0, sizeof(scratch));
+            if (pb_decode_from_bytes(mp->decoded.payload.bytes, mp->decoded.payload.size, &meshtastic_HardwareMessage_msg,
+                                     &scratch)) {
+                if (scratch.type == meshtastic_HardwareMessage_Type_GPIOS_CHANGED) {
+                    msgType = "gpios_changed";
+                    json.beginObject("payload");
+                    json.add("gpio_value", (unsigned int)scratch.gpio_value);
+                    json.endObject();
+                } else if (scratch.type == meshtastic_HardwareMessage_Type_READ_GPIOS_REPLY) {
+                    msgType = "gpios_read_reply";
+                    json.beginObject("payload");
+                    json.add("gpio_mask", (unsigned int)scratch.gpio_mask);
+                    json.add("gpio_value", (unsigned int)scratch.gpio_value);
+                    json.endObject();
+                }
+            } else if (shouldLog) {
+                LOG_ERROR(errStr, "RemoteHardware");
+            }
+            break;
+        }
+        // add more packet types here if needed
+        default:
+            break;
+        }
+    } else if (shouldLog) {
+        LOG_WARN("Couldn't convert encrypted payload of MeshPacket to JSON");
+    }
+
+    if (mp->rx_rssi != 0)
+        json.add("rssi", (int)mp->rx_rssi);
+    json.add("sender", (const char *)owner.id);
+    if (mp->rx_snr != 0)
+        json.add("snr", (float)mp->rx_snr);
+    json.add("timestamp", (unsigned int)mp->rx_time);
+    json.add("to", (unsigned int)mp->to);
+    json.add("type", msgType);
+    json.endObject();
+
+    size_t length = json.finish();
+    if (length == 0) {
+        if (shouldLog)
+            LOG_DEBUG("JSON for packet 0x%08x doesn't fit in %u bytes", mp->id, (unsigned)size);
+    } else if (shouldLog) {
+        LOG_INFO("serialized json message: %s", buf);
+    }
+    return length;
+}
+
+size_t MeshPacketSerializer::JsonSerializeEncrypted(const meshtastic_MeshPacket *mp, char *buf, size_t size)
+{
+    JSONWriter json(buf, size);
+
+    // In the order JsonSerializeEncrypted(mp) has them
+    json.beginObject();
+    json.key("bytes");
+    json.hexValue(mp->encrypted.bytes, mp->encrypted.size);
+    json.add("channel", (unsigned int)mp->channel);
+    json.add("from", (unsigned int)mp->from);
+    if (mp->hop_start != 0 && mp->hop_limit <= mp->hop_start) {
+        json.add("hop_start", (unsigned int)(mp->hop_start));
+        json.add("hops_away", (unsigned int)(mp->hop_start - mp->hop_limit));
+    }
+    json.add("id", (unsigned int)mp->id);
+    if (mp->rx_rssi != 0)
+        json.add("rssi", (int)mp->rx_rssi);
+    json.add("size", (unsigned int)mp->encrypted.size);
+    if (mp->rx_snr != 0)
+        json.add("snr", (float)mp->rx_snr);
+    json.add("time_ms", (double)millis());
+    json.add("timestamp", (unsigned int)mp->rx_time);
+    json.add("to", (unsigned int)mp->to);
+    json.add("want_ack", mp->want_ack);
+    json.endObject();
+
+    return json.finish();
+}
+#endif
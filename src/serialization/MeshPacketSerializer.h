@@ -1,6 +1,9 @@
 #include <meshtastic/mesh.pb.h>
 #include <string>
 
+/// Enough for the JSON of nearly any packet, only names and texts full of escaped characters need more
+#define MESHPACKET_JSON_SIZE 1024
+
 static const char hexChars[16] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
 
 class MeshPacketSerializer
@@ -9,6 +12,14 @@ class MeshPacketSerializer
     static std::string JsonSerialize(const meshtastic_MeshPacket *mp, bool shouldLog = true);
     static std::string JsonSerializeEncrypted(const meshtastic_MeshPacket *mp);
 
+    /**
+     * Same JSON as the std::string versions, written straight into buf instead of being built up as a tree of JSONValues
+     * first, so serializing a packet doesn't touch the heap (except for text messages that are JSON themselves).
+     * @return length of the JSON in buf, or 0 if it didn't fit in size bytes
+     */
+    static size_t JsonSerialize(const meshtastic_MeshPacket *mp, char *buf, size_t size, bool shouldLog = true);
+    static size_t JsonSerializeEncrypted(const meshtastic_MeshPacket *mp, char *buf, size_t size);
+
   private:
     static std::string bytesToHex(const uint8_t *bytes, int len)
     {
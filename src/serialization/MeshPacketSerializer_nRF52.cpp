@@ -407,4 +407,23 @@ std::string MeshPacketSerializer::JsonSerializeEncrypted(const meshtastic_MeshPa
 
     return jsonStr;
 }
-#endif
\ No newline at end of file
+
+// ArduinoJson already serializes without a tree of heap nodes, these just copy its output for callers that have a buffer
+static size_t copyJson(const std::string &json, char *buf, size_t size)
+{
+    if (json.length() >= size)
+        return 0;
+    memcpy(buf, json.c_str(), json.length() + 1);
+    return json.length();
+}
+
+size_t MeshPacketSerializer::JsonSerialize(const meshtastic_MeshPacket *mp, char *buf, size_t size, bool shouldLog)
+{
+    return copyJson(JsonSerialize(mp, shouldLog), buf, size);
+}
+
+size_t MeshPacketSerializer::JsonSerializeEncrypted(const meshtastic_MeshPacket *mp, char *buf, size_t size)
+{
+    return copyJson(JsonSerializeEncrypted(mp), buf, size);
+}
+#endif
@@ -0,0 +1,266 @@
+#include "DebugConfiguration.h"
+#include "TestUtil.h"
+#include <unity.h>
+
+#if ARCH_PORTDUINO
+#include "MeshService.h"
+#include "NodeDB.h"
+#include "PhoneAPI.h"
+#include "SPILock.h"
+#include "mesh-pb-constants.h"
+#include "mesh/api/PosixServerAPI.h"
+
+#include <arpa/inet.h>
+#include <chrono>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+const size_t NUM_CLIENTS = MAX_API_CLIENTS;
+const size_t NUM_PACKETS = MAX_RX_TOPHONE / 2; // few enough that no client's queue drops any
+
+// One simulated API client, talking the framed protobuf stream like the python library does
+struct Client {
+    int fd = -1;
+    std::vector<uint8_t> rx; // received bytes not decoded yet
+    size_t bytes = 0;
+    bool configDone = false;
+    uint32_t completeId = 0;
+    size_t nodeInfos = 0;
+    std::vector<uint32_t> packetIds;
+    bool hungUp = false;
+};
+
+PosixServerPort *server;
+std::vector<Client> clients;
+
+Client connectClient()
+{
+    Client c;
+    c.fd = socket(AF_INET, SOCK_STREAM, 0);
+    TEST_ASSERT_TRUE(c.fd >= 0);
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(server->getPort());
+    // The kernel completes the handshake on its own, the server accepts when it next runs
+    TEST_ASSERT_EQUAL(0, connect(c.fd, (struct sockaddr *)&addr, sizeof(addr)));
+    fcntl(c.fd, F_SETFL, fcntl(c.fd, F_GETFL) | O_NONBLOCK);
+    return c;
+}
+
+void sendToRadio(Client &c, const meshtastic_ToRadio &toRadio)
+{
+    uint8_t buf[MAX_STREAM_BUF_SIZE];
+    size_t len = pb_encode_to_bytes(buf + 4, meshtastic_ToRadio_size, &meshtastic_ToRadio_msg, &toRadio);
+    buf[0] = 0x94;
+    buf[1] = 0xc3;
+    buf[2] = len >> 8;
+    buf[3] = len & 0xff;
+    TEST_ASSERT_EQUAL(len + 4, send(c.fd, buf, len + 4, 0));
+}
+
+void wantConfig(Client &c, uint32_t nonce)
+{
+    meshtastic_ToRadio toRadio = meshtastic_ToRadio_init_zero;
+    toRadio.which_payload_variant = meshtastic_ToRadio_want_config_id_tag;
+    toRadio.want_config_id = nonce;
+    sendToRadio(c, toRadio);
+}
+
+// Read whatever arrived and decode the complete FromRadio frames
+void receive(Client &c)
+{
+    uint8_t buf[4096];
+    ssize_t n;
+    while ((n = recv(c.fd, buf, sizeof(buf), 0)) > 0) {
+        c.rx.insert(c.rx.end(), buf, buf + n);
+        c.bytes += n;
+    }
+    if (n == 0)
+        c.hungUp = true;
+
+    while (c.rx.size() >= 4) {
+        TEST_ASSERT_EQUAL_HEX8(0x94, c.rx[0]);
+        TEST_ASSERT_EQUAL_HEX8(0xc3, c.rx[1]);
+        size_t len = (c.rx[2] << 8) | c.rx[3];
+        if (c.rx.size() < len + 4)
+            break;
+        meshtastic_FromRadio fromRadio = meshtastic_FromRadio_init_zero;
+        TEST_ASSERT_TRUE(pb_decode_from_bytes(c.rx.data() + 4, len, &meshtastic_FromRadio_msg, &fromRadio));
+        switch (fromRadio.which_payload_variant) {
+        case meshtastic_FromRadio_node_info_tag:
+            c.nodeInfos++;
+            break;
+        case meshtastic_FromRadio_config_complete_id_tag:
+            c.configDone = true;
+            c.completeId = fromRadio.config_complete_id;
+            break;
+        case meshtastic_FromRadio_packet_tag:
+            c.packetIds.push_back(fromRadio.packet.id);
+            break;
+        }
+        c.rx.erase(c.rx.begin(), c.rx.begin() + len + 4);
+    }
+}
+
+// Run the server and all clients until done() holds for every client, or give up after a few seconds
+template <class Done> bool pump(Done done)
+{
+    for (int i = 0; i < 50000; i++) {
+        server->serviceClients();
+        bool all = true;
+        for (Client &c : clients) {
+            receive(c);
+            all = all && done(c);
+        }
+        if (all)
+            return true;
+        usleep(100);
+    }
+    return false;
+}
+} // namespace
+
+void setUp(void)
+{
+    // set stuff up here
+}
+
+void tearDown(void)
+{
+    // clean stuff up here
+}
+
+// Dozens of clients download their config at the same time, and every one of them completes
+void test_clients_sync_concurrently(void)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < NUM_CLIENTS; i++)
+        clients.push_back(connectClient());
+    for (Client &c : clients)
+        wantConfig(c, SPECIAL_NONCE_ONLY_NODES);
+
+    TEST_ASSERT_TRUE(pump([](const Client &c) { return c.configDone; }));
+    auto end = std::chrono::steady_clock::now();
+
+    TEST_ASSERT_EQUAL(NUM_CLIENTS, server->getNumClients());
+    size_t bytes = 0;
+    for (const Client &c : clients) {
+        TEST_ASSERT_EQUAL_UINT32(SPECIAL_NONCE_ONLY_NODES, c.completeId);
+        TEST_ASSERT_EQUAL(nodeDB->getNumMeshNodes() + 1, c.nodeInfos); // our own node is sent twice
+        bytes += c.bytes;
+    }
+
+    char msg[120];
+    snprintf(msg, sizeof(msg), "%u clients synced in %.1fms, %u bytes", (unsigned)NUM_CLIENTS,
+             std::chrono::duration<double, std::milli>(end - start).count(), (unsigned)bytes);
+    TEST_MESSAGE(msg);
+}
+
+// Clients no longer compete for one packet queue, each gets its own copy of every packet
+void test_every_client_gets_every_packet(void)
+{
+    for (uint32_t id = 1; id <= NUM_PACKETS; id++) {
+        meshtastic_MeshPacket *p = packetPool.allocZeroed();
+        p->id = id;
+        p->which_payload_variant = meshtastic_MeshPacket_decoded_tag;
+        p->decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_APP;
+        service->sendToPhone(p);
+    }
+
+    TEST_ASSERT_TRUE(pump([](const Client &c) { return c.packetIds.size() == NUM_PACKETS; }));
+    for (const Client &c : clients) {
+        for (uint32_t id = 1; id <= NUM_PACKETS; id++)
+            TEST_ASSERT_EQUAL_UINT32(id, c.packetIds[id - 1]);
+    }
+}
+
+// One more client than we serve replaces the oldest one, and clients that hang up are dropped
+void test_sessions_are_reclaimed(void)
+{
+    clients.push_back(connectClient());
+    TEST_ASSERT_TRUE(pump([](const Client &c) { return &c != &clients.front() || c.hungUp; }));
+    TEST_ASSERT_EQUAL(NUM_CLIENTS, server->getNumClients());
+    close(clients.front().fd);
+    clients.erase(clients.begin());
+
+    for (size_t i = 0; i < NUM_CLIENTS / 2; i++) {
+        close(clients.back().fd);
+        clients.pop_back();
+    }
+    TEST_ASSERT_TRUE(pump([](const Client &c) { return server->getNumClients() == NUM_CLIENTS / 2; }));
+
+    for (Client &c : clients)
+        close(c.fd);
+    clients.clear();
+    for (int i = 0; i < 1000 && server->getNumClients(); i++) {
+        server->serviceClients();
+        usleep(100);
+    }
+    TEST_ASSERT_EQUAL(0, server->getNumClients());
+}
+
+// A TCP client on its own reads only its own queue, telemetry modules still see that a phone is keeping up
+void test_lone_client_counts_as_phone(void)
+{
+    clients.push_back(connectClient());
+    wantConfig(clients.front(), SPECIAL_NONCE_ONLY_NODES);
+    TEST_ASSERT_TRUE(pump([](const Client &c) { return c.configDone; }));
+
+    // Nobody reads toPhoneQueue, so these stay in it
+    for (uint32_t id = 1; id <= NUM_PACKETS; id++) {
+        meshtastic_MeshPacket *p = packetPool.allocZeroed();
+        p->id = 1000 + id;
+        p->which_payload_variant = meshtastic_MeshPacket_decoded_tag;
+        p->decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_APP;
+        service->sendToPhone(p);
+    }
+    TEST_ASSERT_TRUE(pump([](const Client &c) { return c.packetIds.size() == NUM_PACKETS; }));
+    TEST_ASSERT_TRUE(service->isToPhoneQueueEmpty());
+
+    close(clients.front().fd);
+    clients.clear();
+    for (int i = 0; i < 1000 && server->getNumClients(); i++) {
+        server->serviceClients();
+        usleep(100);
+    }
+    TEST_ASSERT_EQUAL(0, server->getNumClients());
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    initSPI();
+    nodeDB = new NodeDB();
+    service = new MeshService();
+    server = new PosixServerPort(0); // any free port
+    TEST_ASSERT_TRUE(server->init());
+
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_clients_sync_concurrently);
+    RUN_TEST(test_every_client_gets_every_packet);
+    RUN_TEST(test_sessions_are_reclaimed);
+    RUN_TEST(test_lone_client_counts_as_phone);
+    exit(UNITY_END()); // stop unit testing
+}
+#else
+void setup()
+{
+    initializeTestEnvironment();
+    LOG_WARN("This test requires ARCH_PORTDUINO sockets");
+    UNITY_BEGIN();
+    UNITY_END();
+}
+#endif
+void loop() {}
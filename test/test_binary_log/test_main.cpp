@@ -0,0 +1,174 @@
+#include "BinaryLog.h"
+
+#include "TestUtil.h"
+#include <unity.h>
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+namespace
+{
+size_t encode(uint8_t *out, size_t outSize, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    size_t len = BinaryLog::encodeRecord(out, outSize, 'I', BinaryLog::formatId(format), 0, 1234, 0, format, args);
+    va_end(args);
+    return len;
+}
+
+size_t format(char *out, size_t outSize, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(out, outSize, format, args);
+    va_end(args);
+    return len;
+}
+
+const size_t RECORD_HEADER = 18; // 'R', level, id, thread id, msec, rtc
+} // namespace
+
+void setUp(void)
+{
+    // set stuff up here
+}
+
+void tearDown(void)
+{
+    // clean stuff up here
+}
+
+void test_id_follows_text(void)
+{
+    char copy[32];
+    strcpy(copy, "Received %d packets\n");
+    TEST_ASSERT_EQUAL_UINT32(BinaryLog::formatId("Received %d packets\n"), BinaryLog::formatId(copy));
+    TEST_ASSERT_TRUE(BinaryLog::formatId("Received %d packets\n") != BinaryLog::formatId("Received %u packets\n"));
+    TEST_ASSERT_TRUE(BinaryLog::formatId("") != 0);
+}
+
+void test_record_layout(void)
+{
+    uint8_t out[64];
+    size_t len = encode(out, sizeof(out), "a=%d b=%u s=%s c=%c%%", -3, 300u, "hi", 'x');
+    const uint8_t expectArgs[] = {
+        0x05,           // -3, zigzag
+        0xac, 0x02,     // 300
+        0x02, 'h', 'i', // "hi"
+        'x',
+    };
+    TEST_ASSERT_EQUAL(RECORD_HEADER + sizeof(expectArgs), len);
+    TEST_ASSERT_EQUAL('R', out[0]);
+    TEST_ASSERT_EQUAL('I', out[1]);
+    TEST_ASSERT_EQUAL(1234 & 0xff, out[10]); // msec, little endian
+    TEST_ASSERT_EQUAL(1234 >> 8, out[11]);
+    TEST_ASSERT_EQUAL_MEMORY(expectArgs, out + RECORD_HEADER, sizeof(expectArgs));
+}
+
+void test_argument_types(void)
+{
+    uint8_t out[64];
+    // Each argument must be taken as the type it was passed as, or every one after it is garbage
+    const char payload[3] = {'a', 'b', 'c'}; // Not 0 terminated, like the text in a packet
+    size_t len = encode(out, sizeof(out), "%lld %hhu %f %.*s %zu %p", -1LL, 0x1ff, 0.5, 2, payload, (size_t)7, (void *)0x10);
+    TEST_ASSERT_TRUE(len > 0);
+    const uint8_t *a = out + RECORD_HEADER;
+    TEST_ASSERT_EQUAL(0x01, a[0]); // -1, zigzag
+    TEST_ASSERT_EQUAL(0xff, a[1]); // hh: truncated to a byte, like printf
+    TEST_ASSERT_EQUAL(0x01, a[2]);
+    double d;
+    memcpy(&d, a + 3, sizeof(d));
+    TEST_ASSERT_TRUE(d == 0.5);
+    TEST_ASSERT_EQUAL(0x04, a[11]); // precision 2, zigzag
+    TEST_ASSERT_EQUAL(2, a[12]);    // only as much of the string as the precision allows
+    TEST_ASSERT_EQUAL_MEMORY("ab", a + 13, 2);
+    TEST_ASSERT_EQUAL(7, a[15]);
+    TEST_ASSERT_EQUAL(0x10, a[16]);
+    TEST_ASSERT_EQUAL(RECORD_HEADER + 17, len);
+
+    // A precision in the format string works the same
+    len = encode(out, sizeof(out), "%.3s", payload);
+    TEST_ASSERT_EQUAL(RECORD_HEADER + 4, len);
+    TEST_ASSERT_EQUAL(3, a[0]);
+    TEST_ASSERT_EQUAL_MEMORY("abc", a + 1, 3);
+}
+
+void test_unencodable(void)
+{
+    uint8_t out[64];
+    int n;
+    TEST_ASSERT_EQUAL(0, encode(out, sizeof(out), "%n", &n));
+    TEST_ASSERT_EQUAL(0, encode(out, sizeof(out), "%ls", L"wide"));
+    TEST_ASSERT_EQUAL(0, encode(out, RECORD_HEADER + 1, "%u %u", 1000, 1000)); // Doesn't fit
+
+    // Long strings are cut short rather than losing the line
+    char longText[200];
+    memset(longText, 'x', sizeof(longText) - 1);
+    longText[sizeof(longText) - 1] = '\0';
+    TEST_ASSERT_EQUAL(sizeof(out), encode(out, sizeof(out), "%s", longText));
+}
+
+void test_dictionary(void)
+{
+    BinaryLog::Dictionary dict;
+    uint32_t a = BinaryLog::formatId("one"), b = BinaryLog::formatId("two");
+    TEST_ASSERT_TRUE(dict.add(a));
+    TEST_ASSERT_FALSE(dict.add(a));
+    TEST_ASSERT_TRUE(dict.add(b));
+    TEST_ASSERT_FALSE(dict.add(a));
+    dict.clear();
+    TEST_ASSERT_TRUE(dict.add(a));
+
+    uint8_t out[16];
+    TEST_ASSERT_EQUAL(8, BinaryLog::encodeDefinition(out, sizeof(out), a, "one"));
+    TEST_ASSERT_EQUAL('F', out[0]);
+    TEST_ASSERT_EQUAL_MEMORY("one", out + 5, 3);
+    TEST_ASSERT_EQUAL(sizeof(out), BinaryLog::encodeDefinition(out, sizeof(out), a, "a much longer format string"));
+}
+
+// Not a pass/fail test: cost and size of a typical log line, encoded against formatted
+void test_benchmark(void)
+{
+    const char *fmt = "Received text msg from=0x%0x, id=0x%x, msg=%.*s, rxSNR=%g, rxRSSI=%i, hopLimit=%d\n";
+    const int lines = 20000;
+    uint8_t bin[200];
+    char text[200];
+    size_t binLen = 0, textLen = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < lines; i++)
+        textLen = format(text, sizeof(text), fmt, 0xdeadbeef, i, 5, "hello", 6.25, -90 - (i & 7), 3);
+    auto mid = std::chrono::steady_clock::now();
+    for (int i = 0; i < lines; i++)
+        binLen = encode(bin, sizeof(bin), fmt, 0xdeadbeef, i, 5, "hello", 6.25, -90 - (i & 7), 3);
+    auto end = std::chrono::steady_clock::now();
+    TEST_ASSERT_TRUE(binLen > 0);
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "vsnprintf %.3fus, %u bytes; binary %.3fus, %u bytes + 4 byte frame header",
+             std::chrono::duration<double, std::micro>(mid - start).count() / lines, (unsigned)textLen,
+             std::chrono::duration<double, std::micro>(end - mid).count() / lines, (unsigned)binLen);
+    TEST_MESSAGE(msg);
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_id_follows_text);
+    RUN_TEST(test_record_layout);
+    RUN_TEST(test_argument_types);
+    RUN_TEST(test_unencodable);
+    RUN_TEST(test_dictionary);
+    RUN_TEST(test_benchmark);
+    exit(UNITY_END()); // stop unit testing
+}
+
+void loop() {}
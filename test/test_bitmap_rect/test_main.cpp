@@ -0,0 +1,162 @@
+#include "graphics/niche/Utils/BitmapRect.h"
+
+#include "TestUtil.h"
+#include <unity.h>
+
+#include <chrono>
+#include <random>
+#include <stdio.h>
+#include <vector>
+
+using NicheGraphics::fillBitmapRect;
+
+namespace
+{
+// 250x122, the size of a common E-Ink panel. Width is not a multiple of 8
+const uint16_t width = 250, height = 122;
+const uint16_t rowBytes = ((width - 1) / 8) + 1;
+
+// Pixel by pixel, the way InkHUD::Renderer::handlePixel writes the image buffer
+void setPixel(uint8_t *buffer, int16_t x, int16_t y, bool set)
+{
+    uint32_t byteNum = (y * rowBytes) + (x / 8);
+    uint8_t bitNum = 7 - (x % 8);
+    if (set)
+        buffer[byteNum] |= (1 << bitNum);
+    else
+        buffer[byteNum] &= ~(1 << bitNum);
+}
+
+void fillPixels(uint8_t *buffer, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, bool set)
+{
+    for (uint16_t y = y0; y <= y1; y++)
+        for (uint16_t x = x0; x <= x1; x++)
+            setPixel(buffer, x, y, set);
+}
+
+// Same as InkHUD::Renderer::rotatePixelCoords, rotation 1
+void rotate(int16_t *x, int16_t *y)
+{
+    int16_t x1 = (width - 1) - *y;
+    *y = *x;
+    *x = x1;
+}
+} // namespace
+
+void setUp(void)
+{
+    // set stuff up here
+}
+
+void tearDown(void)
+{
+    // clean stuff up here
+}
+
+void test_byte_edges(void)
+{
+    // Every start and end within the first few bytes, both colors, over a background of the opposite color
+    for (uint16_t x0 = 0; x0 < 24; x0++) {
+        for (uint16_t x1 = x0; x1 < 32; x1++) {
+            for (bool set : {true, false}) {
+                std::vector<uint8_t> a(rowBytes * 3, set ? 0x00 : 0xFF), b = a;
+                fillBitmapRect(a.data(), rowBytes, x0, 1, x1, 1, set);
+                fillPixels(b.data(), x0, 1, x1, 1, set);
+                TEST_ASSERT_EQUAL_MEMORY(b.data(), a.data(), a.size());
+            }
+        }
+    }
+}
+
+void test_matches_pixels(void)
+{
+    std::mt19937 rng(5);
+    std::vector<uint8_t> a(rowBytes * height), b;
+    for (auto &byte : a)
+        byte = rng();
+    b = a;
+
+    for (int i = 0; i < 2000; i++) {
+        uint16_t x0 = rng() % width, x1 = rng() % width, y0 = rng() % height, y1 = rng() % height;
+        if (x0 > x1)
+            std::swap(x0, x1);
+        if (y0 > y1)
+            std::swap(y0, y1);
+        bool set = rng() & 1;
+        fillBitmapRect(a.data(), rowBytes, x0, y0, x1, y1, set);
+        fillPixels(b.data(), x0, y0, x1, y1, set);
+        TEST_ASSERT_EQUAL_MEMORY(b.data(), a.data(), a.size());
+    }
+}
+
+// Not a pass/fail test: drawing a screen of text-like runs and a few filled boxes, rotated, pixel by pixel against spans
+void test_benchmark(void)
+{
+    struct Span {
+        int16_t x, y;
+        uint16_t w, h;
+    };
+    std::mt19937 rng(9);
+    std::vector<Span> spans;
+    for (int i = 0; i < 1500; i++) // Glyph rows: short runs, one pixel tall
+        spans.push_back({(int16_t)(rng() % (height - 8)), (int16_t)(rng() % width), (uint16_t)(1 + rng() % 6), 1});
+    for (int i = 0; i < 10; i++) // Boxes: headers, highlights, map labels
+        spans.push_back({(int16_t)(rng() % (height / 2)), (int16_t)(rng() % (width / 2)), (uint16_t)(1 + rng() % 60),
+                         (uint16_t)(1 + rng() % 60)});
+
+    const int frames = 200;
+    std::vector<uint8_t> a(rowBytes * height, 0xFF), b = a;
+    uint32_t pixels = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; f++) {
+        for (const Span &s : spans) {
+            for (int16_t y = s.y; y < s.y + s.h; y++) {
+                for (int16_t x = s.x; x < s.x + s.w; x++) {
+                    int16_t rx = x, ry = y;
+                    rotate(&rx, &ry);
+                    setPixel(a.data(), rx, ry, f & 1);
+                    pixels++;
+                }
+            }
+        }
+    }
+    auto mid = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; f++) {
+        for (const Span &s : spans) {
+            int16_t x0 = s.x, y0 = s.y, x1 = s.x + s.w - 1, y1 = s.y + s.h - 1;
+            rotate(&x0, &y0);
+            rotate(&x1, &y1);
+            if (x0 > x1)
+                std::swap(x0, x1);
+            if (y0 > y1)
+                std::swap(y0, y1);
+            fillBitmapRect(b.data(), rowBytes, x0, y0, x1, y1, f & 1);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    TEST_ASSERT_EQUAL_MEMORY(a.data(), b.data(), a.size());
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "%u pixels/frame: pixel by pixel %.1fus/frame, spans %.1fus/frame", (unsigned)(pixels / frames),
+             std::chrono::duration<double, std::micro>(mid - start).count() / frames,
+             std::chrono::duration<double, std::micro>(end - mid).count() / frames);
+    TEST_MESSAGE(msg);
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_byte_edges);
+    RUN_TEST(test_matches_pixels);
+    RUN_TEST(test_benchmark);
+    exit(UNITY_END()); // stop unit testing
+}
+
+void loop() {}
@@ -4,6 +4,8 @@
 #include "TestUtil.h"
 #include <unity.h>
 
+#include <chrono>
+
 void HexToBytes(uint8_t *result, const std::string hex, size_t len = 0)
 {
     if (len) {
@@ -178,6 +180,116 @@ void test_AES_CTR(void)
     TEST_ASSERT_EQUAL_MEMORY(expected, plain, 16);
 }
 
+// Repeated PKI packets with the same node reuse the derived key, a changed private or public key must not
+void test_PKC_shared_key_cache(void)
+{
+    uint8_t private_key[32];
+    meshtastic_UserLite_public_key_t public_key;
+    uint8_t plain[10] = {0x08, 0x01, 0x12, 0x04, 't', 'e', 's', 't', 0x48, 0x00};
+    uint8_t encrypted[128] __attribute__((__aligned__));
+    uint8_t decrypted[128] __attribute__((__aligned__));
+    uint8_t firstShared[32];
+
+    HexToBytes(public_key.bytes, "db18fc50eea47f00251cb784819a3cf5fc361882597f589f0d7ff820e8064457");
+    public_key.size = 32;
+    HexToBytes(private_key, "a00330633e63522f8a4d81ec6d9d1e6617f6c8ffd3a4c698229537d44e522277");
+    crypto->setDHPrivateKey(private_key);
+    crypto->clearSharedKeyCache();
+
+    uint32_t misses = crypto->sharedKeyCacheMisses, hits = crypto->sharedKeyCacheHits;
+    TEST_ASSERT(crypto->encryptCurve25519(0x0929, 0x1234, public_key, 1, sizeof(plain), plain, encrypted));
+    memcpy(firstShared, crypto->shared_key, sizeof(firstShared));
+    TEST_ASSERT(crypto->decryptCurve25519(0x0929, public_key, 1, sizeof(plain) + 12, encrypted, decrypted));
+    TEST_ASSERT_EQUAL_MEMORY(plain, decrypted, sizeof(plain));
+    TEST_ASSERT_EQUAL(misses + 1, crypto->sharedKeyCacheMisses);
+    TEST_ASSERT_EQUAL(hits + 1, crypto->sharedKeyCacheHits);
+    TEST_ASSERT_EQUAL_MEMORY(firstShared, crypto->shared_key, 32);
+
+    // Same node announcing a new public key
+    HexToBytes(public_key.bytes, "504a36999f489cd2fdbc08baff3d88fa00569ba986cba22548ffde80f9806829");
+    TEST_ASSERT(crypto->encryptCurve25519(0x0929, 0x1234, public_key, 2, sizeof(plain), plain, encrypted));
+    TEST_ASSERT_EQUAL(misses + 2, crypto->sharedKeyCacheMisses);
+    TEST_ASSERT(memcmp(firstShared, crypto->shared_key, 32) != 0);
+
+    // Our own key changing empties the cache
+    private_key[0] ^= 0x40;
+    crypto->setDHPrivateKey(private_key);
+    TEST_ASSERT(crypto->encryptCurve25519(0x0929, 0x1234, public_key, 3, sizeof(plain), plain, encrypted));
+    TEST_ASSERT_EQUAL(misses + 3, crypto->sharedKeyCacheMisses);
+}
+
+// Switching between more keys than the cache holds must still use the right key every time
+void test_AES_CTR_key_cache(void)
+{
+    const size_t numKeys = CRYPTO_KEY_CACHE_SIZE + 2;
+    uint8_t plain[64], buf[64], first[numKeys][64];
+    uint8_t nonce[16] = {1, 2, 3};
+    for (size_t i = 0; i < sizeof(plain); i++)
+        plain[i] = i * 7;
+
+    for (int round = 0; round < 3; round++) {
+        for (size_t i = 0; i < numKeys; i++) {
+            CryptoKey k;
+            k.length = (i & 1) ? 32 : 16;
+            memset(k.bytes, 0x40 + i, sizeof(k.bytes));
+            uint8_t iv[16];
+
+            memcpy(buf, plain, sizeof(buf));
+            memcpy(iv, nonce, sizeof(iv));
+            crypto->encryptAESCtr(k, iv, sizeof(buf), buf);
+            if (round == 0)
+                memcpy(first[i], buf, sizeof(buf));
+            else
+                TEST_ASSERT_EQUAL_MEMORY(first[i], buf, sizeof(buf));
+
+            memcpy(iv, nonce, sizeof(iv));
+            crypto->encryptAESCtr(k, iv, sizeof(buf), buf);
+            TEST_ASSERT_EQUAL_MEMORY(plain, buf, sizeof(buf));
+        }
+    }
+    for (size_t i = 1; i < numKeys; i++)
+        TEST_ASSERT_TRUE(memcmp(first[0], first[i], sizeof(buf)) != 0);
+
+    crypto->clearKeyCache();
+    crypto->encryptAESCtr({{0x40}, 16}, nonce, sizeof(buf), buf); // still usable after clearing
+}
+
+// Not a pass/fail test: prints per packet AES-CTR cost when alternating between two channel keys, setting up a fresh context
+// for every packet (as before the key cache) vs. through the cache
+void test_AES_CTR_benchmark(void)
+{
+    const int packets = 20000;
+    const size_t packetLen = 64;
+    CryptoKey keys[2];
+    for (int i = 0; i < 2; i++) {
+        keys[i].length = i ? 32 : 16;
+        memset(keys[i].bytes, 0x11 * (i + 1), sizeof(keys[i].bytes));
+    }
+    uint8_t buf[packetLen] = {0}, nonce[16] = {0};
+    char msg[128];
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < packets; i++) {
+        const CryptoKey &k = keys[i & 1];
+        CTRCommon *ctr = k.length == 16 ? (CTRCommon *)new CTR<AES128>() : (CTRCommon *)new CTR<AES256>();
+        ctr->setKey(k.bytes, k.length);
+        ctr->setIV(nonce, 16);
+        ctr->setCounterSize(4);
+        ctr->encrypt(buf, buf, packetLen);
+        delete ctr;
+    }
+    auto mid = std::chrono::steady_clock::now();
+    for (int i = 0; i < packets; i++)
+        crypto->encryptAESCtr(keys[i & 1], nonce, packetLen, buf);
+    auto end = std::chrono::steady_clock::now();
+
+    double freshUs = std::chrono::duration<double, std::micro>(mid - start).count() / packets;
+    double cachedUs = std::chrono::duration<double, std::micro>(end - mid).count() / packets;
+    snprintf(msg, sizeof(msg), "%u byte packets, 2 keys: fresh context=%.2fus/packet cached=%.2fus/packet", (unsigned)packetLen,
+             freshUs, cachedUs);
+    TEST_MESSAGE(msg);
+}
+
 void setup()
 {
     // NOTE!!! Wait for >2 secs
@@ -192,6 +304,9 @@ void setup()
     RUN_TEST(test_DH25519);
     RUN_TEST(test_AES_CTR);
     RUN_TEST(test_PKC);
+    RUN_TEST(test_PKC_shared_key_cache);
+    RUN_TEST(test_AES_CTR_key_cache);
+    RUN_TEST(test_AES_CTR_benchmark);
     exit(UNITY_END()); // stop unit testing
 }
 
@@ -0,0 +1,281 @@
+#include "graphics/FrameDiff.h"
+
+#include "TestUtil.h"
+#include <unity.h>
+
+#include <chrono>
+#include <random>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+// The byte by byte comparison findPageChanges() replaces
+bool scanPage(const uint8_t *page, const uint8_t *back, uint16_t width, uint16_t *firstCol, uint16_t *lastCol, uint8_t *rowMask)
+{
+    bool found = false;
+    *rowMask = 0;
+    for (uint16_t x = 0; x < width; x++) {
+        uint8_t d = page[x] ^ (back ? back[x] : 0);
+        if (!d)
+            continue;
+        if (!found)
+            *firstCol = x;
+        *lastCol = x;
+        *rowMask |= d;
+        found = true;
+    }
+    return found;
+}
+
+// A frame of pages, with a few random edits the way a UI redraws a clock or a line of text
+struct Frame {
+    uint16_t width, height;
+    std::vector<uint8_t> buf;
+
+    Frame(uint16_t w, uint16_t h) : width(w), height(h), buf(w * (h / 8)) {}
+
+    void scribble(std::mt19937 &rng, int edits)
+    {
+        for (int e = 0; e < edits; e++) {
+            uint32_t x = rng() % width, y = rng() % height;
+            uint32_t w = 1 + rng() % 40, h = 1 + rng() % 12;
+            for (uint32_t yy = y; yy < y + h && yy < height; yy++)
+                for (uint32_t xx = x; xx < x + w && xx < width; xx++)
+                    buf[(yy / 8) * width + xx] ^= (rng() & 1) << (yy & 7);
+        }
+    }
+};
+} // namespace
+
+void setUp(void)
+{
+    // set stuff up here
+}
+
+void tearDown(void)
+{
+    // clean stuff up here
+}
+
+void test_unchanged_page(void)
+{
+    uint8_t page[135], back[135];
+    memset(page, 0x5a, sizeof(page));
+    memcpy(back, page, sizeof(back));
+    uint16_t first, last;
+    uint8_t mask;
+    TEST_ASSERT_FALSE(findPageChanges(page, back, sizeof(page), &first, &last, &mask));
+
+    memset(page, 0, sizeof(page));
+    TEST_ASSERT_FALSE(findPageChanges(page, NULL, sizeof(page), &first, &last, &mask));
+}
+
+void test_single_pixel_at_edges(void)
+{
+    const uint16_t width = 135; // not a multiple of the word size
+    uint8_t page[width], back[width];
+    uint16_t first, last;
+    uint8_t mask;
+    for (uint16_t x : {0, 1, 3, 4, 131, 132, 134}) {
+        memset(page, 0, width);
+        memset(back, 0, width);
+        page[x] = 0x80;
+        TEST_ASSERT_TRUE(findPageChanges(page, back, width, &first, &last, &mask));
+        TEST_ASSERT_EQUAL(x, first);
+        TEST_ASSERT_EQUAL(x, last);
+        TEST_ASSERT_EQUAL_HEX8(0x80, mask);
+    }
+}
+
+void test_matches_scan(void)
+{
+    std::mt19937 rng(3);
+    for (uint16_t width : {128, 135, 240, 320}) {
+        Frame back(width, 64), cur(width, 64);
+        back.scribble(rng, 50);
+        for (int i = 0; i < 200; i++) {
+            cur = back;
+            cur.scribble(rng, rng() % 4);
+            for (uint16_t p = 0; p < 8; p++) {
+                const uint8_t *page = &cur.buf[p * width], *bp = &back.buf[p * width];
+                for (const uint8_t *b : {bp, (const uint8_t *)NULL}) {
+                    uint16_t f1 = 0, l1 = 0, f2 = 0, l2 = 0;
+                    uint8_t m1 = 0, m2 = 0;
+                    bool c1 = findPageChanges(page, b, width, &f1, &l1, &m1);
+                    bool c2 = scanPage(page, b, width, &f2, &l2, &m2);
+                    TEST_ASSERT_EQUAL(c2, c1);
+                    if (c1) {
+                        TEST_ASSERT_EQUAL(f2, f1);
+                        TEST_ASSERT_EQUAL(l2, l1);
+                        TEST_ASSERT_EQUAL_HEX8(m2, m1);
+                    }
+                }
+            }
+            back = cur;
+        }
+    }
+}
+
+void test_hash_reference_values(void)
+{
+    // Published MurmurHash3_x86_32 results, seed 0
+    TEST_ASSERT_EQUAL_HEX32(0, hashFrame((const uint8_t *)"", 0));
+    TEST_ASSERT_EQUAL_HEX32(0xba6bd213, hashFrame((const uint8_t *)"test", 4));
+    TEST_ASSERT_EQUAL_HEX32(0xc0363e43, hashFrame((const uint8_t *)"Hello, world!", 13));
+    TEST_ASSERT_EQUAL_HEX32(0x2e4ff723, hashFrame((const uint8_t *)"The quick brown fox jumps over the lazy dog", 43));
+}
+
+// One pixel changed anywhere in a large panel's frame must change the hash
+void test_hash_sees_every_pixel(void)
+{
+    const uint32_t size = 800 * 480 / 8;
+    std::vector<uint8_t> frame(size, 0);
+    const uint32_t blank = hashFrame(frame.data(), size);
+    for (uint32_t i = 0; i < size; i += 97) {
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            frame[i] = 1 << bit;
+            TEST_ASSERT_TRUE(hashFrame(frame.data(), size) != blank);
+        }
+        frame[i] = 0;
+    }
+}
+
+void test_ghost_pixels(void)
+{
+    std::mt19937 rng(11);
+    for (uint32_t size : {1, 7, 250, 4736}) {
+        std::vector<uint8_t> dirty(size, 0), expectDirty(size, 0), frame(size);
+        for (int i = 0; i < 20; i++) {
+            for (auto &b : frame)
+                b = rng() & rng(); // Mostly white
+            uint32_t expectGhosts = 0;
+            for (uint32_t x = 0; x < size; x++) {
+                for (uint8_t bit = 0; bit < 8; bit++) {
+                    bool wasBlack = (expectDirty[x] >> bit) & 1;
+                    bool isBlack = (frame[x] >> bit) & 1;
+                    if (wasBlack && !isBlack)
+                        expectGhosts++;
+                    if (isBlack)
+                        expectDirty[x] |= 1 << bit;
+                }
+            }
+            TEST_ASSERT_EQUAL(expectGhosts, trackGhostPixels(frame.data(), dirty.data(), size));
+            TEST_ASSERT_EQUAL_MEMORY(expectDirty.data(), dirty.data(), size);
+        }
+    }
+
+    // The top bit of each byte counts too
+    uint8_t frame1 = 0x80, frame2 = 0x00, dirty = 0;
+    TEST_ASSERT_EQUAL(0, trackGhostPixels(&frame1, &dirty, 1));
+    TEST_ASSERT_EQUAL(1, trackGhostPixels(&frame2, &dirty, 1));
+}
+
+// Not a pass/fail test: hashing and ghost counting time for an 800x480 panel
+void test_benchmark_full_frame(void)
+{
+    const uint32_t size = 800 * 480 / 8;
+    const int frames = 200;
+    std::mt19937 rng(13);
+    std::vector<uint8_t> frame(size), dirty(size, 0);
+    for (auto &b : frame)
+        b = rng();
+
+    uint32_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) {
+        frame[i] ^= 1;
+        sink += hashFrame(frame.data(), size);
+    }
+    auto mid = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) {
+        frame[i] ^= 1;
+        sink += trackGhostPixels(frame.data(), dirty.data(), size);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    char msg[120];
+    snprintf(msg, sizeof(msg), "800x480: hash %.1fus/frame, ghost count %.1fus/frame (%u)",
+             std::chrono::duration<double, std::micro>(mid - start).count() / frames,
+             std::chrono::duration<double, std::micro>(end - mid).count() / frames, (unsigned)(sink & 1));
+    TEST_MESSAGE(msg);
+}
+
+// Not a pass/fail test: diff time per frame and SPI transfers of the old one-transfer-per-row scheme against one rectangle per
+// changed page, for a 320x240 screen with a few small redraws per frame
+void test_benchmark(void)
+{
+    const uint16_t width = 320, height = 240;
+    const int frames = 500;
+    std::mt19937 rng(7);
+    std::vector<Frame> seq(frames + 1, Frame(width, height));
+    seq[0].scribble(rng, 200);
+    for (int i = 1; i <= frames; i++) {
+        seq[i] = seq[i - 1];
+        seq[i].scribble(rng, 3);
+    }
+
+    uint32_t rowTransfers = 0, rowPixels = 0, rectTransfers = 0, rectPixels = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 1; i <= frames; i++) {
+        // Per row: first to last changed pixel of every row that changed
+        for (uint16_t y = 0; y < height; y++) {
+            const uint8_t *page = &seq[i].buf[(y / 8) * width], *back = &seq[i - 1].buf[(y / 8) * width];
+            int first = -1, last = -1;
+            for (uint16_t x = 0; x < width; x++) {
+                if ((page[x] ^ back[x]) & (1 << (y & 7))) {
+                    if (first < 0)
+                        first = x;
+                    last = x;
+                }
+            }
+            if (first >= 0) {
+                rowTransfers++;
+                rowPixels += last - first + 1;
+            }
+        }
+    }
+    auto mid = std::chrono::steady_clock::now();
+    for (int i = 1; i <= frames; i++) {
+        for (uint16_t p = 0; p < height / 8; p++) {
+            uint16_t first, last;
+            uint8_t mask;
+            if (findPageChanges(&seq[i].buf[p * width], &seq[i - 1].buf[p * width], width, &first, &last, &mask)) {
+                rectTransfers++;
+                rectPixels += (last - first + 1) * (32 - __builtin_clz(mask) - __builtin_ctz(mask));
+            }
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    char msg[200];
+    snprintf(msg, sizeof(msg),
+             "per row: %.2fus/frame, %.1f transfers, %.0f pixels; per page: %.2fus/frame, %.1f transfers, %.0f pixels",
+             std::chrono::duration<double, std::micro>(mid - start).count() / frames, (double)rowTransfers / frames,
+             (double)rowPixels / frames, std::chrono::duration<double, std::micro>(end - mid).count() / frames,
+             (double)rectTransfers / frames, (double)rectPixels / frames);
+    TEST_MESSAGE(msg);
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_unchanged_page);
+    RUN_TEST(test_single_pixel_at_edges);
+    RUN_TEST(test_matches_scan);
+    RUN_TEST(test_hash_reference_values);
+    RUN_TEST(test_hash_sees_every_pixel);
+    RUN_TEST(test_ghost_pixels);
+    RUN_TEST(test_benchmark);
+    RUN_TEST(test_benchmark_full_frame);
+    exit(UNITY_END()); // stop unit testing
+}
+
+void loop() {}
@@ -0,0 +1,156 @@
+#include "mesh/LogRing.h"
+
+#include "TestUtil.h"
+#include <unity.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+void setUp(void)
+{
+    // set stuff up here
+}
+
+void tearDown(void)
+{
+    // clean stuff up here
+}
+
+void test_lines_keep_level_and_text(void)
+{
+    LogRing ring(64);
+    char level, line[64];
+    TEST_ASSERT_TRUE(ring.empty());
+    TEST_ASSERT_FALSE(ring.read(&level, line, sizeof(line)));
+
+    TEST_ASSERT_TRUE(ring.write('I', "hello", 5));
+    TEST_ASSERT_TRUE(ring.write('E', "", 0));
+    TEST_ASSERT_TRUE(ring.write('D', "with\nnewline", 12));
+
+    TEST_ASSERT_TRUE(ring.read(&level, line, sizeof(line)));
+    TEST_ASSERT_EQUAL('I', level);
+    TEST_ASSERT_EQUAL_STRING("hello", line);
+    TEST_ASSERT_TRUE(ring.read(&level, line, sizeof(line)));
+    TEST_ASSERT_EQUAL('E', level);
+    TEST_ASSERT_EQUAL_STRING("", line);
+    TEST_ASSERT_TRUE(ring.read(&level, line, sizeof(line)));
+    TEST_ASSERT_EQUAL('D', level);
+    TEST_ASSERT_EQUAL_STRING("with\nnewline", line);
+    TEST_ASSERT_TRUE(ring.empty());
+}
+
+// Lines that wrap around the end of the buffer come out whole
+void test_wraparound(void)
+{
+    LogRing ring(64);
+    char level, line[64], expect[32];
+    for (int i = 0; i < 200; i++) {
+        int len = snprintf(expect, sizeof(expect), "line %d%.*s", i, i % 13, "xxxxxxxxxxxxx");
+        TEST_ASSERT_TRUE(ring.write('I', expect, len));
+        TEST_ASSERT_TRUE(ring.read(&level, line, sizeof(line)));
+        TEST_ASSERT_EQUAL_STRING(expect, line);
+    }
+    TEST_ASSERT_EQUAL(0, ring.getDroppedLines());
+}
+
+// When full, new lines are dropped and counted, queued lines are untouched
+void test_overflow_drops_newest(void)
+{
+    LogRing ring(64);
+    char level, line[64];
+    int written = 0;
+    while (ring.write('W', "0123456789", 10))
+        written++;
+    TEST_ASSERT_EQUAL(4, written); // 16 bytes per record
+    TEST_ASSERT_FALSE(ring.write('W', "0123456789", 10));
+    TEST_ASSERT_EQUAL(2, ring.getDroppedLines());
+    TEST_ASSERT_EQUAL(20, ring.getDroppedBytes());
+
+    // Too long to ever fit
+    TEST_ASSERT_FALSE(ring.write('W', "", 200));
+
+    for (int i = 0; i < written; i++) {
+        TEST_ASSERT_TRUE(ring.read(&level, line, sizeof(line)));
+        TEST_ASSERT_EQUAL_STRING("0123456789", line);
+    }
+    TEST_ASSERT_FALSE(ring.read(&level, line, sizeof(line)));
+    TEST_ASSERT_TRUE(ring.write('W', "0123456789", 10)); // Room again
+}
+
+void test_truncated_read(void)
+{
+    LogRing ring(64);
+    char level, line[5];
+    ring.write('I', "abcdefgh", 8);
+    ring.write('I', "next", 4);
+    TEST_ASSERT_TRUE(ring.read(&level, line, sizeof(line)));
+    TEST_ASSERT_EQUAL_STRING("abcd", line);
+    TEST_ASSERT_TRUE(ring.read(&level, line, sizeof(line)));
+    TEST_ASSERT_EQUAL_STRING("next", line); // The rest of the long line doesn't leak into the next one
+}
+
+// Several writers (cores, interrupts) against one reader: every line that gets in comes out intact and in order per writer
+void test_concurrent_writers(void)
+{
+    const int numWriters = 4, perWriter = 20000;
+    LogRing ring(512);
+    std::atomic<int> done{0};
+
+    std::vector<std::thread> writers;
+    for (int w = 0; w < numWriters; w++) {
+        writers.emplace_back([&, w]() {
+            char text[48];
+            for (int i = 0; i < perWriter; i++) {
+                int len = snprintf(text, sizeof(text), "%d %d %.*s", w, i, i % 20, "abcdefghijklmnopqrst");
+                ring.write('A' + w, text, len);
+            }
+            done++;
+        });
+    }
+
+    int lastSeq[numWriters] = {-1, -1, -1, -1};
+    int received = 0, corrupt = 0, outOfOrder = 0;
+    char level, line[64];
+    while (done.load() < numWriters || !ring.empty()) {
+        if (!ring.read(&level, line, sizeof(line)))
+            continue;
+        int w, i;
+        char tail[32] = "";
+        if (sscanf(line, "%d %d %31s", &w, &i, tail) < 2 || w != level - 'A' || w < 0 || w >= numWriters ||
+            strlen(tail) != (size_t)(i % 20) || strncmp(tail, "abcdefghijklmnopqrst", i % 20)) {
+            corrupt++;
+            continue;
+        }
+        if (i <= lastSeq[w])
+            outOfOrder++;
+        lastSeq[w] = i;
+        received++;
+    }
+    for (auto &t : writers)
+        t.join();
+
+    TEST_ASSERT_EQUAL(0, corrupt);
+    TEST_ASSERT_EQUAL(0, outOfOrder);
+    TEST_ASSERT_EQUAL(numWriters * perWriter, received + (int)ring.getDroppedLines());
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_lines_keep_level_and_text);
+    RUN_TEST(test_wraparound);
+    RUN_TEST(test_overflow_drops_newest);
+    RUN_TEST(test_truncated_read);
+    RUN_TEST(test_concurrent_writers);
+    exit(UNITY_END()); // stop unit testing
+}
+
+void loop() {}
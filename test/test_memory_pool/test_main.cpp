@@ -0,0 +1,207 @@
+#include "mesh/MemoryPool.h"
+
+#include "TestUtil.h"
+#include <unity.h>
+
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct Item {
+    uint32_t a;
+    uint8_t payload[60];
+};
+} // namespace
+
+void setUp(void)
+{
+    // set stuff up here
+}
+
+void tearDown(void)
+{
+    // clean stuff up here
+}
+
+void test_slabs_are_reused(void)
+{
+    MemoryPool<Item> pool(4, false);
+    std::set<Item *> seen;
+    for (int round = 0; round < 3; round++) {
+        Item *items[4];
+        for (int i = 0; i < 4; i++) {
+            items[i] = pool.allocZeroed();
+            TEST_ASSERT_EQUAL(0, items[i]->a);
+            items[i]->a = i + 1;
+            seen.insert(items[i]);
+        }
+        for (int i = 0; i < 4; i++)
+            pool.release(items[i]);
+    }
+    TEST_ASSERT_EQUAL(4, seen.size()); // no more than the four slabs ever handed out
+    TEST_ASSERT_EQUAL(0, pool.getInUse());
+    TEST_ASSERT_EQUAL(4, pool.getHighWaterMark());
+    TEST_ASSERT_EQUAL(0, pool.getAllocFailures());
+}
+
+void test_empty_pool_fails(void)
+{
+    MemoryPool<Item> pool(2, false);
+    Item *a = pool.allocZeroed(0), *b = pool.allocZeroed(0);
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_NULL(pool.allocZeroed(0));
+    TEST_ASSERT_EQUAL(1, pool.getAllocFailures());
+    TEST_ASSERT_EQUAL(0, pool.getHeapFallbacks());
+
+    pool.release(a);
+    Item *c = pool.allocCopy(*b);
+    TEST_ASSERT_EQUAL_PTR(a, c);
+    pool.release(b);
+    pool.release(c);
+}
+
+void test_overflow_to_heap(void)
+{
+    MemoryPool<Item> pool(1, true);
+    Item *a = pool.allocZeroed();
+    Item *b = pool.allocZeroed(); // from the heap
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_EQUAL(1, pool.getAllocFailures());
+    TEST_ASSERT_EQUAL(1, pool.getHeapFallbacks());
+    TEST_ASSERT_EQUAL(1, pool.getInUse());
+
+    pool.release(b); // goes back to the heap, not onto the free list
+    pool.release(a);
+    TEST_ASSERT_EQUAL_PTR(a, pool.allocZeroed());
+    TEST_ASSERT_EQUAL(1, pool.getHeapFallbacks());
+}
+
+// Several threads hammering the free list must never get the same slab twice
+void test_concurrent_alloc_release(void)
+{
+    const int numThreads = 4, numSlabs = 16;
+    MemoryPool<Item> pool(numSlabs, false);
+    std::atomic<int> duplicates{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; t++) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < 20000; i++) {
+                Item *held[numSlabs / numThreads];
+                for (auto &h : held) {
+                    h = pool.allocZeroed(0);
+                    if (h)
+                        h->a = t + 1;
+                }
+                for (auto &h : held) {
+                    if (h) {
+                        if (h->a != (uint32_t)t + 1)
+                            duplicates++;
+                        pool.release(h);
+                    }
+                }
+            }
+        });
+    }
+    for (auto &t : threads)
+        t.join();
+
+    TEST_ASSERT_EQUAL(0, duplicates.load());
+    TEST_ASSERT_EQUAL(0, pool.getInUse());
+    TEST_ASSERT_EQUAL(0, pool.getAllocFailures()); // each thread holds at most its share
+    TEST_ASSERT_TRUE(pool.getHighWaterMark() <= numSlabs);
+}
+
+void test_share_is_refcounted(void)
+{
+    MemoryPool<Item> pool(2, false);
+    Item *a = pool.allocZeroed();
+    a->a = 42;
+    Item *b = pool.share(a);
+    TEST_ASSERT_EQUAL_PTR(a, b);
+    TEST_ASSERT_EQUAL(1, pool.getInUse());
+
+    pool.release(a);
+    TEST_ASSERT_EQUAL(1, pool.getInUse()); // b still holds it
+    TEST_ASSERT_EQUAL(42, b->a);
+    pool.release(b);
+    TEST_ASSERT_EQUAL(0, pool.getInUse());
+
+    // Objects that are not slabs get copied
+    Item local = {7, {}};
+    Item *c = pool.share(&local);
+    TEST_ASSERT_TRUE(c != &local);
+    TEST_ASSERT_EQUAL(7, c->a);
+    pool.release(c);
+    TEST_ASSERT_EQUAL(1, pool.getNumShares());
+}
+
+// Whoever needs to change a shared object gets a copy of its own, the other owners keep the original
+void test_unshare_copies_when_shared(void)
+{
+    MemoryPool<Item> pool(4, false);
+    Item *a = pool.allocZeroed();
+    a->a = 1;
+    TEST_ASSERT_EQUAL_PTR(a, pool.unshare(a)); // the only owner may change it in place
+
+    Item *b = pool.share(a);
+    Item *c = pool.unshare(a);
+    TEST_ASSERT_TRUE(c != b);
+    TEST_ASSERT_EQUAL(2, pool.getInUse());
+    c->a = 2;
+    TEST_ASSERT_EQUAL(1, b->a);
+    TEST_ASSERT_EQUAL_PTR(b, pool.unshare(b)); // a's share went away with the copy
+    pool.release(b);
+    pool.release(c);
+    TEST_ASSERT_EQUAL(0, pool.getInUse());
+}
+
+// Not a pass/fail test: allocations per received packet handed to the phone queue, a telemetry module's last measurement and
+// one more module, the way Router::handleReceived fans packets out
+void test_fanout_allocations(void)
+{
+    const int packets = 1000, consumers = 3;
+    char msg[128];
+    uint32_t perPacket[2];
+    for (int shared = 0; shared < 2; shared++) {
+        MemoryPool<Item> pool(16, false);
+        for (int n = 0; n < packets; n++) {
+            Item *rx = pool.allocZeroed();
+            Item *held[consumers];
+            for (auto &h : held)
+                h = shared ? pool.share(rx) : pool.allocCopy(*rx);
+            pool.release(rx); // the router is done with it
+            for (auto &h : held)
+                pool.release(h);
+        }
+        TEST_ASSERT_EQUAL(0, pool.getInUse());
+        perPacket[shared] = pool.getNumAllocs() / packets;
+    }
+    snprintf(msg, sizeof(msg), "%d consumers: %u allocations/packet copying, %u sharing", consumers, (unsigned)perPacket[0],
+             (unsigned)perPacket[1]);
+    TEST_MESSAGE(msg);
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_slabs_are_reused);
+    RUN_TEST(test_empty_pool_fails);
+    RUN_TEST(test_overflow_to_heap);
+    RUN_TEST(test_concurrent_alloc_release);
+    RUN_TEST(test_share_is_refcounted);
+    RUN_TEST(test_unshare_copies_when_shared);
+    RUN_TEST(test_fanout_allocations);
+    exit(UNITY_END()); // stop unit testing
+}
+
+void loop() {}
@@ -0,0 +1,235 @@
+#include "mesh/MeshPacketQueue.h"
+#include "mesh/NodeDB.h"
+
+#include "TestUtil.h"
+#include <unity.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+
+#define QUEUE_LEN 16
+
+bool CompareMeshPacketFunc(const meshtastic_MeshPacket *p1, const meshtastic_MeshPacket *p2);
+
+namespace
+{
+meshtastic_MeshPacket *makePacket(NodeNum from, PacketId id, meshtastic_MeshPacket_Priority priority, uint32_t txAfter = 0)
+{
+    meshtastic_MeshPacket *p = packetPool.allocZeroed();
+    p->from = from;
+    p->id = id;
+    p->priority = priority;
+    p->tx_after = txAfter;
+    return p;
+}
+
+void drain(MeshPacketQueue &queue)
+{
+    while (!queue.empty())
+        packetPool.release(queue.dequeue());
+}
+
+// The ordering contract, as implemented by the previous sorted vector: upper_bound insertion keeps equal packets FIFO
+class ReferenceQueue
+{
+  public:
+    std::vector<meshtastic_MeshPacket *> queue;
+
+    void enqueue(meshtastic_MeshPacket *p)
+    {
+        queue.insert(std::upper_bound(queue.begin(), queue.end(), p, CompareMeshPacketFunc), p);
+    }
+};
+} // namespace
+
+void setUp(void)
+{
+    // set stuff up here
+}
+
+void tearDown(void)
+{
+    // clean stuff up here
+}
+
+void test_priority_order(void)
+{
+    MeshPacketQueue queue(QUEUE_LEN);
+    queue.enqueue(makePacket(1, 1, meshtastic_MeshPacket_Priority_BACKGROUND));
+    queue.enqueue(makePacket(1, 2, meshtastic_MeshPacket_Priority_ACK));
+    queue.enqueue(makePacket(1, 3, meshtastic_MeshPacket_Priority_DEFAULT));
+    queue.enqueue(makePacket(1, 4, meshtastic_MeshPacket_Priority_HIGH));
+
+    const PacketId expected[] = {2, 4, 3, 1};
+    for (PacketId id : expected) {
+        TEST_ASSERT_EQUAL(id, queue.getFront()->id);
+        meshtastic_MeshPacket *p = queue.dequeue();
+        TEST_ASSERT_EQUAL(id, p->id);
+        packetPool.release(p);
+    }
+    TEST_ASSERT_TRUE(queue.empty());
+    TEST_ASSERT_NULL(queue.dequeue());
+}
+
+void test_equal_priority_is_fifo(void)
+{
+    MeshPacketQueue queue(QUEUE_LEN);
+    for (PacketId id = 1; id <= QUEUE_LEN; id++)
+        queue.enqueue(makePacket(1, id, meshtastic_MeshPacket_Priority_DEFAULT));
+
+    for (PacketId id = 1; id <= QUEUE_LEN; id++) {
+        meshtastic_MeshPacket *p = queue.dequeue();
+        TEST_ASSERT_EQUAL(id, p->id);
+        packetPool.release(p);
+    }
+}
+
+void test_prefer_packets_already_on_mesh(void)
+{
+    MeshPacketQueue queue(QUEUE_LEN);
+    queue.enqueue(makePacket(nodeDB->getNodeNum(), 1, meshtastic_MeshPacket_Priority_DEFAULT));
+    queue.enqueue(makePacket(0x12345678, 2, meshtastic_MeshPacket_Priority_DEFAULT));
+
+    TEST_ASSERT_EQUAL(2, queue.getFront()->id);
+    drain(queue);
+}
+
+void test_late_window_goes_last(void)
+{
+    MeshPacketQueue queue(QUEUE_LEN);
+    queue.enqueue(makePacket(1, 1, meshtastic_MeshPacket_Priority_ACK, 1000));
+    queue.enqueue(makePacket(1, 2, meshtastic_MeshPacket_Priority_BACKGROUND));
+
+    TEST_ASSERT_EQUAL(2, queue.getFront()->id);
+    drain(queue);
+}
+
+void test_find_and_remove(void)
+{
+    MeshPacketQueue queue(QUEUE_LEN);
+    queue.enqueue(makePacket(1, 1, meshtastic_MeshPacket_Priority_DEFAULT));
+    queue.enqueue(makePacket(2, 1, meshtastic_MeshPacket_Priority_DEFAULT, 1000));
+    queue.enqueue(makePacket(1, 2, meshtastic_MeshPacket_Priority_HIGH));
+
+    TEST_ASSERT_TRUE(queue.find(1, 1));
+    TEST_ASSERT_TRUE(queue.find(2, 1));
+    TEST_ASSERT_FALSE(queue.find(3, 1));
+
+    // Late packets are skipped when only normal ones are asked for, and vice versa
+    TEST_ASSERT_NULL(queue.remove(2, 1, true, false));
+    TEST_ASSERT_NULL(queue.remove(1, 2, false, true));
+
+    meshtastic_MeshPacket *p = queue.remove(2, 1);
+    TEST_ASSERT_NOT_NULL(p);
+    TEST_ASSERT_EQUAL(2, p->from);
+    packetPool.release(p);
+    TEST_ASSERT_FALSE(queue.find(2, 1));
+    TEST_ASSERT_EQUAL(QUEUE_LEN - 2, queue.getFree());
+
+    TEST_ASSERT_EQUAL(2, queue.getFront()->id);
+    drain(queue);
+}
+
+void test_full_queue_evicts_lower_priority(void)
+{
+    MeshPacketQueue queue(QUEUE_LEN);
+    for (PacketId id = 1; id <= QUEUE_LEN; id++)
+        TEST_ASSERT_TRUE(queue.enqueue(makePacket(1, id, meshtastic_MeshPacket_Priority_DEFAULT)));
+    TEST_ASSERT_EQUAL(0, queue.getFree());
+
+    // Nothing to gain by evicting an equal priority packet
+    meshtastic_MeshPacket *same = makePacket(1, 100, meshtastic_MeshPacket_Priority_DEFAULT);
+    TEST_ASSERT_FALSE(queue.enqueue(same));
+    packetPool.release(same);
+
+    // A higher priority packet pushes out the one that would be sent last
+    TEST_ASSERT_TRUE(queue.enqueue(makePacket(1, 101, meshtastic_MeshPacket_Priority_HIGH)));
+    TEST_ASSERT_FALSE(queue.find(1, QUEUE_LEN));
+    TEST_ASSERT_TRUE(queue.find(1, 1));
+    TEST_ASSERT_EQUAL(101, queue.getFront()->id);
+    drain(queue);
+}
+
+void test_full_queue_never_evicts_late_packets(void)
+{
+    MeshPacketQueue queue(QUEUE_LEN);
+    queue.enqueue(makePacket(1, 1, meshtastic_MeshPacket_Priority_HIGH));
+    for (PacketId id = 2; id <= QUEUE_LEN; id++)
+        queue.enqueue(makePacket(1, id, meshtastic_MeshPacket_Priority_BACKGROUND, 1000));
+
+    // The only non-late packet has a higher priority, so there is nothing to evict
+    meshtastic_MeshPacket *p = makePacket(1, 100, meshtastic_MeshPacket_Priority_DEFAULT);
+    TEST_ASSERT_FALSE(queue.enqueue(p));
+    packetPool.release(p);
+
+    // Once it is gone, a lower priority non-late packet takes its place
+    packetPool.release(queue.remove(1, 1));
+    queue.enqueue(makePacket(1, 1, meshtastic_MeshPacket_Priority_BACKGROUND));
+    TEST_ASSERT_TRUE(queue.enqueue(makePacket(1, 101, meshtastic_MeshPacket_Priority_DEFAULT)));
+    TEST_ASSERT_FALSE(queue.find(1, 1));
+    for (PacketId id = 2; id <= QUEUE_LEN; id++)
+        TEST_ASSERT_TRUE(queue.find(1, id));
+    drain(queue);
+}
+
+// Random operations must dequeue in exactly the order of the old sorted vector
+void test_matches_reference_order(void)
+{
+    const meshtastic_MeshPacket_Priority priorities[] = {
+        meshtastic_MeshPacket_Priority_BACKGROUND, meshtastic_MeshPacket_Priority_DEFAULT, meshtastic_MeshPacket_Priority_RELIABLE,
+        meshtastic_MeshPacket_Priority_HIGH, meshtastic_MeshPacket_Priority_ACK};
+    std::mt19937 rng(1234);
+    MeshPacketQueue queue(QUEUE_LEN);
+    ReferenceQueue reference;
+    PacketId nextId = 1;
+
+    for (int step = 0; step < 5000; step++) {
+        uint32_t op = rng() % 4;
+        if (op < 2 && reference.queue.size() < QUEUE_LEN) {
+            NodeNum from = (rng() % 3 == 0) ? nodeDB->getNodeNum() : 1 + rng() % 4;
+            meshtastic_MeshPacket *p = makePacket(from, nextId++, priorities[rng() % 5], (rng() % 4 == 0) ? 1000 : 0);
+            TEST_ASSERT_TRUE(queue.enqueue(p));
+            reference.enqueue(p);
+        } else if (op == 2 && !reference.queue.empty()) {
+            meshtastic_MeshPacket *expected = reference.queue.front();
+            reference.queue.erase(reference.queue.begin());
+            meshtastic_MeshPacket *p = queue.dequeue();
+            TEST_ASSERT_EQUAL_PTR(expected, p);
+            packetPool.release(p);
+        } else if (op == 3 && !reference.queue.empty()) {
+            meshtastic_MeshPacket *victim = reference.queue[rng() % reference.queue.size()];
+            reference.queue.erase(std::find(reference.queue.begin(), reference.queue.end(), victim));
+            meshtastic_MeshPacket *p = queue.remove(victim->from, victim->id);
+            TEST_ASSERT_EQUAL_PTR(victim, p);
+            packetPool.release(p);
+        }
+        TEST_ASSERT_EQUAL(QUEUE_LEN - reference.queue.size(), queue.getFree());
+    }
+    drain(queue);
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    const std::unique_ptr<NodeDB> testNodeDB(new NodeDB());
+    nodeDB = testNodeDB.get();
+
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_priority_order);
+    RUN_TEST(test_equal_priority_is_fifo);
+    RUN_TEST(test_prefer_packets_already_on_mesh);
+    RUN_TEST(test_late_window_goes_last);
+    RUN_TEST(test_find_and_remove);
+    RUN_TEST(test_full_queue_evicts_lower_priority);
+    RUN_TEST(test_full_queue_never_evicts_late_packets);
+    RUN_TEST(test_matches_reference_order);
+    exit(UNITY_END()); // stop unit testing
+}
+
+void loop() {}
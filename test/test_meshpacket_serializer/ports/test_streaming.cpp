@@ -0,0 +1,279 @@
+#include "../test_helpers.h"
+#include <chrono>
+#include <new>
+#include <stdlib.h>
+#include <vector>
+
+// Count every heap allocation made in this test program, to see what each serializer costs
+static size_t allocations = 0;
+
+void *operator new(size_t size)
+{
+    allocations++;
+    void *p = malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+namespace
+{
+struct SerializerCase {
+    const char *name;
+    meshtastic_MeshPacket packet;
+};
+
+template <typename T> meshtastic_MeshPacket encodePacket(meshtastic_PortNum port, const pb_msgdesc_t *fields, const T &msg)
+{
+    uint8_t buffer[meshtastic_Constants_DATA_PAYLOAD_LEN];
+    pb_ostream_t stream = pb_ostream_from_buffer(buffer, sizeof(buffer));
+    pb_encode(&stream, fields, &msg);
+    return create_test_packet(port, buffer, stream.bytes_written);
+}
+
+meshtastic_MeshPacket textPacket(const char *text)
+{
+    return create_test_packet(meshtastic_PortNum_TEXT_MESSAGE_APP, (const uint8_t *)text, strlen(text));
+}
+
+// One packet of every kind JsonSerialize knows, with all their fields set
+std::vector<SerializerCase> makeCases()
+{
+    std::vector<SerializerCase> cases;
+    cases.push_back({"text", textPacket("Hello from the mesh! Anyone on the summit tonight?")});
+    cases.push_back({"text escaped", textPacket("\"quotes\" and \\backslash/ and\ttabs\r\nand \x01 control")});
+    cases.push_back({"text json", textPacket(" {\"temp\": 21.5, \"tags\": [\"a\", \"b\"], \"ok\": true} ")});
+    cases.push_back({"text json literal", textPacket("\r\n-12.5E3\t")});
+    cases.push_back({"text almost json", textPacket("nice one, see you at 5")});
+    // Just outside what JSON::Parse takes, so they stay plain text
+    cases.push_back({"text almost json number", textPacket("1.")});
+    cases.push_back({"text almost json vertical tab", textPacket("\v{\"a\": 1}")});
+    cases.push_back({"text almost json form feed", textPacket("[true]\f")});
+    cases.push_back({"detection", create_test_packet(meshtastic_PortNum_DETECTION_SENSOR_APP, (const uint8_t *)"Motion", 6)});
+
+    meshtastic_Telemetry telemetry = meshtastic_Telemetry_init_zero;
+    telemetry.which_variant = meshtastic_Telemetry_device_metrics_tag;
+    meshtastic_DeviceMetrics &device = telemetry.variant.device_metrics;
+    device.has_battery_level = device.has_voltage = device.has_channel_utilization = true;
+    device.has_air_util_tx = device.has_uptime_seconds = true;
+    device.battery_level = 85;
+    device.voltage = 3.72f;
+    device.channel_utilization = 15.56f;
+    device.air_util_tx = 8.23f;
+    device.uptime_seconds = 12345;
+    cases.push_back({"device metrics", encodePacket(meshtastic_PortNum_TELEMETRY_APP, &meshtastic_Telemetry_msg, telemetry)});
+
+    telemetry = meshtastic_Telemetry_init_zero;
+    telemetry.which_variant = meshtastic_Telemetry_environment_metrics_tag;
+    meshtastic_EnvironmentMetrics &env = telemetry.variant.environment_metrics;
+    env.has_temperature = env.has_relative_humidity = env.has_barometric_pressure = env.has_gas_resistance = true;
+    env.has_voltage = env.has_current = env.has_iaq = env.has_distance = env.has_lux = env.has_white_lux = true;
+    env.has_ir_lux = env.has_uv_lux = env.has_wind_direction = env.has_wind_speed = env.has_weight = true;
+    env.has_wind_gust = env.has_wind_lull = env.has_radiation = env.has_rainfall_1h = env.has_rainfall_24h = true;
+    env.has_soil_moisture = env.has_soil_temperature = true;
+    env.temperature = 23.56f;
+    env.relative_humidity = 65.43f;
+    env.barometric_pressure = 1013.27f;
+    env.gas_resistance = 50.58f;
+    env.voltage = 3.34f;
+    env.current = 0.53f;
+    env.iaq = 120;
+    env.distance = 150.29f;
+    env.lux = 450.12f;
+    env.white_lux = 380.95f;
+    env.ir_lux = 25.37f;
+    env.uv_lux = 15.68f;
+    env.wind_direction = 180;
+    env.wind_speed = 5.52f;
+    env.weight = 75.56f;
+    env.wind_gust = 8.24f;
+    env.wind_lull = 2.13f;
+    env.radiation = 0.13f;
+    env.rainfall_1h = 2.57f;
+    env.rainfall_24h = 15.89f;
+    env.soil_moisture = 85;
+    env.soil_temperature = 18.54f;
+    cases.push_back(
+        {"environment metrics", encodePacket(meshtastic_PortNum_TELEMETRY_APP, &meshtastic_Telemetry_msg, telemetry)});
+
+    telemetry = meshtastic_Telemetry_init_zero;
+    telemetry.which_variant = meshtastic_Telemetry_air_quality_metrics_tag;
+    meshtastic_AirQualityMetrics &air = telemetry.variant.air_quality_metrics;
+    air.has_pm10_standard = air.has_pm25_standard = air.has_pm100_standard = true;
+    air.has_pm10_environmental = air.has_pm25_environmental = air.has_pm100_environmental = true;
+    air.pm10_standard = 10;
+    air.pm25_standard = 25;
+    air.pm100_standard = 100;
+    air.pm10_environmental = 11;
+    air.pm25_environmental = 26;
+    air.pm100_environmental = 101;
+    cases.push_back({"air quality", encodePacket(meshtastic_PortNum_TELEMETRY_APP, &meshtastic_Telemetry_msg, telemetry)});
+
+    telemetry = meshtastic_Telemetry_init_zero;
+    telemetry.which_variant = meshtastic_Telemetry_power_metrics_tag;
+    meshtastic_PowerMetrics &power = telemetry.variant.power_metrics;
+    power.has_ch1_voltage = power.has_ch1_current = power.has_ch2_voltage = power.has_ch2_current = true;
+    power.has_ch3_voltage = power.has_ch3_current = true;
+    power.ch1_voltage = 5.1f;
+    power.ch1_current = 120.5f;
+    power.ch2_voltage = 3.3f;
+    power.ch2_current = 45.25f;
+    power.ch3_voltage = 12.0f;
+    power.ch3_current = 800;
+    cases.push_back({"power metrics", encodePacket(meshtastic_PortNum_TELEMETRY_APP, &meshtastic_Telemetry_msg, telemetry)});
+
+    meshtastic_User user = meshtastic_User_init_zero;
+    strcpy(user.id, "!11223344");
+    strcpy(user.long_name, "Mountain Relay \xf0\x9f\x8f\x94");
+    strcpy(user.short_name, "MTN");
+    user.hw_model = meshtastic_HardwareModel_HELTEC_V3;
+    user.role = meshtastic_Config_DeviceConfig_Role_ROUTER;
+    cases.push_back({"nodeinfo", encodePacket(meshtastic_PortNum_NODEINFO_APP, &meshtastic_User_msg, user)});
+
+    meshtastic_Position position = meshtastic_Position_init_zero;
+    position.latitude_i = 374208000;
+    position.longitude_i = -1221981000;
+    position.altitude = 123;
+    position.time = 1609459200;
+    position.timestamp = 1609459199;
+    position.ground_speed = 12;
+    position.ground_track = 270;
+    position.sats_in_view = 9;
+    position.PDOP = 150;
+    position.HDOP = 120;
+    position.VDOP = 90;
+    position.precision_bits = 32;
+    cases.push_back({"position", encodePacket(meshtastic_PortNum_POSITION_APP, &meshtastic_Position_msg, position)});
+
+    meshtastic_Waypoint waypoint = meshtastic_Waypoint_init_zero;
+    waypoint.id = 12345;
+    waypoint.latitude_i = 374208000;
+    waypoint.longitude_i = -1221981000;
+    waypoint.expire = 1609545600;
+    waypoint.locked_to = 0x11223344;
+    strcpy(waypoint.name, "Camp / \"base\"");
+    strcpy(waypoint.description, "Water and shade");
+    cases.push_back({"waypoint", encodePacket(meshtastic_PortNum_WAYPOINT_APP, &meshtastic_Waypoint_msg, waypoint)});
+
+    meshtastic_NeighborInfo neighbors = meshtastic_NeighborInfo_init_zero;
+    neighbors.node_id = 0x11223344;
+    neighbors.last_sent_by_id = 0x55667788;
+    neighbors.node_broadcast_interval_secs = 900;
+    neighbors.neighbors_count = 3;
+    for (int i = 0; i < 3; i++) {
+        neighbors.neighbors[i].node_id = 0x1000 + i;
+        neighbors.neighbors[i].snr = 6.25f - i * 4;
+    }
+    cases.push_back(
+        {"neighborinfo", encodePacket(meshtastic_PortNum_NEIGHBORINFO_APP, &meshtastic_NeighborInfo_msg, neighbors)});
+
+    // Traceroute responses look up the names of the nodes on the route, and there is no NodeDB here, so only a request
+    meshtastic_RouteDiscovery route = meshtastic_RouteDiscovery_init_zero;
+    cases.push_back({"traceroute", encodePacket(meshtastic_PortNum_TRACEROUTE_APP, &meshtastic_RouteDiscovery_msg, route)});
+
+    meshtastic_HardwareMessage hardware = meshtastic_HardwareMessage_init_zero;
+    hardware.type = meshtastic_HardwareMessage_Type_READ_GPIOS_REPLY;
+    hardware.gpio_mask = 0xff;
+    hardware.gpio_value = 0x5a;
+    cases.push_back(
+        {"remote hardware", encodePacket(meshtastic_PortNum_REMOTE_HARDWARE_APP, &meshtastic_HardwareMessage_msg, hardware)});
+
+    meshtastic_MeshPacket undecodable = create_test_packet(meshtastic_PortNum_POSITION_APP, (const uint8_t *)"\xff\xff\xff", 3);
+    cases.push_back({"undecodable", undecodable});
+    return cases;
+}
+
+// time_ms is the time of serializing, so it differs between two calls
+std::string withoutTime(std::string json)
+{
+    size_t start = json.find("\"time_ms\":");
+    if (start != std::string::npos)
+        json.erase(start, json.find(',', start) + 1 - start);
+    return json;
+}
+
+double usecsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+} // namespace
+
+// The streaming serializer writes exactly the text the JSONValue tree did, for every kind of packet
+void test_streaming_matches_tree()
+{
+    char buf[MESHPACKET_JSON_SIZE];
+    for (const SerializerCase &c : makeCases()) {
+        std::string expected = MeshPacketSerializer::JsonSerialize(&c.packet, false);
+        size_t length = MeshPacketSerializer::JsonSerialize(&c.packet, buf, sizeof(buf), false);
+        TEST_ASSERT_EQUAL_STRING_MESSAGE(expected.c_str(), buf, c.name);
+        TEST_ASSERT_EQUAL_MESSAGE(expected.length(), length, c.name);
+    }
+
+    meshtastic_MeshPacket encrypted = meshtastic_MeshPacket_init_zero;
+    encrypted.id = 0x9999;
+    encrypted.from = 0x11223344;
+    encrypted.to = 0x55667788;
+    encrypted.rx_snr = -7.25f;
+    encrypted.want_ack = true;
+    encrypted.which_payload_variant = meshtastic_MeshPacket_encrypted_tag;
+    encrypted.encrypted.size = 200;
+    for (int i = 0; i < 200; i++)
+        encrypted.encrypted.bytes[i] = i * 37;
+    std::string expected = MeshPacketSerializer::JsonSerializeEncrypted(&encrypted);
+    size_t length = MeshPacketSerializer::JsonSerializeEncrypted(&encrypted, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING(withoutTime(expected).c_str(), withoutTime(buf).c_str());
+    TEST_ASSERT_TRUE(length > 0);
+}
+
+// Too small a buffer gives 0 rather than cut off JSON, and buf stays terminated
+void test_streaming_buffer_too_small()
+{
+    meshtastic_MeshPacket packet = textPacket("This message does not fit in the buffer");
+    std::string expected = MeshPacketSerializer::JsonSerialize(&packet, false);
+
+    std::vector<char> buf(expected.length() + 1);
+    TEST_ASSERT_EQUAL(expected.length(), MeshPacketSerializer::JsonSerialize(&packet, buf.data(), buf.size(), false));
+    TEST_ASSERT_EQUAL(0, MeshPacketSerializer::JsonSerialize(&packet, buf.data(), buf.size() - 1, false));
+    TEST_ASSERT_TRUE(strlen(buf.data()) < buf.size() - 1);
+}
+
+// Time and heap allocations per packet of the JSONValue tree and of the streaming writer, which should make none
+// except when a text message is JSON itself
+void test_streaming_benchmark()
+{
+    const int rounds = 2000;
+    char buf[MESHPACKET_JSON_SIZE];
+
+    for (const SerializerCase &c : makeCases()) {
+        size_t before = allocations;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < rounds; i++)
+            MeshPacketSerializer::JsonSerialize(&c.packet, false);
+        double treeUsecs = usecsSince(start) / rounds;
+        size_t treeAllocations = (allocations - before) / rounds;
+
+        before = allocations;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < rounds; i++)
+            MeshPacketSerializer::JsonSerialize(&c.packet, buf, sizeof(buf), false);
+        double streamUsecs = usecsSince(start) / rounds;
+        size_t streamAllocations = (allocations - before) / rounds;
+
+        char msg[160];
+        snprintf(msg, sizeof(msg), "%s: %.2fus, %u allocations -> %.2fus, %u allocations", c.name, treeUsecs,
+                 (unsigned)treeAllocations, streamUsecs, (unsigned)streamAllocations);
+        TEST_MESSAGE(msg);
+        if (strncmp(c.name, "text json", 9) != 0)
+            TEST_ASSERT_EQUAL_MESSAGE(0, streamAllocations, c.name);
+    }
+}
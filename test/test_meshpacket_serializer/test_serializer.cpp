@@ -14,6 +14,9 @@ void test_telemetry_environment_metrics_missing_fields();
 void test_telemetry_environment_metrics_complete_coverage();
 void test_telemetry_environment_metrics_unset_fields();
 void test_encrypted_packet_serialization();
+void test_streaming_matches_tree();
+void test_streaming_buffer_too_small();
+void test_streaming_benchmark();
 
 void setup()
 {
@@ -42,6 +45,11 @@ void setup()
     // Encrypted packet test
     RUN_TEST(test_encrypted_packet_serialization);
 
+    // Streaming serializer tests
+    RUN_TEST(test_streaming_matches_tree);
+    RUN_TEST(test_streaming_buffer_too_small);
+    RUN_TEST(test_streaming_benchmark);
+
     UNITY_END();
 }
 
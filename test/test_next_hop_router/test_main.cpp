@@ -0,0 +1,164 @@
+#include "DebugConfiguration.h"
+#include "TestUtil.h"
+#include <unity.h>
+
+#ifdef ARCH_PORTDUINO
+#include "airtime.h"
+#include "mesh/MeshService.h"
+#include "mesh/NextHopRouter.h"
+#include "mesh/NodeDB.h"
+#include "mesh/RadioInterface.h"
+
+#include <memory>
+#include <vector>
+
+namespace
+{
+// Records what would have gone on the air
+class FakeRadio : public RadioInterface
+{
+  public:
+    ErrorCode send(meshtastic_MeshPacket *p) override
+    {
+        // RadioInterface::beginSending() asserts on anything that isn't encrypted, remember it instead
+        sentVariants.push_back(p->which_payload_variant);
+        packetPool.release(p);
+        return ERRNO_OK;
+    }
+    std::vector<pb_size_t> sentVariants;
+};
+
+// Knows a next hop for every destination, so relayed packets get a retransmission record
+class MockNodeDB : public NodeDB
+{
+  public:
+    meshtastic_NodeInfoLite *getMeshNode(NodeNum n) override { return &node; }
+    meshtastic_NodeInfoLite node = {};
+};
+
+class MockMeshService : public MeshService
+{
+  public:
+    void sendClientNotification(meshtastic_ClientNotification *n) override { releaseClientNotificationToPool(n); }
+};
+
+class TestRouter : public NextHopRouter
+{
+  public:
+    using NextHopRouter::doRetransmissions;
+    using NextHopRouter::findPendingPacket;
+    using NextHopRouter::stopRetransmission;
+
+    /// Make a pending retransmission due now
+    void makeDue(PendingPacket *rec) { retransmissions.schedule(rec, 0, millis()); }
+};
+
+FakeRadio *radio;
+TestRouter *testRouter;
+
+meshtastic_MeshPacket makeRelayedPacket(PacketId id)
+{
+    meshtastic_MeshPacket p = meshtastic_MeshPacket_init_zero;
+    p.from = 0x1234;
+    p.to = 0x5678;
+    p.id = id;
+    p.hop_limit = 3;
+    p.which_payload_variant = meshtastic_MeshPacket_decoded_tag;
+    p.decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_APP;
+    p.decoded.payload.size = 5;
+    memcpy(p.decoded.payload.bytes, "hello", 5);
+    return p;
+}
+} // namespace
+
+void setUp(void)
+{
+    radio->sentVariants.clear();
+    config.lora.override_duty_cycle = false;
+}
+
+void tearDown(void)
+{
+    // clean stuff up here
+}
+
+// A relayed packet whose first send was dropped for the duty cycle is still decoded when its retry comes up.  The retry must
+// encrypt it rather than hand the decoded packet to the radio.
+void test_retry_after_aborted_send(void)
+{
+    meshtastic_MeshPacket p = makeRelayedPacket(42);
+    testRouter->send(packetPool.allocCopy(p)); // over the duty cycle, dropped before it got encrypted
+    TEST_ASSERT_EQUAL(0, radio->sentVariants.size());
+    PendingPacket *rec = testRouter->findPendingPacket(p.from, p.id);
+    TEST_ASSERT_NOT_NULL(rec);
+    TEST_ASSERT_EQUAL(meshtastic_MeshPacket_decoded_tag, rec->packet->which_payload_variant);
+
+    config.lora.override_duty_cycle = true;
+    testRouter->makeDue(rec);
+    testRouter->doRetransmissions();
+    TEST_ASSERT_EQUAL(1, radio->sentVariants.size());
+    TEST_ASSERT_EQUAL(meshtastic_MeshPacket_encrypted_tag, radio->sentVariants[0]);
+
+    // From now on the record holds the on-air form
+    rec = testRouter->findPendingPacket(p.from, p.id);
+    TEST_ASSERT_NOT_NULL(rec);
+    TEST_ASSERT_EQUAL(meshtastic_MeshPacket_encrypted_tag, rec->packet->which_payload_variant);
+    testRouter->stopRetransmission(p.from, p.id);
+}
+
+// The usual case: the first send went out, the retry is the same encrypted packet
+void test_retry_after_sent(void)
+{
+    config.lora.override_duty_cycle = true;
+    meshtastic_MeshPacket p = makeRelayedPacket(43);
+    testRouter->send(packetPool.allocCopy(p));
+    TEST_ASSERT_EQUAL(1, radio->sentVariants.size());
+
+    PendingPacket *rec = testRouter->findPendingPacket(p.from, p.id);
+    TEST_ASSERT_NOT_NULL(rec);
+    testRouter->makeDue(rec);
+    testRouter->doRetransmissions();
+    TEST_ASSERT_EQUAL(2, radio->sentVariants.size());
+    TEST_ASSERT_EQUAL(meshtastic_MeshPacket_encrypted_tag, radio->sentVariants[1]);
+    testRouter->stopRetransmission(p.from, p.id);
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    const std::unique_ptr<MockNodeDB> mockNodeDB(new MockNodeDB());
+    nodeDB = mockNodeDB.get();
+    // Any next hop that isn't us
+    mockNodeDB->node.next_hop = nodeDB->getLastByteOfNodeNum(nodeDB->getNodeNum()) == 0x42 ? 0x43 : 0x42;
+
+    config.lora.region = meshtastic_Config_LoRaConfig_RegionCode_EU_868; // has a duty cycle limit
+    initRegion();
+    airTime = new AirTime();
+    airTime->logAirtime(TX_LOG, MS_IN_HOUR / 2);
+    service = new MockMeshService();
+
+    radio = new FakeRadio();
+    router = testRouter = new TestRouter();
+    testRouter->addInterface(radio);
+
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_retry_after_aborted_send);
+    RUN_TEST(test_retry_after_sent);
+    exit(UNITY_END()); // stop unit testing
+}
+#else
+void setup()
+{
+    initializeTestEnvironment();
+    LOG_WARN("This test needs a NodeDB and router, only available on ARCH_PORTDUINO");
+    UNITY_BEGIN();
+    UNITY_END();
+}
+#endif
+
+void loop() {}
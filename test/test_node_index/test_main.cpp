@@ -0,0 +1,147 @@
+#include "mesh/NodeNumIndex.h"
+
+#include "TestUtil.h"
+#include <unity.h>
+
+#include <chrono>
+#include <random>
+
+static std::vector<meshtastic_NodeInfoLite> makeNodes(size_t count, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<meshtastic_NodeInfoLite> nodes(count);
+    for (size_t i = 0; i < count; i++) {
+        memset(&nodes[i], 0, sizeof(nodes[i]));
+        // Mimic MAC derived node numbers: shared high bytes, varying low bytes
+        nodes[i].num = 0xa0b00000 | (rng() & 0xfffff);
+        for (size_t j = 0; j < i; j++) {
+            if (nodes[j].num == nodes[i].num) {
+                nodes[i].num ^= (uint32_t)i << 20;
+                break;
+            }
+        }
+    }
+    return nodes;
+}
+
+static int linearFind(const std::vector<meshtastic_NodeInfoLite> &nodes, size_t count, NodeNum n)
+{
+    for (size_t i = 0; i < count; i++)
+        if (nodes[i].num == n)
+            return i;
+    return -1;
+}
+
+void setUp(void)
+{
+    // set stuff up here
+}
+
+void tearDown(void)
+{
+    // clean stuff up here
+}
+
+void test_find_after_rebuild(void)
+{
+    auto nodes = makeNodes(200, 1);
+    NodeNumIndex index;
+    index.rebuild(nodes, nodes.size());
+
+    for (size_t i = 0; i < nodes.size(); i++)
+        TEST_ASSERT_EQUAL(i, index.find(nodes, nodes[i].num));
+    TEST_ASSERT_EQUAL(-1, index.find(nodes, 0x12345678));
+}
+
+void test_insert_and_erase(void)
+{
+    auto nodes = makeNodes(100, 2);
+    NodeNumIndex index;
+    index.reset(nodes.size());
+
+    for (size_t i = 0; i < 50; i++)
+        index.insert(nodes, i);
+    TEST_ASSERT_EQUAL(-1, index.find(nodes, nodes[60].num));
+
+    // Remove every third node and make sure the rest of each probe run is still reachable
+    for (size_t i = 0; i < 50; i += 3)
+        index.erase(nodes, nodes[i].num);
+    for (size_t i = 0; i < 50; i++)
+        TEST_ASSERT_EQUAL(i % 3 == 0 ? -1 : (int)i, index.find(nodes, nodes[i].num));
+}
+
+void test_moved_record(void)
+{
+    auto nodes = makeNodes(20, 3);
+    NodeNumIndex index;
+    index.rebuild(nodes, nodes.size());
+
+    // Moving a record without telling the index must never return the wrong node
+    std::swap(nodes[3], nodes[7]);
+    int pos = index.find(nodes, nodes[3].num);
+    TEST_ASSERT_TRUE(pos == -1 || nodes[pos].num == nodes[3].num);
+
+    index.rebuild(nodes, nodes.size());
+    TEST_ASSERT_EQUAL(3, index.find(nodes, nodes[3].num));
+    TEST_ASSERT_EQUAL(7, index.find(nodes, nodes[7].num));
+}
+
+void test_duplicate_first_wins(void)
+{
+    auto nodes = makeNodes(10, 4);
+    nodes[8].num = nodes[2].num;
+    NodeNumIndex index;
+    index.rebuild(nodes, nodes.size());
+    TEST_ASSERT_EQUAL(2, index.find(nodes, nodes[2].num));
+}
+
+// Not a pass/fail test: prints lookup cost of the index vs. the old linear scan for growing node counts
+void test_lookup_benchmark(void)
+{
+    const size_t lookups = 200000;
+    char msg[128];
+
+    for (size_t count = 16; count <= 4096; count *= 4) {
+        auto nodes = makeNodes(count, count);
+        NodeNumIndex index;
+        index.rebuild(nodes, count);
+
+        // Half hits, half misses, like a mix of known nodes and strangers
+        std::vector<NodeNum> keys(lookups);
+        for (size_t i = 0; i < lookups; i++)
+            keys[i] = (i & 1) ? nodes[(i * 7919) % count].num : (NodeNum)(0x10000000 + i);
+
+        volatile long sink = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < lookups; i++)
+            sink += linearFind(nodes, count, keys[i]);
+        auto mid = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < lookups; i++)
+            sink += index.find(nodes, keys[i]);
+        auto end = std::chrono::steady_clock::now();
+
+        double scanNs = std::chrono::duration<double, std::nano>(mid - start).count() / lookups;
+        double hashNs = std::chrono::duration<double, std::nano>(end - mid).count() / lookups;
+        snprintf(msg, sizeof(msg), "nodes=%u scan=%.1fns/lookup hashed=%.1fns/lookup", (unsigned)count, scanNs, hashNs);
+        TEST_MESSAGE(msg);
+    }
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_find_after_rebuild);
+    RUN_TEST(test_insert_and_erase);
+    RUN_TEST(test_moved_record);
+    RUN_TEST(test_duplicate_first_wins);
+    RUN_TEST(test_lookup_benchmark);
+    exit(UNITY_END()); // stop unit testing
+}
+
+void loop() {}
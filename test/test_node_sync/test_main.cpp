@@ -0,0 +1,251 @@
+#include "mesh/NodeChangeTracker.h"
+#include "mesh/NodeDB.h"
+#include "mesh/generated/meshtastic/mesh.pb.h"
+
+#include "TestUtil.h"
+#include <memory>
+#include <pb_encode.h>
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+
+namespace
+{
+const size_t NUM_NODES = 200;
+
+// Something like what a node that has been on the mesh for a while knows about another node
+meshtastic_NodeInfo makeNode(size_t i)
+{
+    meshtastic_NodeInfo info = meshtastic_NodeInfo_init_zero;
+    info.num = 0x10000000 + i * 7919;
+    info.has_user = true;
+    snprintf(info.user.id, sizeof(info.user.id), "!%08x", info.num);
+    snprintf(info.user.long_name, sizeof(info.user.long_name), "Meshtastic %04x", (unsigned)(info.num & 0xffff));
+    snprintf(info.user.short_name, sizeof(info.user.short_name), "%04x", (unsigned)(info.num & 0xffff));
+    info.user.hw_model = meshtastic_HardwareModel_HELTEC_V3;
+    info.user.public_key.size = 32;
+    memset(info.user.public_key.bytes, (int)i, 32);
+    info.has_position = true;
+    info.position.has_latitude_i = true;
+    info.position.latitude_i = 523000000 + i * 1000;
+    info.position.has_longitude_i = true;
+    info.position.longitude_i = 49000000 + i * 1000;
+    info.position.time = 1700000000 + i;
+    info.has_device_metrics = true;
+    info.device_metrics.has_battery_level = true;
+    info.device_metrics.battery_level = 80;
+    info.snr = 6.5f;
+    info.last_heard = 1700000000 + i;
+    info.has_hops_away = true;
+    info.hops_away = i % 4;
+    return info;
+}
+
+// Protobuf bytes of one FromRadio, before any transport framing
+size_t fromRadioSize(const meshtastic_FromRadio &fromRadio)
+{
+    size_t size = 0;
+    TEST_ASSERT_TRUE(pb_get_encoded_size(&size, meshtastic_FromRadio_fields, &fromRadio));
+    return size;
+}
+
+// The node part of a config download: every node that gets sent, then config_complete_id
+size_t streamNodes(const NodeChangeTracker &changes, bool onlyChanged, NodeChangeTracker::Generation since, size_t *sent)
+{
+    size_t bytes = 0;
+    *sent = 0;
+    meshtastic_FromRadio fromRadio = meshtastic_FromRadio_init_zero;
+    for (size_t i = 0; i < NUM_NODES; i++) {
+        if (onlyChanged && !changes.changedSince(i, since))
+            continue;
+        fromRadio.id++;
+        fromRadio.which_payload_variant = meshtastic_FromRadio_node_info_tag;
+        fromRadio.node_info = makeNode(i);
+        bytes += fromRadioSize(fromRadio);
+        (*sent)++;
+    }
+    fromRadio.id++;
+    fromRadio.which_payload_variant = meshtastic_FromRadio_config_complete_id_tag;
+    fromRadio.config_complete_id = changes.getToken();
+    return bytes + fromRadioSize(fromRadio);
+}
+} // namespace
+
+void setUp(void)
+{
+    // set stuff up here
+}
+
+void tearDown(void)
+{
+    // clean stuff up here
+}
+
+void test_changed_since_token(void)
+{
+    NodeChangeTracker changes;
+    changes.seed(0x1234);
+    for (size_t i = 0; i < 5; i++)
+        changes.touch(i);
+
+    uint32_t token = changes.getToken();
+    NodeChangeTracker::Generation since;
+    TEST_ASSERT_TRUE(changes.accept(token, since));
+    for (size_t i = 0; i < 5; i++)
+        TEST_ASSERT_FALSE(changes.changedSince(i, since));
+
+    changes.touch(2);
+    changes.touch(40); // beyond the slots used so far
+    TEST_ASSERT_TRUE(changes.accept(token, since));
+    TEST_ASSERT_TRUE(changes.changedSince(2, since));
+    TEST_ASSERT_TRUE(changes.changedSince(40, since));
+    TEST_ASSERT_FALSE(changes.changedSince(3, since));
+    TEST_ASSERT_FALSE(changes.changedSince(41, since));
+
+    // Older tokens see more
+    NodeChangeTracker::Generation start;
+    TEST_ASSERT_TRUE(changes.accept(changes.getToken() & 0xffff0000, start));
+    TEST_ASSERT_TRUE(changes.changedSince(0, start));
+}
+
+void test_invalid_tokens_refused(void)
+{
+    NodeChangeTracker changes;
+    changes.seed(0x1234);
+    changes.touch(0);
+    uint32_t token = changes.getToken();
+    NodeChangeTracker::Generation since;
+
+    TEST_ASSERT_FALSE(changes.accept(token + 1, since));      // from the future
+    TEST_ASSERT_FALSE(changes.accept(token ^ 0x10000, since)); // another epoch, e.g. before a reboot
+
+    // A removal starts a new epoch, the removed node can't be sent as a change
+    changes.reset();
+    TEST_ASSERT_FALSE(changes.accept(token, since));
+    TEST_ASSERT_TRUE(changes.accept(changes.getToken(), since));
+    TEST_ASSERT_FALSE(changes.changedSince(0, since));
+}
+
+void test_special_nonces_never_tokens(void)
+{
+    NodeChangeTracker changes;
+    NodeChangeTracker::Generation since;
+    for (uint16_t epoch : {0, 1, 0xfff, 0xffff}) {
+        changes.seed(epoch);
+        for (int i = 0; i < 100; i++)
+            changes.touch(i);
+        TEST_ASSERT_TRUE(NodeChangeTracker::isToken(changes.getToken()));
+        // SPECIAL_NONCE_ONLY_CONFIG, SPECIAL_NONCE_ONLY_NODES and SPECIAL_NONCE_NODES_SYNC
+        TEST_ASSERT_FALSE(changes.accept(69420, since));
+        TEST_ASSERT_FALSE(changes.accept(69421, since));
+        TEST_ASSERT_FALSE(changes.accept(69422, since));
+        // An ordinary nonce that happens to match the epoch and generation, but not the marker
+        TEST_ASSERT_FALSE(changes.accept(changes.getToken() & ~NodeChangeTracker::TOKEN_MARKER_MASK, since));
+        TEST_ASSERT_FALSE(changes.accept(changes.getToken() ^ 0x40000000, since));
+    }
+
+    // Epochs wrap without leaving the reserved range
+    changes.seed(0xfff);
+    changes.reset();
+    TEST_ASSERT_EQUAL_HEX32(0xa0000000, changes.getToken());
+}
+
+void test_generation_wrap_starts_new_epoch(void)
+{
+    NodeChangeTracker changes;
+    changes.seed(100);
+    for (uint32_t i = 0; i < UINT16_MAX; i++)
+        changes.touch(i % 10);
+    uint32_t token = changes.getToken();
+    NodeChangeTracker::Generation since;
+    TEST_ASSERT_TRUE(changes.accept(token, since));
+
+    changes.touch(3);
+    TEST_ASSERT_FALSE(changes.accept(token, since));
+    TEST_ASSERT_TRUE(changes.accept(changes.getToken() - 1, since));
+    TEST_ASSERT_TRUE(changes.changedSince(3, since));
+    TEST_ASSERT_FALSE(changes.changedSince(4, since));
+}
+
+// A client reconnects after a handful of nodes were heard: only those are sent again
+void test_warm_reconnect_bytes(void)
+{
+    NodeChangeTracker changes;
+    changes.seed(0x4321);
+    for (size_t i = 0; i < NUM_NODES; i++)
+        changes.touch(i);
+
+    size_t coldSent, warmSent, idleSent;
+    size_t coldBytes = streamNodes(changes, false, 0, &coldSent);
+    uint32_t token = changes.getToken();
+
+    const size_t heard = 12;
+    for (size_t i = 0; i < heard; i++)
+        changes.touch(i * 13 % NUM_NODES);
+
+    NodeChangeTracker::Generation since;
+    TEST_ASSERT_TRUE(changes.accept(token, since));
+    size_t warmBytes = streamNodes(changes, true, since, &warmSent);
+    TEST_ASSERT_EQUAL(NUM_NODES, coldSent);
+    TEST_ASSERT_EQUAL(heard, warmSent);
+    TEST_ASSERT_TRUE(warmBytes * 10 < coldBytes);
+
+    // Nothing changed since, only config_complete_id is sent
+    TEST_ASSERT_TRUE(changes.accept(changes.getToken(), since));
+    size_t idleBytes = streamNodes(changes, true, since, &idleSent);
+    TEST_ASSERT_EQUAL(0, idleSent);
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "%u nodes: full sync %u bytes, warm reconnect after %u changes %u bytes, unchanged %u bytes",
+             (unsigned)NUM_NODES, (unsigned)coldBytes, (unsigned)heard, (unsigned)warmBytes, (unsigned)idleBytes);
+    TEST_MESSAGE(msg);
+}
+
+// A full node database evicts a node for every new one, that must not send syncing clients back to a full download
+void test_eviction_keeps_token(void)
+{
+    const std::unique_ptr<NodeDB> testNodeDB(new NodeDB());
+    nodeDB = testNodeDB.get();
+
+    meshtastic_Position position = meshtastic_Position_init_zero;
+    position.time = 1700000000;
+    for (NodeNum n = 0x20000000; nodeDB->getNumMeshNodes() < MAX_NUM_NODES; n++)
+        nodeDB->updatePosition(n, position);
+    uint32_t token = nodeDB->getNodeSyncToken();
+
+    const NodeNum newcomer = 0x30000000;
+    nodeDB->updatePosition(newcomer, position);
+    TEST_ASSERT_EQUAL(MAX_NUM_NODES, nodeDB->getNumMeshNodes());
+    TEST_ASSERT_NOT_NULL(nodeDB->getMeshNode(newcomer));
+
+    NodeChangeTracker::Generation since;
+    TEST_ASSERT_TRUE(nodeDB->acceptNodeSyncToken(token, since));
+    TEST_ASSERT_TRUE(nodeDB->nodeChangedSince(nodeDB->getMeshNode(newcomer), since));
+    size_t sent = 0;
+    for (size_t x = 0; x < nodeDB->getNumMeshNodes(); x++)
+        if (nodeDB->nodeChangedSince(nodeDB->getMeshNodeByIndex(x), since))
+            sent++;
+    TEST_ASSERT_LESS_OR_EQUAL(2, sent); // the newcomer, and the node moved into the victim's slot
+
+    nodeDB = nullptr;
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_changed_since_token);
+    RUN_TEST(test_invalid_tokens_refused);
+    RUN_TEST(test_special_nonces_never_tokens);
+    RUN_TEST(test_generation_wrap_starts_new_epoch);
+    RUN_TEST(test_warm_reconnect_bytes);
+    RUN_TEST(test_eviction_keeps_token);
+    exit(UNITY_END()); // stop unit testing
+}
+
+void loop() {}
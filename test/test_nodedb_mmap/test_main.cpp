@@ -0,0 +1,174 @@
+#include "DebugConfiguration.h"
+#include "TestUtil.h"
+#include <unity.h>
+
+#ifdef ARCH_PORTDUINO
+#include "mesh/NodeDBMmapStore.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace
+{
+const char *testMapPath = "/tmp/meshtastic_test_nodes.mmap";
+const size_t CAPACITY = 5000; // far more than a microcontroller could hold
+
+meshtastic_NodeInfoLite makeNode(size_t i)
+{
+    meshtastic_NodeInfoLite node = meshtastic_NodeInfoLite_init_zero;
+    node.num = 0x10000000 + i * 7919;
+    node.has_user = true;
+    snprintf(node.user.long_name, sizeof(node.user.long_name), "Meshtastic %04x", (unsigned)(node.num & 0xffff));
+    node.user.public_key.size = 32;
+    memset(node.user.public_key.bytes, (int)i, 32);
+    node.last_heard = 1700000000 + i;
+    return node;
+}
+
+std::vector<meshtastic_NodeInfoLite> makeNodes(size_t count)
+{
+    std::vector<meshtastic_NodeInfoLite> nodes(CAPACITY);
+    for (size_t i = 0; i < count; i++)
+        nodes[i] = makeNode(i);
+    return nodes;
+}
+} // namespace
+
+void setUp(void)
+{
+    // set stuff up here
+    unlink(testMapPath);
+}
+
+void tearDown(void)
+{
+    // clean stuff up here
+    unlink(testMapPath);
+}
+
+void test_round_trip(void)
+{
+    std::vector<meshtastic_NodeInfoLite> nodes = makeNodes(300), loaded(CAPACITY);
+    uint32_t version = 0;
+    {
+        NodeDBMmapStore store;
+        TEST_ASSERT_TRUE(store.open(testMapPath, CAPACITY));
+        TEST_ASSERT_EQUAL(-1, store.load(loaded, version)); // Never saved, NodeDB loads nodes.proto instead
+        TEST_ASSERT_TRUE(store.save(nodes, 300, 24));
+    }
+
+    NodeDBMmapStore store;
+    TEST_ASSERT_TRUE(store.open(testMapPath, CAPACITY));
+    TEST_ASSERT_EQUAL(300, store.load(loaded, version));
+    TEST_ASSERT_EQUAL_UINT32(24, version);
+    TEST_ASSERT_EQUAL_MEMORY(nodes.data(), loaded.data(), 300 * sizeof(meshtastic_NodeInfoLite));
+}
+
+// Saving again only rewrites the records that changed
+void test_only_changed_records_written(void)
+{
+    std::vector<meshtastic_NodeInfoLite> nodes = makeNodes(300);
+    NodeDBMmapStore store;
+    TEST_ASSERT_TRUE(store.open(testMapPath, CAPACITY));
+    TEST_ASSERT_TRUE(store.save(nodes, 300, 24));
+    TEST_ASSERT_EQUAL(300, store.getDirtyRecords());
+
+    TEST_ASSERT_TRUE(store.save(nodes, 300, 24));
+    TEST_ASSERT_EQUAL(0, store.getDirtyRecords());
+
+    nodes[17].is_favorite = true;
+    nodes[300] = makeNode(300);
+    TEST_ASSERT_TRUE(store.save(nodes, 301, 24));
+    TEST_ASSERT_EQUAL(2, store.getDirtyRecords());
+
+    // Removing the last node only changes the count
+    TEST_ASSERT_TRUE(store.save(nodes, 300, 24));
+    TEST_ASSERT_EQUAL(0, store.getDirtyRecords());
+    std::vector<meshtastic_NodeInfoLite> loaded(CAPACITY);
+    uint32_t version;
+    TEST_ASSERT_EQUAL(300, store.load(loaded, version));
+    TEST_ASSERT_TRUE(loaded[17].is_favorite);
+}
+
+// A damaged record is dropped, not the whole database
+void test_damaged_record_dropped(void)
+{
+    std::vector<meshtastic_NodeInfoLite> nodes = makeNodes(10), loaded(CAPACITY);
+    uint32_t version;
+    {
+        NodeDBMmapStore store;
+        TEST_ASSERT_TRUE(store.open(testMapPath, CAPACITY));
+        TEST_ASSERT_TRUE(store.save(nodes, 10, 24));
+    }
+
+    // Flip a byte in the 4th record
+    FILE *f = fopen(testMapPath, "r+b");
+    TEST_ASSERT_NOT_NULL(f);
+    fseek(f, NodeDBMmapStore::recordOffset(3) + 20, SEEK_SET);
+    int c = fgetc(f);
+    fseek(f, -1, SEEK_CUR);
+    fputc(c ^ 0xff, f);
+    fclose(f);
+
+    NodeDBMmapStore store;
+    TEST_ASSERT_TRUE(store.open(testMapPath, CAPACITY));
+    TEST_ASSERT_EQUAL(9, store.load(loaded, version));
+    TEST_ASSERT_EQUAL_UINT32(nodes[2].num, loaded[2].num);
+    TEST_ASSERT_EQUAL_UINT32(nodes[4].num, loaded[3].num);
+}
+
+// Not a pass/fail test: loading and saving a database of thousands of nodes
+void test_benchmark_large_db(void)
+{
+    std::vector<meshtastic_NodeInfoLite> nodes = makeNodes(CAPACITY), loaded(CAPACITY);
+    uint32_t version;
+    NodeDBMmapStore store;
+    TEST_ASSERT_TRUE(store.open(testMapPath, CAPACITY));
+
+    auto start = std::chrono::steady_clock::now();
+    TEST_ASSERT_TRUE(store.save(nodes, CAPACITY, 24));
+    auto fullSave = std::chrono::steady_clock::now() - start;
+
+    nodes[1234].last_heard++;
+    start = std::chrono::steady_clock::now();
+    TEST_ASSERT_TRUE(store.save(nodes, CAPACITY, 24));
+    auto oneNodeSave = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    TEST_ASSERT_EQUAL(CAPACITY, store.load(loaded, version));
+    auto load = std::chrono::steady_clock::now() - start;
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "%u nodes: load %.2fms, first save %.2fms, save after one change %.2fms", (unsigned)CAPACITY,
+             std::chrono::duration<double, std::milli>(load).count(), std::chrono::duration<double, std::milli>(fullSave).count(),
+             std::chrono::duration<double, std::milli>(oneNodeSave).count());
+    TEST_MESSAGE(msg);
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_only_changed_records_written);
+    RUN_TEST(test_damaged_record_dropped);
+    RUN_TEST(test_benchmark_large_db);
+    exit(UNITY_END()); // stop unit testing
+}
+#else
+void setup()
+{
+    initializeTestEnvironment();
+    LOG_WARN("This test requires ARCH_PORTDUINO");
+    UNITY_BEGIN();
+    UNITY_END();
+}
+#endif
+void loop() {}
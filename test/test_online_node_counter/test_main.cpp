@@ -0,0 +1,151 @@
+#include "mesh/OnlineNodeCounter.h"
+
+#include "TestUtil.h"
+#include <unity.h>
+
+#include <random>
+
+#define T0 1700000000
+
+namespace
+{
+struct Node {
+    uint32_t lastHeard;
+    bool viaMqtt;
+};
+
+// The definition the counter replaces: a full scan using sinceLastSeen() semantics
+size_t scanOnline(const std::vector<Node> &nodes, bool localOnly, uint32_t now)
+{
+    size_t n = 0;
+    for (const Node &node : nodes) {
+        if (localOnly && node.viaMqtt)
+            continue;
+        int delta = (int)(now - node.lastHeard);
+        if (delta < 0)
+            delta = 0;
+        if (delta < NUM_ONLINE_SECS)
+            n++;
+    }
+    return n;
+}
+} // namespace
+
+void setUp(void)
+{
+    // set stuff up here
+}
+
+void tearDown(void)
+{
+    // clean stuff up here
+}
+
+void test_nodes_expire(void)
+{
+    OnlineNodeCounter counter;
+    counter.clear(T0);
+    counter.add(T0 - 60, false, T0);
+    counter.add(T0 - 3600, true, T0);
+    counter.add(T0 - 3 * 3600, false, T0); // already offline
+    TEST_ASSERT_EQUAL(2, counter.getNumOnline(false, T0));
+    TEST_ASSERT_EQUAL(1, counter.getNumOnline(true, T0));
+
+    TEST_ASSERT_EQUAL(1, counter.getNumOnline(false, T0 + 3601));
+    TEST_ASSERT_EQUAL(0, counter.getNumOnline(false, T0 + NUM_ONLINE_SECS));
+}
+
+void test_update_moves_node(void)
+{
+    OnlineNodeCounter counter;
+    counter.clear(T0);
+    counter.add(T0 - 7000, false, T0);
+    TEST_ASSERT_EQUAL(1, counter.getNumOnline(true, T0));
+
+    // Heard again via MQTT: no longer local, but online for another two hours
+    counter.remove(T0 - 7000, false, T0 + 600);
+    counter.add(T0 + 600, true, T0 + 600);
+    TEST_ASSERT_EQUAL(0, counter.getNumOnline(true, T0 + 600));
+    TEST_ASSERT_EQUAL(1, counter.getNumOnline(false, T0 + 7000));
+}
+
+// Nodes heard "in the future" (our clock is behind) stay online until the clock passes them by the full window
+void test_future_nodes(void)
+{
+    OnlineNodeCounter counter;
+    counter.clear(100); // no RTC yet, time is uptime
+    counter.add(T0, false, 100);
+    counter.add(0, false, 100);
+    TEST_ASSERT_EQUAL(2, counter.getNumOnline(false, 100));
+    TEST_ASSERT_EQUAL(1, counter.getNumOnline(false, NUM_ONLINE_SECS + 100));
+
+    // Clock gets set
+    TEST_ASSERT_EQUAL(1, counter.getNumOnline(false, T0 + 60));
+    TEST_ASSERT_EQUAL(0, counter.getNumOnline(false, T0 + NUM_ONLINE_SECS + 60));
+    TEST_ASSERT_FALSE(counter.needsRecount());
+}
+
+void test_clock_backwards_requests_recount(void)
+{
+    OnlineNodeCounter counter;
+    counter.clear(T0);
+    counter.getNumOnline(false, T0 - 3600);
+    TEST_ASSERT_TRUE(counter.needsRecount());
+    counter.clear(T0 - 3600);
+    TEST_ASSERT_FALSE(counter.needsRecount());
+}
+
+// Random updates as time moves forward, compared against a scan. The counter works in one minute buckets, so only compare
+// at times where no node is within a minute of its two hour boundary.
+void test_matches_scan(void)
+{
+    std::mt19937 rng(42);
+    std::vector<Node> nodes(300);
+    uint32_t now = T0;
+    OnlineNodeCounter counter;
+    counter.clear(now);
+    for (Node &n : nodes) {
+        n.lastHeard = now - rng() % (3 * 3600);
+        n.viaMqtt = rng() % 3 == 0;
+        counter.add(n.lastHeard, n.viaMqtt, now);
+    }
+
+    for (int step = 0; step < 20000; step++) {
+        now += rng() % 20;
+        Node &n = nodes[rng() % nodes.size()];
+        counter.remove(n.lastHeard, n.viaMqtt, now);
+        n.lastHeard = now - rng() % 30;
+        n.viaMqtt = rng() % 3 == 0;
+        counter.add(n.lastHeard, n.viaMqtt, now);
+
+        bool nearBoundary = false;
+        for (const Node &m : nodes) {
+            uint32_t age = now - m.lastHeard;
+            if (age + OnlineNodeCounter::BUCKET_SECS >= NUM_ONLINE_SECS && age < NUM_ONLINE_SECS + OnlineNodeCounter::BUCKET_SECS)
+                nearBoundary = true;
+        }
+        if (!nearBoundary) {
+            TEST_ASSERT_EQUAL(scanOnline(nodes, false, now), counter.getNumOnline(false, now));
+            TEST_ASSERT_EQUAL(scanOnline(nodes, true, now), counter.getNumOnline(true, now));
+        }
+    }
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_nodes_expire);
+    RUN_TEST(test_update_moves_node);
+    RUN_TEST(test_future_nodes);
+    RUN_TEST(test_clock_backwards_requests_recount);
+    RUN_TEST(test_matches_scan);
+    exit(UNITY_END()); // stop unit testing
+}
+
+void loop() {}
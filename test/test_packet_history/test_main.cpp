@@ -0,0 +1,186 @@
+#include "mesh/NodeDB.h"
+#include "mesh/PacketHistory.h"
+
+#include "TestUtil.h"
+#include <unity.h>
+
+#include <chrono>
+#include <memory>
+
+#define HISTORY_SIZE 64
+#define FLOOD_PACKETS 10000
+
+namespace
+{
+// The previous implementation: a full scan to find, and another full scan for a free or the oldest slot on insert.
+// Kept here as the baseline for the benchmark.
+class ScanHistory
+{
+    struct Record {
+        NodeNum sender;
+        PacketId id;
+        uint32_t rxTimeMsec;
+        uint32_t pad;
+    };
+    std::vector<Record> records;
+
+  public:
+    explicit ScanHistory(size_t size) : records(size, Record{0, 0, 0, 0}) {}
+
+    bool wasSeenRecently(NodeNum sender, PacketId id, uint32_t now)
+    {
+        Record *found = NULL;
+        for (auto &r : records)
+            if (r.id == id && r.sender == sender) {
+                found = &r;
+                break;
+            }
+
+        Record *tu = NULL;
+        uint32_t oldest = 0;
+        for (auto &r : records) {
+            if (r.id == 0 && r.sender == 0) {
+                tu = &r;
+                break;
+            } else if (r.id == id && r.sender == sender) {
+                tu = &r;
+                break;
+            } else if (now - r.rxTimeMsec > oldest || tu == NULL) {
+                oldest = now - r.rxTimeMsec;
+                tu = &r;
+            }
+        }
+        *tu = Record{sender, id, now, 0};
+        return found != NULL;
+    }
+};
+
+meshtastic_MeshPacket makePacket(NodeNum from, PacketId id)
+{
+    meshtastic_MeshPacket p = meshtastic_MeshPacket_init_zero;
+    p.from = from;
+    p.id = id;
+    p.relay_node = from & 0xff;
+    return p;
+}
+} // namespace
+
+void setUp(void)
+{
+    // set stuff up here
+}
+
+void tearDown(void)
+{
+    // clean stuff up here
+}
+
+void test_seen_after_insert(void)
+{
+    PacketHistory history(HISTORY_SIZE);
+    TEST_ASSERT_TRUE(history.initOk());
+
+    meshtastic_MeshPacket p = makePacket(0x11223344, 1);
+    TEST_ASSERT_FALSE(history.wasSeenRecently(&p));
+    TEST_ASSERT_TRUE(history.wasSeenRecently(&p));
+
+    // Same id from another sender is a different packet
+    meshtastic_MeshPacket q = makePacket(0x55667788, 1);
+    TEST_ASSERT_FALSE(history.wasSeenRecently(&q, false));
+    TEST_ASSERT_FALSE(history.wasSeenRecently(&q));
+    TEST_ASSERT_TRUE(history.wasSeenRecently(&q));
+}
+
+void test_relayers(void)
+{
+    PacketHistory history(HISTORY_SIZE);
+    meshtastic_MeshPacket p = makePacket(0x11223344, 42);
+    history.wasSeenRecently(&p);
+
+    p.relay_node = 0x55;
+    history.wasSeenRecently(&p);
+    TEST_ASSERT_TRUE(history.wasRelayer(0x44, 42, 0x11223344));
+    TEST_ASSERT_TRUE(history.wasRelayer(0x55, 42, 0x11223344));
+    TEST_ASSERT_FALSE(history.wasRelayer(0x66, 42, 0x11223344));
+
+    history.removeRelayer(0x44, 42, 0x11223344);
+    TEST_ASSERT_FALSE(history.wasRelayer(0x44, 42, 0x11223344));
+    TEST_ASSERT_TRUE(history.wasRelayer(0x55, 42, 0x11223344));
+}
+
+// A flood of distinct packets must keep exactly the most recent HISTORY_SIZE of them
+void test_flood_evicts_oldest(void)
+{
+    PacketHistory history(HISTORY_SIZE);
+    for (uint32_t i = 1; i <= FLOOD_PACKETS; i++) {
+        meshtastic_MeshPacket p = makePacket(0x10000000 + (i % 97), i);
+        TEST_ASSERT_FALSE(history.wasSeenRecently(&p));
+    }
+
+    for (uint32_t i = FLOOD_PACKETS; i > 0; i--) {
+        meshtastic_MeshPacket p = makePacket(0x10000000 + (i % 97), i);
+        TEST_ASSERT_EQUAL(i > FLOOD_PACKETS - HISTORY_SIZE, history.wasSeenRecently(&p, false));
+    }
+}
+
+// Seeing a packet again refreshes it, so it outlives packets that were inserted after it
+void test_refresh_moves_to_newest(void)
+{
+    PacketHistory history(HISTORY_SIZE);
+    meshtastic_MeshPacket keep = makePacket(0x0badcafe, 7);
+    history.wasSeenRecently(&keep);
+
+    for (uint32_t i = 1; i <= HISTORY_SIZE * 4; i++) {
+        meshtastic_MeshPacket p = makePacket(0x20000000, 1000 + i);
+        history.wasSeenRecently(&p);
+        if (i % (HISTORY_SIZE / 2) == 0)
+            TEST_ASSERT_TRUE(history.wasSeenRecently(&keep));
+    }
+    TEST_ASSERT_TRUE(history.wasSeenRecently(&keep, false));
+}
+
+// Not a pass/fail test: prints the cost per packet of the hashed history vs. the old scan under a flood
+void test_flood_benchmark(void)
+{
+    char msg[128];
+    // 0 picks the default capacity, size the baseline the same way
+    PacketHistory history(0);
+    ScanHistory scan(std::max<uint32_t>(MAX_NUM_NODES * 2, 100));
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 1; i <= FLOOD_PACKETS; i++)
+        scan.wasSeenRecently(0x10000000 + (i % 251), i, i);
+    auto mid = std::chrono::steady_clock::now();
+    for (uint32_t i = 1; i <= FLOOD_PACKETS; i++) {
+        meshtastic_MeshPacket p = makePacket(0x10000000 + (i % 251), i);
+        history.wasSeenRecently(&p);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    snprintf(msg, sizeof(msg), "%d packets: scan=%.0fns/packet hashed=%.0fns/packet", FLOOD_PACKETS,
+             std::chrono::duration<double, std::nano>(mid - start).count() / FLOOD_PACKETS,
+             std::chrono::duration<double, std::nano>(end - mid).count() / FLOOD_PACKETS);
+    TEST_MESSAGE(msg);
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    const std::unique_ptr<NodeDB> testNodeDB(new NodeDB());
+    nodeDB = testNodeDB.get();
+
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_seen_after_insert);
+    RUN_TEST(test_relayers);
+    RUN_TEST(test_flood_evicts_oldest);
+    RUN_TEST(test_refresh_moves_to_newest);
+    RUN_TEST(test_flood_benchmark);
+    exit(UNITY_END()); // stop unit testing
+}
+
+void loop() {}
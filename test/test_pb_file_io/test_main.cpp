@@ -0,0 +1,256 @@
+#include "DebugConfiguration.h"
+#include "TestUtil.h"
+#include <unity.h>
+
+#ifdef ARCH_PORTDUINO
+#include "FSCommon.h"
+#include "SPILock.h"
+#include "SafeFile.h"
+#include "mesh/PbFileStream.h"
+#include "mesh/mesh-pb-constants.h"
+
+#include <ErriezCRC32.h>
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+const char *testFileName = "/test/nodes.proto";
+
+// Something like what a node that has been on the mesh for a while knows about another node
+meshtastic_NodeInfoLite makeNode(size_t i)
+{
+    meshtastic_NodeInfoLite node = meshtastic_NodeInfoLite_init_zero;
+    node.num = 0x10000000 + i * 7919;
+    node.has_user = true;
+    snprintf(node.user.long_name, sizeof(node.user.long_name), "Meshtastic %04x", (unsigned)(node.num & 0xffff));
+    snprintf(node.user.short_name, sizeof(node.user.short_name), "%04x", (unsigned)(node.num & 0xffff));
+    node.user.hw_model = meshtastic_HardwareModel_HELTEC_V3;
+    node.user.public_key.size = 32;
+    memset(node.user.public_key.bytes, (int)i, 32);
+    node.has_position = true;
+    node.position.latitude_i = 523000000 + i * 1000;
+    node.position.longitude_i = 49000000 + i * 1000;
+    node.position.time = 1700000000 + i;
+    node.has_device_metrics = true;
+    node.device_metrics.has_battery_level = true;
+    node.device_metrics.battery_level = 80;
+    node.snr = 6.5f;
+    node.last_heard = 1700000000 + i;
+    node.has_hops_away = true;
+    node.hops_away = i % 4;
+    return node;
+}
+
+void makeDatabase(meshtastic_NodeDatabase &db, size_t numNodes)
+{
+    db.version = 24;
+    db.nodes.clear();
+    for (size_t i = 0; i < numNodes; i++)
+        db.nodes.push_back(makeNode(i));
+}
+
+size_t maxSize(size_t numNodes)
+{
+    return 16 + numNodes * meshtastic_NodeInfoLite_size;
+}
+
+// Save like NodeDB::saveProto did before: every field written straight to the file
+bool saveUnbuffered(const meshtastic_NodeDatabase &db)
+{
+    SafeFile f(testFileName);
+    pb_ostream_t stream = {&writecb, static_cast<Print *>(&f), maxSize(db.nodes.size())};
+    bool okay = pb_encode(&stream, &meshtastic_NodeDatabase_msg, &db);
+    return f.close() && okay;
+}
+
+bool saveBuffered(const meshtastic_NodeDatabase &db, uint32_t *crc = nullptr)
+{
+    SafeFile f(testFileName);
+    PbFileWriter writer(f, maxSize(db.nodes.size()));
+    bool okay = pb_encode(&writer.stream, &meshtastic_NodeDatabase_msg, &db) && writer.flush();
+    if (crc)
+        *crc = writer.getCrc();
+    return f.close() && okay;
+}
+
+bool loadUnbuffered(meshtastic_NodeDatabase &db, size_t numNodes)
+{
+    concurrency::LockGuard g(spiLock);
+    db.nodes.clear();
+    auto f = FSCom.open(testFileName, FILE_O_READ);
+    pb_istream_t stream = {&readcb, &f, maxSize(numNodes)};
+    bool okay = pb_decode(&stream, &meshtastic_NodeDatabase_msg, &db);
+    f.close();
+    return okay;
+}
+
+bool loadBuffered(meshtastic_NodeDatabase &db, size_t numNodes, uint32_t *crc = nullptr)
+{
+    concurrency::LockGuard g(spiLock);
+    db.nodes.clear();
+    auto f = FSCom.open(testFileName, FILE_O_READ);
+    PbFileReader reader(f, maxSize(numNodes));
+    bool okay = pb_decode(&reader.stream, &meshtastic_NodeDatabase_msg, &db);
+    if (crc)
+        *crc = reader.getCrc();
+    f.close();
+    return okay;
+}
+
+uint32_t fileCrc()
+{
+    concurrency::LockGuard g(spiLock);
+    auto f = FSCom.open(testFileName, FILE_O_READ);
+    std::vector<uint8_t> buf(f.size());
+    buf.resize(f.read(buf.data(), buf.size()));
+    f.close();
+    return crc32Buffer(buf.data(), buf.size());
+}
+
+void assertSameNodes(const meshtastic_NodeDatabase &expected, const meshtastic_NodeDatabase &actual)
+{
+    TEST_ASSERT_EQUAL_UINT32(expected.version, actual.version);
+    TEST_ASSERT_EQUAL(expected.nodes.size(), actual.nodes.size());
+    for (size_t i = 0; i < expected.nodes.size(); i++) {
+        TEST_ASSERT_EQUAL_UINT32(expected.nodes[i].num, actual.nodes[i].num);
+        TEST_ASSERT_EQUAL_STRING(expected.nodes[i].user.long_name, actual.nodes[i].user.long_name);
+        TEST_ASSERT_EQUAL_MEMORY(expected.nodes[i].user.public_key.bytes, actual.nodes[i].user.public_key.bytes, 32);
+        TEST_ASSERT_EQUAL_INT32(expected.nodes[i].position.latitude_i, actual.nodes[i].position.latitude_i);
+        TEST_ASSERT_EQUAL_UINT32(expected.nodes[i].last_heard, actual.nodes[i].last_heard);
+    }
+}
+
+double msecsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+} // namespace
+
+void setUp(void)
+{
+    // set stuff up here
+}
+
+void tearDown(void)
+{
+    // clean stuff up here
+    FSCom.remove(testFileName);
+}
+
+// Files of many sizes, ending inside a block or right after one, come back as they were written
+void test_round_trip(void)
+{
+    meshtastic_NodeDatabase saved = {}, loaded = {};
+    for (size_t numNodes : {0, 1, 2, 17, 40, 41, 100}) {
+        makeDatabase(saved, numNodes);
+        TEST_ASSERT_TRUE(saveBuffered(saved));
+        TEST_ASSERT_TRUE(loadBuffered(loaded, numNodes));
+        assertSameNodes(saved, loaded);
+    }
+}
+
+// The file format doesn't change: files written either way read back either way
+void test_compatible_with_unbuffered(void)
+{
+    meshtastic_NodeDatabase saved = {}, loaded = {};
+    makeDatabase(saved, 60);
+
+    TEST_ASSERT_TRUE(saveUnbuffered(saved));
+    TEST_ASSERT_TRUE(loadBuffered(loaded, 60));
+    assertSameNodes(saved, loaded);
+
+    TEST_ASSERT_TRUE(saveBuffered(saved));
+    TEST_ASSERT_TRUE(loadUnbuffered(loaded, 60));
+    assertSameNodes(saved, loaded);
+}
+
+// The CRCs the writer and reader fold along the way are those of the file, and tell apart snapshots of the same size
+void test_crc_names_file(void)
+{
+    meshtastic_NodeDatabase saved = {}, loaded = {};
+    for (size_t numNodes : {0, 1, 40, 41, 100}) {
+        uint32_t savedCrc = 0, loadedCrc = 0;
+        makeDatabase(saved, numNodes);
+        TEST_ASSERT_TRUE(saveBuffered(saved, &savedCrc));
+        TEST_ASSERT_TRUE(loadBuffered(loaded, numNodes, &loadedCrc));
+        TEST_ASSERT_EQUAL_HEX32(fileCrc(), savedCrc);
+        TEST_ASSERT_EQUAL_HEX32(savedCrc, loadedCrc);
+    }
+
+    // A node renamed to a name of the same length: same encoded size, different snapshot
+    uint32_t before = 0, after = 0;
+    size_t sizeBefore = 0, sizeAfter = 0;
+    makeDatabase(saved, 40);
+    pb_get_encoded_size(&sizeBefore, meshtastic_NodeDatabase_fields, &saved);
+    TEST_ASSERT_TRUE(saveBuffered(saved, &before));
+    saved.nodes[17].user.long_name[0] = 'X';
+    pb_get_encoded_size(&sizeAfter, meshtastic_NodeDatabase_fields, &saved);
+    TEST_ASSERT_TRUE(saveBuffered(saved, &after));
+    TEST_ASSERT_EQUAL(sizeBefore, sizeAfter);
+    TEST_ASSERT_NOT_EQUAL(before, after);
+}
+
+// Not a pass/fail test: how long saving and loading a full node database takes
+void test_benchmark_full_nodedb(void)
+{
+    const size_t numNodes = MAX_NUM_NODES;
+    const int rounds = 10;
+    meshtastic_NodeDatabase saved = {}, loaded = {};
+    makeDatabase(saved, numNodes);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++)
+        TEST_ASSERT_TRUE(saveUnbuffered(saved));
+    double saveBefore = msecsSince(start) / rounds;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++)
+        TEST_ASSERT_TRUE(loadUnbuffered(loaded, numNodes));
+    double loadBefore = msecsSince(start) / rounds;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++)
+        TEST_ASSERT_TRUE(saveBuffered(saved));
+    double saveAfter = msecsSince(start) / rounds;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++)
+        TEST_ASSERT_TRUE(loadBuffered(loaded, numNodes));
+    double loadAfter = msecsSince(start) / rounds;
+    assertSameNodes(saved, loaded);
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "%u nodes: save %.2fms -> %.2fms, load %.2fms -> %.2fms (%d byte blocks)", (unsigned)numNodes,
+             saveBefore, saveAfter, loadBefore, loadAfter, PB_FILE_BLOCK_SIZE);
+    TEST_MESSAGE(msg);
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    initSPI();
+    FSCom.mkdir("/test");
+
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_compatible_with_unbuffered);
+    RUN_TEST(test_crc_names_file);
+    RUN_TEST(test_benchmark_full_nodedb);
+    exit(UNITY_END()); // stop unit testing
+}
+#else
+void setup()
+{
+    initializeTestEnvironment();
+    LOG_WARN("This test requires the ARCH_PORTDUINO file system");
+    UNITY_BEGIN();
+    UNITY_END();
+}
+#endif
+void loop() {}
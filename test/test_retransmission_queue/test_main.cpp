@@ -0,0 +1,184 @@
+#include "mesh/RetransmissionQueue.h"
+
+#include "TestUtil.h"
+#include <unity.h>
+
+#include <random>
+
+void setUp(void)
+{
+    // set stuff up here
+}
+
+void tearDown(void)
+{
+    // clean stuff up here
+}
+
+void test_due_in_deadline_order(void)
+{
+    RetransmissionQueue q;
+    PendingPacket a, b, c;
+    TEST_ASSERT_EQUAL(INT32_MAX, q.msecUntilNext(1000));
+
+    q.schedule(&a, 3000, 1000);
+    q.schedule(&b, 1000, 1000);
+    q.schedule(&c, 2000, 1000);
+    TEST_ASSERT_EQUAL(3, q.size());
+    TEST_ASSERT_EQUAL(1000, q.msecUntilNext(1000));
+    TEST_ASSERT_NULL(q.popDue(1999));
+
+    TEST_ASSERT_EQUAL_PTR(&b, q.popDue(5000));
+    TEST_ASSERT_EQUAL_PTR(&c, q.popDue(5000));
+    TEST_ASSERT_EQUAL_PTR(&a, q.popDue(5000));
+    TEST_ASSERT_NULL(q.popDue(5000));
+    TEST_ASSERT_EQUAL(PendingPacket::NOT_QUEUED, a.heapPos);
+}
+
+void test_reschedule_and_remove(void)
+{
+    RetransmissionQueue q;
+    PendingPacket a, b;
+    q.schedule(&a, 1000, 0);
+    q.schedule(&b, 2000, 0);
+    q.schedule(&a, 5000, 0); // moves behind b
+    TEST_ASSERT_EQUAL(2, q.size());
+    TEST_ASSERT_EQUAL(2000, q.msecUntilNext(0));
+
+    q.remove(&b);
+    q.remove(&b); // not queued any more, no-op
+    TEST_ASSERT_EQUAL(1, q.size());
+    TEST_ASSERT_NULL(q.popDue(4999));
+    TEST_ASSERT_EQUAL_PTR(&a, q.popDue(5000));
+}
+
+// millis() wraps after 49.7 days, deadlines on either side of the wrap must keep their order
+void test_millis_rollover(void)
+{
+    RetransmissionQueue q;
+    PendingPacket a, b, c;
+    uint32_t now = 0xFFFFF000;
+    q.schedule(&a, 0x2000, now); // due after the wrap, at 0x1000
+    q.schedule(&b, 0x0800, now); // due before the wrap
+    q.schedule(&c, 0x1800, now); // due after the wrap, at 0x800
+
+    TEST_ASSERT_EQUAL(0x800, q.msecUntilNext(now));
+    TEST_ASSERT_NULL(q.popDue(0xFFFFF7FF));
+    TEST_ASSERT_EQUAL_PTR(&b, q.popDue(0xFFFFF800));
+
+    // Right at the wrap nothing else is due, an unsigned compare would call both overdue here
+    TEST_ASSERT_NULL(q.popDue(0));
+    TEST_ASSERT_EQUAL(0x800, q.msecUntilNext(0));
+    TEST_ASSERT_EQUAL_PTR(&c, q.popDue(0x800));
+    TEST_ASSERT_NULL(q.popDue(0xFFF));
+    TEST_ASSERT_EQUAL_PTR(&a, q.popDue(0x1000));
+}
+
+void test_delay_all(void)
+{
+    RetransmissionQueue q;
+    PendingPacket a, b, c;
+    q.schedule(&a, 1000, 0);
+    q.schedule(&b, 2000, 0);
+    q.schedule(&c, 3000, 0);
+
+    // Airtime of a packet we sent for c: everyone else waits longer, c itself does not
+    q.delayAll(2500, &c);
+    TEST_ASSERT_NULL(q.popDue(2999));
+    TEST_ASSERT_EQUAL_PTR(&c, q.popDue(3000));
+    TEST_ASSERT_NULL(q.popDue(3499));
+    TEST_ASSERT_EQUAL_PTR(&a, q.popDue(3500));
+
+    // A record scheduled after a delay is not affected by it
+    q.schedule(&a, 1000, 4000);
+    q.delayAll(100);
+    TEST_ASSERT_EQUAL(600, q.msecUntilNext(4000)); // b at 4600
+    TEST_ASSERT_EQUAL_PTR(&b, q.popDue(4600));
+    TEST_ASSERT_EQUAL_PTR(&a, q.popDue(5100));
+}
+
+// Random operations across the wrap, compared against absolute deadlines in 64 bit time
+void test_matches_reference(void)
+{
+    std::mt19937 rng(11);
+    const size_t N = 64;
+    PendingPacket recs[N];
+    uint64_t deadline[N];
+    bool queued[N] = {};
+    uint64_t now = 0xFFFFFFFFull - 500000;
+    RetransmissionQueue q;
+
+    for (int step = 0; step < 50000; step++) {
+        size_t i = rng() % N;
+        switch (rng() % 4) {
+        case 0: {
+            uint32_t d = rng() % 20000;
+            q.schedule(&recs[i], d, (uint32_t)now);
+            deadline[i] = now + d;
+            queued[i] = true;
+            break;
+        }
+        case 1:
+            q.remove(&recs[i]);
+            queued[i] = false;
+            break;
+        case 2: {
+            uint32_t d = rng() % 500;
+            PendingPacket *except = rng() % 2 ? &recs[i] : NULL;
+            q.delayAll(d, except);
+            for (size_t j = 0; j < N; j++)
+                if (queued[j] && &recs[j] != except)
+                    deadline[j] += d;
+            break;
+        }
+        default:
+            now += rng() % 300;
+            break;
+        }
+
+        uint64_t earliest = UINT64_MAX;
+        size_t n = 0;
+        for (size_t j = 0; j < N; j++) {
+            if (queued[j]) {
+                n++;
+                if (deadline[j] < earliest)
+                    earliest = deadline[j];
+            }
+        }
+        TEST_ASSERT_EQUAL(n, q.size());
+        if (!n) {
+            TEST_ASSERT_EQUAL(INT32_MAX, q.msecUntilNext((uint32_t)now));
+            continue;
+        }
+        TEST_ASSERT_EQUAL(earliest > now ? earliest - now : 0, q.msecUntilNext((uint32_t)now));
+
+        while (PendingPacket *p = q.popDue((uint32_t)now)) {
+            size_t j = p - recs;
+            TEST_ASSERT_TRUE(queued[j]);
+            TEST_ASSERT_TRUE(deadline[j] <= now);
+            queued[j] = false;
+        }
+        for (size_t j = 0; j < N; j++)
+            TEST_ASSERT_FALSE(queued[j] && deadline[j] <= now);
+    }
+    TEST_ASSERT_TRUE(now > 0xFFFFFFFFull); // we did cross the wrap
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_due_in_deadline_order);
+    RUN_TEST(test_reschedule_and_remove);
+    RUN_TEST(test_millis_rollover);
+    RUN_TEST(test_delay_all);
+    RUN_TEST(test_matches_reference);
+    exit(UNITY_END()); // stop unit testing
+}
+
+void loop() {}